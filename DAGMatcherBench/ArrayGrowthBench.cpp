@@ -0,0 +1,95 @@
+/* ************* Begin file ArrayGrowthBench.cpp ***************************************/
+/*
+** 2015 October 10
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file ArrayGrowthBench.cpp
+*	\brief Benchmark of the growth of SmartArray.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+#include "SmartArray.h"
+#include "SGNode.h"
+#include "BaselineSmartArray.h"
+#include "Benchmarks.h"
+
+using namespace dml;
+
+static void Reserve(SmartArray<ShockInfo>& a, int n) { a.Reserve(n); }
+
+//! baseline::SmartArray has no Reserve()
+static void Reserve(baseline::SmartArray<ShockInfo>& /*a*/, int /*n*/) { }
+
+//! Appends 'n' points to an empty array, as the branches of a shock graph are built
+template <class ARRAY> static double AppendPoints(int n, bool bReserve)
+{
+	ARRAY a;
+	ShockInfo pt;
+
+	if (bReserve)
+		Reserve(a, n);
+
+	for (int i = 0; i < n; i++)
+	{
+		pt.xcoord = i;
+		a.AddTail(pt);
+	}
+
+	// Read the array back, so that the appends can't be optimized away
+	const ARRAY& ca = a;
+	double dSum = 0;
+
+	for (int i = 0; i < ca.GetSize(); i++)
+		dSum += ca[i].xcoord;
+
+	return dSum;
+}
+
+/*!
+	\brief Times the appending of 16, 32, ... nMaxSize shock points to an
+	array with the SmartArray::AddTail() of the previous revision, which
+	grew the array one slot at a time, with the current one, which grows it
+	geometrically, and with the current one after Reserve().
+*/
+void BenchmarkArrayGrowth(int nMaxSize, int nTrials, std::ostream& os)
+{
+	os << "points\tbaseline (ms)\tgeometric (ms)\treserved (ms)\tspeedup\tmax diff" << std::endl;
+
+	for (int n = 16; n <= nMaxSize; n *= 2)
+	{
+		double dOldTime = 0, dGeomTime = 0, dResTime = 0, dMaxDiff = 0;
+
+		for (int t = 0; t < nTrials; t++)
+		{
+			WallClock clock;
+
+			double s0 = AppendPoints< baseline::SmartArray<ShockInfo> >(n, false);
+			dOldTime += clock.Lap();
+
+			double s1 = AppendPoints< SmartArray<ShockInfo> >(n, false);
+			dGeomTime += clock.Lap();
+
+			double s2 = AppendPoints< SmartArray<ShockInfo> >(n, true);
+			dResTime += clock.Lap();
+
+			dMaxDiff = MAX(dMaxDiff, MAX(fabs(s1 - s0), fabs(s2 - s0)));
+		}
+
+		dOldTime /= nTrials;
+		dGeomTime /= nTrials;
+		dResTime /= nTrials;
+
+		os << n << "\t" << dOldTime << "\t" << dGeomTime << "\t" << dResTime << "\t"
+			<< (dGeomTime > 0 ? dOldTime / dGeomTime : 0) << "\t" << dMaxDiff << std::endl;
+	}
+}
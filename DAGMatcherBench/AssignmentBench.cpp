@@ -0,0 +1,126 @@
+/* ************* Begin file AssignmentBench.cpp ***************************************/
+/*
+** 2015 October 10
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file AssignmentBench.cpp
+*	\brief Benchmark of the bipartite assignment solvers.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+
+#ifndef DML_NO_LEDA
+#ifdef USE_TEMPLATE_BASED_MWBM_FUNCTION
+#include <LEDA/graph/templates/mwb_matching.h>
+using namespace std; // Fixes an error in the next LEDA header scale_weights.h line 35
+#include <LEDA/graph/scale_weights.h>
+#else
+#include <LEDA/graph/mwb_matching.h>
+#endif
+#endif //DML_NO_LEDA
+
+#include "AssignmentSolver.h"
+#include "Benchmarks.h"
+
+using namespace dml;
+
+//! Labels the rows and columns with the indices of their nodes
+static void SetNodeLabels(AssignmentSolver& solver, const leda::list<leda::node>& A,
+	const leda::list<leda::node>& B)
+{
+	leda::node v;
+	int i = 0;
+
+	forall(v, A)
+		solver.SetRowLabel(i++, index(v));
+
+	i = 0;
+
+	forall(v, B)
+		solver.SetColLabel(i++, index(v));
+}
+
+/*!
+	\brief Times the assignment of n x n complete bipartite graphs with random
+	weights, for n = 4, 8, ... nMaxSize, with MAX_WEIGHT_BIPARTITE_MATCHING,
+	which the matchers called before, with the dense solver, and with the
+	dense solver warm started from a sibling problem (the same graph with a
+	tenth of the weights lowered, as the penalties of DAGMatcherOptimal do).
+*/
+void BenchmarkAssignment(int nMaxSize, int nTrials, std::ostream& os)
+{
+	os << "nodes\tmwbm (ms)\tdense (ms)\twarm (ms)\tspeedup\tmax diff" << std::endl;
+
+	AssignmentSolver solver;
+
+	for (int n = 4; n <= nMaxSize; n *= 2)
+	{
+		double dGraphTime = 0, dDenseTime = 0, dWarmTime = 0, dMaxDiff = 0;
+
+		for (int t = 0; t < nTrials; t++)
+		{
+			leda::graph G;
+			leda::list<leda::node> A, B;
+			leda::node u, v;
+			leda::edge e;
+			int i;
+
+			for (i = 0; i < n; i++)
+				A.append(G.new_node());
+
+			for (i = 0; i < n; i++)
+				B.append(G.new_node());
+
+			forall(u, A)
+				forall(v, B)
+					G.new_edge(u, v);
+
+			leda::edge_array<double> w(G), w2(G);
+
+			forall_edges(e, G)
+			{
+				w[e] = 1 + rand() % 1000;
+				w2[e] = (rand() % 10 == 0) ? w[e] / 2 : w[e];
+			}
+
+			WallClock clock;
+
+			leda::list<leda::edge> L = MAX_WEIGHT_BIPARTITE_MATCHING(G, w);
+			dGraphTime += clock.Lap();
+
+			solver.Init(G, A, B, w);
+			SetNodeLabels(solver, A, B);
+			double s1 = solver.Solve(false);
+			dDenseTime += clock.Lap();
+
+			solver.Init(G, A, B, w2);
+			SetNodeLabels(solver, A, B);
+			solver.Solve(true);
+			dWarmTime += clock.Lap();
+
+			double s0 = 0;
+
+			forall(e, L)
+				s0 += w[e];
+
+			dMaxDiff = MAX(dMaxDiff, fabs(s1 - s0));
+		}
+
+		dGraphTime /= nTrials;
+		dDenseTime /= nTrials;
+		dWarmTime /= nTrials;
+
+		os << n << "\t" << dGraphTime << "\t" << dDenseTime << "\t" << dWarmTime << "\t"
+			<< (dDenseTime > 0 ? dGraphTime / dDenseTime : 0) << "\t" << dMaxDiff << std::endl;
+	}
+}
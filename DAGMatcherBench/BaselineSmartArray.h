@@ -0,0 +1,182 @@
+/* ************* Begin file BaselineSmartArray.h ***************************************/
+/*
+** 2015 October 10
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file BaselineSmartArray.h
+*	\brief SmartArray as it was before it grew geometrically.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*
+*	The growth path of SmartArray (constructors, AddTail, Resize and Unlink),
+*	copied unchanged from the revision before AddTail() grew the array
+*	geometrically, so that BenchmarkArrayGrowth() times the real old code.
+*	The functions that AddTail() does not call were left out, and Resize()
+*	value-initializes the elements instead of clearing them with memset().
+*/
+
+#ifndef _BASELINE_SMART_ARRAY_H_
+#define _BASELINE_SMART_ARRAY_H_
+
+#include "stdafx.h"
+
+namespace baseline {
+
+template<class T> class SmartArray
+{
+	struct DATAREF {
+		T* pData;
+		int nLastItem;
+		int nSize;
+		int nRealSize;
+		int nGrowFactor;
+		dml::RefCount links;
+
+		DATAREF(int nGF)  { nGrowFactor = nGF; ASSERT(nGF > 0); }
+	};
+
+	DATAREF* ptr;
+
+private:
+	void Unlink();
+
+	//! Drops a reference to 'p' and destroys it if it was the last one
+	static void Release(DATAREF* p)
+	{
+		if (p->links.Release())
+		{
+			delete[] p->pData;
+			delete p;
+		}
+	}
+
+public:
+
+	SmartArray(int nSize = 0, int nGrowFactor = 1) {
+		ptr = new DATAREF(nGrowFactor);
+		ptr->pData = (nSize > 0) ? new T[nSize]:NULL;
+		ptr->nLastItem = 0;
+		ptr->nSize = nSize;
+		ptr->nRealSize = nSize;
+		ASSERT(ptr->nSize == 0 || ptr->pData != NULL);
+	}
+
+	SmartArray(const SmartArray& x)	{
+		ptr = x.ptr;
+		ptr->links.AddRef();
+	}
+
+	~SmartArray() {
+		Release(ptr);
+	}
+
+	const T& operator[](int i) const {
+		ASSERT(i >= 0 && i < ptr->nSize);
+		return ptr->pData[i];
+	}
+
+	int GetSize() const  { return ptr->nSize; }
+
+	//! Adds an element after the last element without increasing
+	//! the size of the array.
+	void Add(const T& x) {
+		ASSERT(ptr->nLastItem < ptr->nSize);
+
+		if (ptr->links.IsShared())
+			Unlink();
+
+		ptr->pData[ptr->nLastItem++] = x;
+	}
+
+	//! Adds an element after the last element. It increases
+	//! the size of the array if necessary.
+	void AddTail(const T& x)
+	{
+		if (ptr->nLastItem >= ptr->nSize)
+		{
+			if (ptr->nLastItem < ptr->nRealSize)
+			{
+				if (ptr->links.IsShared())
+					Unlink();
+
+				ptr->nSize++;
+			}
+			else
+			{
+				ASSERT(ptr->nSize == ptr->nRealSize);
+
+				const SmartArray<T> a(*this);
+
+				Resize(ptr->nRealSize + ptr->nGrowFactor);
+				//memcpy(ptr->pData, a.GetData(), a.GetSize() * sizeof(T));
+
+				for (int i = 0; i < a.GetSize(); i++)
+					ptr->pData[i] = a.ptr->pData[i];
+
+				ptr->nSize = a.GetSize() + 1;
+				ptr->nLastItem = a.GetSize();
+			}
+		}
+
+		Add(x);
+	}
+
+	void Resize(int size, bool bInit = false)
+	{
+		ASSERT(size >= 0);
+
+		if (size != ptr->nSize || ptr->links.IsShared())
+		{
+			if (ptr->links.IsShared())
+			{
+				DATAREF* op = ptr;
+
+				ptr = new DATAREF(op->nGrowFactor);
+				Release(op);
+			}
+			else if (ptr->pData)
+				delete[] ptr->pData;
+
+			ptr->pData = (size > 0) ? new T[size]:NULL;
+			ptr->nSize = size;
+			ptr->nRealSize = size;
+			ASSERT((size > 0 && ptr->pData != NULL) || size == 0);
+		}
+
+		ptr->nLastItem = 0;
+
+		// Value-initialized rather than memset, since T needn't be trivial
+		if (bInit)
+			for (int i = 0; i < size; i++)
+				ptr->pData[i] = T();
+	}
+};
+
+template<class T> void SmartArray<T>::Unlink()
+{
+	DATAREF* op = ptr;
+	ptr = new DATAREF(op->nGrowFactor);
+
+	ptr->pData = new T[op->nSize];
+	ptr->nLastItem = op->nLastItem;
+	ptr->nSize = op->nSize;
+	ptr->nRealSize = op->nSize;
+
+	//memcpy(ptr->pData, op->pData, op->nSize * sizeof(T));
+	for (int i = 0; i < op->nSize; i++)
+		ptr->pData[i] = op->pData[i];
+
+	Release(op);
+}
+
+} // namespace baseline
+
+#endif //_BASELINE_SMART_ARRAY_H_
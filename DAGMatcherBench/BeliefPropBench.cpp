@@ -0,0 +1,87 @@
+/* ************* Begin file BeliefPropBench.cpp ***************************************/
+/*
+** 2015 October 10
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file BeliefPropBench.cpp
+*	\brief Benchmark of the belief propagation assignment solver.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+#include "AssignmentSolver.h"
+#include "BeliefPropMWBGM.h"
+#include "Benchmarks.h"
+
+using namespace dml;
+
+/*!
+	\brief Times the assignment of n x n complete bipartite graphs with random
+	weights, for n = 4, 8, ... nMaxSize, with AssignmentSolver and with belief
+	propagation on one thread and on one thread per core, and reports how
+	far the belief propagation is from the optimum.
+
+	The times are wall-clock times, so the multithreaded column shows the
+	time the caller waits for, not the CPU time of all the threads.
+*/
+void BenchmarkBeliefProp(int nMaxSize, int nTrials, std::ostream& os)
+{
+	os << "nodes\texact (ms)\tbp (ms)\tbp mt (ms)\titers\tconverged\tmin ratio" << std::endl;
+
+	AssignmentSolver exact;
+	BeliefPropSolver bp;
+
+	for (int n = 4; n <= nMaxSize; n *= 2)
+	{
+		double dExactTime = 0, dBPTime = 0, dMTTime = 0, dMinRatio = 1, dIters = 0;
+		int nConverged = 0;
+
+		for (int t = 0; t < nTrials; t++)
+		{
+			int i, j;
+
+			exact.Init(n, n);
+			bp.Init(n, n);
+
+			for (i = 0; i < n; i++)
+			{
+				for (j = 0; j < n; j++)
+				{
+					double w = 1 + rand() % 1000;
+
+					exact.SetProfit(i, j, w);
+					bp.SetProfit(i, j, w);
+				}
+			}
+
+			WallClock clock;
+
+			double s0 = exact.Solve(false);
+			dExactTime += clock.Lap();
+
+			bp.SetThreadCount(1);
+			double s1 = bp.Solve();
+			dBPTime += clock.Lap();
+
+			bp.SetThreadCount(-1);
+			bp.Solve();
+			dMTTime += clock.Lap();
+
+			dIters += bp.GetIterationCount();
+			nConverged += bp.HasConverged() ? 1 : 0;
+			dMinRatio = MIN(dMinRatio, (s0 > 0) ? s1 / s0 : 1);
+		}
+
+		os << n << "\t" << dExactTime / nTrials << "\t" << dBPTime / nTrials << "\t" << dMTTime / nTrials << "\t"
+			<< dIters / nTrials << "\t" << nConverged << "/" << nTrials << "\t" << dMinRatio << std::endl;
+	}
+}
@@ -0,0 +1,64 @@
+/* ************* Begin file Benchmarks.h ***************************************/
+/*
+** 2015 October 10
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file Benchmarks.h
+*	\brief Benchmarks of the DAGMatcherLib solvers, run by DAGMatcherBench.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*
+*	Every benchmark times the current code against the code it replaced, or
+*	against the exact solver it approximates, on random inputs of growing
+*	size. It prints one row per size: the mean wall-clock time of each variant
+*	in milliseconds, the speedup, and how far the results of the variants are
+*	from each other.
+*/
+
+#ifndef _BENCHMARKS_H_
+#define _BENCHMARKS_H_
+
+#include <iostream>
+#include <boost/chrono.hpp>
+
+/*!
+	\brief Wall-clock stopwatch. Unlike clock(), it counts the time spent by
+	all the threads of a parallel solver only once.
+*/
+class WallClock
+{
+	boost::chrono::steady_clock::time_point m_last;
+
+public:
+	WallClock() : m_last(boost::chrono::steady_clock::now()) { }
+
+	//! Milliseconds since the construction or the previous call
+	double Lap()
+	{
+		boost::chrono::steady_clock::time_point now = boost::chrono::steady_clock::now();
+		double ms = boost::chrono::duration<double, boost::milli>(now - m_last).count();
+
+		m_last = now;
+		return ms;
+	}
+};
+
+//! Signature of the benchmarks: sizes up to nMaxSize, nTrials random inputs per size
+typedef void (*BENCHMARK_FUNC)(int nMaxSize, int nTrials, std::ostream& os);
+
+void BenchmarkArrayGrowth(int nMaxSize, int nTrials, std::ostream& os);
+void BenchmarkEigenSum(int nMaxSize, int nTrials, std::ostream& os);
+void BenchmarkModelFit(int nMaxSize, int nTrials, std::ostream& os);
+void BenchmarkAssignment(int nMaxSize, int nTrials, std::ostream& os);
+void BenchmarkBeliefProp(int nMaxSize, int nTrials, std::ostream& os);
+void BenchmarkTSVBound(int nMaxSize, int nTrials, std::ostream& os);
+
+#endif //_BENCHMARKS_H_
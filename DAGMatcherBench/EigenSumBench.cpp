@@ -0,0 +1,81 @@
+/* ************* Begin file EigenSumBench.cpp ***************************************/
+/*
+** 2015 October 10
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file EigenSumBench.cpp
+*	\brief Benchmark of the TSV eigen-sum solvers of DAG.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+#include "DAG.h"
+#include "Benchmarks.h"
+
+using namespace dml;
+
+/*!
+	\brief Times both TSV solvers on random weighted trees of 2, 4, ... nMaxSize nodes:
+	the full SVD that DAG::ComputeEigenSum() used to run, and the eigenvalues
+	of adj' * adj that it runs now.
+*/
+void BenchmarkEigenSum(int nMaxSize, int nTrials, std::ostream& os)
+{
+	using namespace NEWMAT;
+
+	os << "nodes\tsvd (ms)\teigen (ms)\tspeedup\tmax rel. diff" << std::endl;
+
+	for (int n = 2; n <= nMaxSize; n *= 2)
+	{
+		double dSVDTime = 0, dEigTime = 0, dMaxDiff = 0;
+
+		for (int t = 0; t < nTrials; t++)
+		{
+			// Random tree: the parent of node i is a random node before it
+			Matrix adj(n, n);
+			adj = 0.0;
+
+			for (int i = 2; i <= n; i++)
+			{
+				int p = 1 + rand() % (i - 1);
+				double w = 1.0 + rand() % 100;
+
+				adj(p, i) = w;
+				adj(i, p) = -w;
+			}
+
+			// The root sums as many values as it has children
+			int nVals = 0;
+
+			for (int i = 2; i <= n; i++)
+				if (adj(1, i) != 0)
+					nVals++;
+
+			WallClock clock;
+
+			double s0 = DAG::ComputeEigenSumSVD(adj, nVals);
+			dSVDTime += clock.Lap();
+
+			double s1 = DAG::ComputeEigenSumSymmetric(adj, nVals);
+			dEigTime += clock.Lap();
+
+			if (s0 != 0)
+				dMaxDiff = MAX(dMaxDiff, fabs(s1 - s0) / s0);
+		}
+
+		dSVDTime /= nTrials;
+		dEigTime /= nTrials;
+
+		os << n << "\t" << dSVDTime << "\t" << dEigTime << "\t"
+			<< (dEigTime > 0 ? dSVDTime / dEigTime : 0) << "\t" << dMaxDiff << std::endl;
+	}
+}
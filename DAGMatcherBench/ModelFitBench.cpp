@@ -0,0 +1,106 @@
+/* ************* Begin file ModelFitBench.cpp ***************************************/
+/*
+** 2015 October 10
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file ModelFitBench.cpp
+*	\brief Benchmark of PolyLineApprox and ModelFit with and without prefix sums.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+#include "Benchmarks.h"
+
+using namespace dml;
+
+//! Velocity/radius points of a synthetic shock branch: a smooth radius with some noise
+static POINTS RandomBranch(int n)
+{
+	POINTS pts(n);
+	double x = 0, phase = rand() % 100;
+
+	for (int i = 0; i < n; i++)
+	{
+		x += 0.5 + (rand() % 100) / 100.0;
+		pts[i].Set(x, 20 + 8 * sin((x + phase) / 25) + (rand() % 100) / 100.0);
+	}
+
+	return pts;
+}
+
+/*!
+	@brief Prints the time taken to approximate synthetic shock branches of
+	16, 32, ... nMaxPoints points with a PolyLineApprox (as GroupShockPoints
+	does) and to fit the resulting model to another branch with a ModelFit,
+	each one with the original segment errors (UsePrefixSums(false)) and with
+	prefix sums.
+
+	The last column is the largest difference between the errors found with
+	and without prefix sums, which must be at the level of rounding errors.
+*/
+void BenchmarkModelFit(int nMaxPoints, int nTrials, std::ostream& os)
+{
+	os << "points\tpolyline (ms)\tprefix (ms)\tspeedup\tmodel fit (ms)\tprefix (ms)\tspeedup\tmax diff" << std::endl;
+
+	for (int n = 16; n <= nMaxPoints; n *= 2)
+	{
+		double dPolyTime = 0, dPolySumsTime = 0, dFitTime = 0, dFitSumsTime = 0, dMaxDiff = 0;
+
+		for (int t = 0; t < nTrials; t++)
+		{
+			POINTS data = RandomBranch(n);
+			POINTS data2 = RandomBranch(n);
+			LineSegmentArray segs;
+			int i;
+
+			// Same parameters as a shock graph with a min error of 2
+			PolyLineApprox poly(n / 2.0, 0.05, 10, 0.1);
+			PolyLineApprox polySums(n / 2.0, 0.05, 10, 0.1);
+
+			poly.UsePrefixSums(false);
+
+			WallClock clock;
+
+			poly.Fit(data);
+			dPolyTime += clock.Lap();
+
+			polySums.Fit(data);
+			dPolySumsTime += clock.Lap();
+
+			for (i = 0; i < polySums.m_knots.GetSize(); i++)
+				segs.AddTail(polySums.m_knots[i].seg);
+
+			ModelFit fit(2), fitSums(2);
+
+			fit.UsePrefixSums(false);
+
+			clock.Lap();
+
+			double e = fit.Fit(data2, segs);
+			dFitTime += clock.Lap();
+
+			double eSums = fitSums.Fit(data2, segs);
+			dFitSumsTime += clock.Lap();
+
+			for (i = 0; i < poly.m_knots.GetSize() && i < polySums.m_knots.GetSize(); i++)
+				dMaxDiff = MAX(dMaxDiff, fabs(poly.m_knots[i].dError - polySums.m_knots[i].dError));
+
+			if (e < INFINITY && eSums < INFINITY)
+				dMaxDiff = MAX(dMaxDiff, fabs(e - eSums));
+		}
+
+		os << n << "\t" << dPolyTime / nTrials << "\t" << dPolySumsTime / nTrials << "\t"
+			<< (dPolySumsTime > 0 ? dPolyTime / dPolySumsTime : 0) << "\t"
+			<< dFitTime / nTrials << "\t" << dFitSumsTime / nTrials << "\t"
+			<< (dFitSumsTime > 0 ? dFitTime / dFitSumsTime : 0) << "\t" << dMaxDiff << std::endl;
+	}
+}
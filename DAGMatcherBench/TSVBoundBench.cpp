@@ -0,0 +1,106 @@
+/* ************* Begin file TSVBoundBench.cpp ***************************************/
+/*
+** 2015 October 10
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file TSVBoundBench.cpp
+*	\brief Benchmark and check of the TSV bound of MatchBoundCascade.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+#include "DAGNode.h"
+#include "DAGMatcher.h"
+#include "MatchBounds.h"
+#include "Benchmarks.h"
+
+using namespace dml;
+
+//! A DAGNode without a graph, enough for its TSV and TSV norm
+class BenchNode : public DAGNode
+{
+public:
+	virtual DAGNode* CreateObject() const { return new BenchNode; }
+};
+
+//! Sets random children TSV values in [0, 1) and eigen label in [0.5, 1.5)
+static void RandomTSV(BenchNode& node, int nChildren)
+{
+	TSV tsv(nChildren);
+
+	for (int i = 0; i < nChildren; i++)
+		tsv[i] = rand() / (RAND_MAX + 1.0);
+
+	node.SetChildrenTSV(tsv);
+	node.SetEigenLbl(0.5 + rand() / (RAND_MAX + 1.0));
+}
+
+/*!
+	\brief Times the TSV similarity of random pairs of nodes with 2, 4, ...
+	nMaxSize children against the bound of it that the TSV_BOUND stage of
+	MatchBoundCascade computes. Every other pair has the same children TSV
+	and different eigen labels: its similarity is one, while the ratio of
+	the TSV norms, which the stage used before, is below one. The last
+	column counts the pairs whose bound is below their similarity, and must
+	be zero.
+*/
+void BenchmarkTSVBound(int nMaxSize, int nTrials, std::ostream& os)
+{
+	os << "children\tsimilarity (ms)\tbound (ms)\tspeedup\tviolations" << std::endl;
+
+	for (int n = 2; n <= nMaxSize; n *= 2)
+	{
+		std::vector<BenchNode> a(nTrials), b(nTrials);
+		std::vector<double> normsA(nTrials), normsB(nTrials), sims(nTrials), bounds(nTrials);
+		double dSimTime, dBoundTime;
+		int t, nViolations = 0;
+
+		for (t = 0; t < nTrials; t++)
+		{
+			RandomTSV(a[t], n);
+			RandomTSV(b[t], n);
+
+			if (t % 2 == 0)
+				b[t].SetChildrenTSV(a[t].GetTSV());
+
+			a[t].ComputeDerivedValues();
+			b[t].ComputeDerivedValues();
+
+			// The cascade reads them once per DAG, not once per pair
+			normsA[t] = a[t].GetTSV().Norm2();
+			normsB[t] = b[t].GetTSV().Norm2();
+		}
+
+		WallClock clock;
+
+		for (t = 0; t < nTrials; t++)
+			sims[t] = DAGMatcher::TSVSimilarity((a[t].GetTSV() - b[t].GetTSV()).Norm2(),
+				a[t].GetTSVNorm(), b[t].GetTSVNorm());
+
+		dSimTime = clock.Lap();
+
+		for (t = 0; t < nTrials; t++)
+			bounds[t] = MatchBoundCascade::TSVSimilarityBound(normsA[t], a[t].GetTSVNorm(),
+				normsB[t], b[t].GetTSVNorm());
+
+		dBoundTime = clock.Lap();
+
+		for (t = 0; t < nTrials; t++)
+			if (bounds[t] < sims[t] - 1e-12)
+				nViolations++;
+
+		ASSERT(nViolations == 0);
+
+		os << n << "\t" << dSimTime << "\t" << dBoundTime << "\t"
+			<< (dBoundTime > 0 ? dSimTime / dBoundTime : 0) << "\t" << nViolations << std::endl;
+	}
+}
@@ -0,0 +1,89 @@
+/* ************* Begin file main.cpp ***************************************/
+/*
+** 2015 October 10
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file main.cpp
+*	\brief Runs the DAGMatcherLib benchmarks.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*
+*	Usage: DAGMatcherBench <benchmark|all> [max size] [trials]
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include "Benchmarks.h"
+
+using namespace std;
+
+struct BenchmarkInfo
+{
+	const char* szName;
+	BENCHMARK_FUNC pFunc;
+	int nMaxSize;        //!< Default largest input
+	int nTrials;         //!< Default number of inputs per size
+	const char* szDesc;
+};
+
+static const BenchmarkInfo s_benchmarks[] = {
+	{ "arraygrowth", &BenchmarkArrayGrowth, 4096, 100, "SmartArray::AddTail() before and after geometric growth" },
+	{ "eigensum", &BenchmarkEigenSum, 512, 20, "TSV eigen-sum: full SVD and eigenvalues of adj' * adj" },
+	{ "assignment", &BenchmarkAssignment, 256, 10, "Bipartite assignment: MAX_WEIGHT_BIPARTITE_MATCHING, dense and warm-started solvers" },
+	{ "modelfit", &BenchmarkModelFit, 512, 10, "PolyLineApprox and ModelFit with and without prefix sums" },
+	{ "beliefprop", &BenchmarkBeliefProp, 256, 10, "Belief propagation assignment on one and on all cores, against the exact solver" },
+	{ "tsvbound", &BenchmarkTSVBound, 256, 10000, "TSV similarity and its bound in MatchBoundCascade, which must not be below it" },
+};
+
+static const int s_nBenchmarks = sizeof(s_benchmarks) / sizeof(s_benchmarks[0]);
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		cerr << "Usage: DAGMatcherBench <benchmark|all> [max size] [trials]\n\nBenchmarks:\n";
+
+		for (int i = 0; i < s_nBenchmarks; i++)
+			cerr << "  " << s_benchmarks[i].szName << "\t" << s_benchmarks[i].szDesc << "\n";
+
+		return 1;
+	}
+
+	const bool bAll = (strcmp(argv[1], "all") == 0);
+	bool bFound = false;
+
+	srand(0); // same inputs in every run, so that runs can be compared
+
+	for (int i = 0; i < s_nBenchmarks; i++)
+	{
+		const BenchmarkInfo& b = s_benchmarks[i];
+
+		if (!bAll && strcmp(argv[1], b.szName) != 0)
+			continue;
+
+		int nMaxSize = (argc > 2) ? atoi(argv[2]) : b.nMaxSize;
+		int nTrials = (argc > 3) ? atoi(argv[3]) : b.nTrials;
+
+		cout << "\n# " << b.szName << ": " << b.szDesc << " (" << nTrials << " trials)" << endl;
+
+		b.pFunc(nMaxSize, nTrials, cout);
+		bFound = true;
+	}
+
+	if (!bFound)
+	{
+		cerr << "Unknown benchmark '" << argv[1] << "'" << endl;
+		return 1;
+	}
+
+	return 0;
+}
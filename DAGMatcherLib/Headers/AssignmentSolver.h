@@ -0,0 +1,141 @@
+/* ************* Begin file AssignmentSolver.h ***************************************/
+/*
+** 2015 October 12
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file AssignmentSolver.h
+*	\brief Dense maximum weight assignment solver used by the bipartite graphs.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _ASSIGNMENT_SOLVER_H_
+#define _ASSIGNMENT_SOLVER_H_
+
+#include <vector>
+
+namespace dml {
+
+/*!
+	\brief Solves the maximum weight assignment between the rows and the
+	columns of a dense profit matrix.
+
+	The matrix is padded to a square and stored in one contiguous block, row
+	after row. The problem is solved with shortest augmenting paths on the
+	reduced costs (Jonker-Volgenant), in O(n^3) for n = MAX(rows, cols).
+
+	Cells with a non-positive profit are never part of the result. Every
+	buffer only grows, so solving problems of similar sizes doesn't allocate.
+
+	Rows and columns can be given labels that identify them across problems
+	(eg, the index of the DAG node they stand for). Solve() then starts from
+	the column potentials and the assignment of the last problem solved for
+	the labels found in both, which saves most of the augmentations when the
+	problems are alike, as the bipartite graphs of sibling solution sets are.
+	The result doesn't depend on the warm start, only the time it takes.
+*/
+class AssignmentSolver
+{
+	int m_nRows, m_nCols;
+	int m_nSize;                       //!< Side of the padded square matrix
+
+	std::vector<double> m_cost;        //!< Minus the profit of each cell, row after row
+	std::vector<leda::edge> m_edges;   //!< Edge with the best profit of each cell. nil if none
+	std::vector<int> m_nodeSlots;      //!< Graph node index -> row or column
+	std::vector<int> m_rowLabels, m_colLabels;
+
+	// Dual variables and assignment
+	std::vector<double> m_u, m_v;
+	std::vector<int> m_rowToCol, m_colToRow;
+
+	// Shortest path scratch buffers
+	std::vector<double> m_dist;
+	std::vector<int> m_pred;
+	std::vector<int> m_scanned;        //!< Columns in the order they were reached
+	std::vector<char> m_isScanned;
+
+	// State left by the last solve, by label
+	std::vector<double> m_lastPotentials;  //!< Column label -> potential
+	std::vector<char> m_hasLastPotential;
+	std::vector<int> m_lastColOfRow;       //!< Row label -> label of its column. -1 if none
+	std::vector<int> m_colOfLabel;         //!< Column label -> current column. -1 if none
+	std::vector<int> m_savedRowLabels, m_savedColLabels;
+
+	void WarmStart();
+	void Augment(int f);
+	void SaveState();
+
+public:
+	AssignmentSolver();
+
+	//! Starts a new problem with all the profits at zero and no labels
+	void Init(int nRows, int nCols);
+
+	/*!
+		Starts a new problem with the edges of G, which must go from the nodes
+		in A (rows) to the nodes in B (columns). The profit of each pair of
+		nodes is the best value of the edges between them.
+	*/
+	void Init(const leda::graph& G, const leda::list<leda::node>& A,
+		const leda::list<leda::node>& B, const leda::edge_array<double>& profits);
+
+	int GetRowCount() const { return m_nRows; }
+	int GetColCount() const { return m_nCols; }
+
+	//! Gives a profit to a cell. The best profit given to the cell is kept.
+	void SetProfit(int i, int j, double profit, leda::edge e = nil)
+	{
+		ASSERT(i >= 0 && i < m_nRows && j >= 0 && j < m_nCols);
+
+		double& c = m_cost[i * m_nSize + j];
+
+		if (-profit < c)
+		{
+			c = -profit;
+			m_edges[i * m_nSize + j] = e;
+		}
+	}
+
+	double GetProfit(int i, int j) const { return -m_cost[i * m_nSize + j]; }
+
+	//! Labels must be non-negative. -1 means that the row can't be warm started
+	void SetRowLabel(int i, int label) { m_rowLabels[i] = label; }
+	void SetColLabel(int j, int label) { m_colLabels[j] = label; }
+
+	//! Forgets the state left by the previous problems
+	void ClearWarmStart();
+
+	/*!
+		Solves the problem, starting from the state of the last problem if
+		bWarmStart is true.
+
+		@return the sum of the profits of the assigned cells
+	*/
+	double Solve(bool bWarmStart = true);
+
+	//! Column assigned to row i, or -1 if none (or only one with no profit)
+	int GetAssignedCol(int i) const
+	{
+		int j = m_rowToCol[i];
+
+		return (j >= 0 && j < m_nCols && m_cost[i * m_nSize + j] < 0) ? j : -1;
+	}
+
+	//! Edges of the assigned cells, if the problem came from a graph
+	void GetMatching(leda::list<leda::edge>* pMatching) const;
+
+	//! The solver of the current MatchContext
+	static AssignmentSolver& Scratch();
+};
+
+} //namespace dml
+
+#endif //_ASSIGNMENT_SOLVER_H_
@@ -61,7 +61,10 @@ protected:
 		return np[parInds[0]];
 	}
 
+	virtual double ComputeNodePairSimilarity(leda::node v1, leda::node v2) const;
+
 public:
+	virtual bool MemoizesNodeSimilarities() const { return true; }
 
 	virtual double ComputeNodeSimilarity(leda::node v1, leda::node v2,
 		NodeMatchInfoPtr ptrMatchInfo) const;
@@ -89,6 +92,9 @@ public:
 class BGContextualSimilarityMeasurer: public BGSimilarityMeasurer
 {
 public:
+	//! The similarity depends on the match info, so it can't be memoized
+	virtual bool MemoizesNodeSimilarities() const { return false; }
+
 	virtual double ComputeNodeSimilarity(leda::node v1, leda::node v2,
 		NodeMatchInfoPtr ptrMatchInfo) const;
 
@@ -3,12 +3,18 @@
 
 #include "stdafx.h"
 
+#ifdef WIN32
 #define isnan  _isnan
 #define finite _finite
 #define NORM2(X, Y) sqrt((X)*(X) + (Y)*(Y))
 #define round(X) ( ((X) < 0) ? -(int)(0.5 - (X)) : (int)((X) + 0.5) )
 #define strcasecmp(A, B) _stricmp(A, B)
 #define FILE_SEP '\\'
+#else // ie, Linux OS
+#define NORM2(X, Y) std::sqrt((X)*(X) + (Y)*(Y))
+#define sprintf_s snprintf
+#define FILE_SEP '/'
+#endif //WIN32
 
 #ifndef INFINITY
 #define INFINITY	1000000
@@ -125,7 +131,11 @@
 #define DBG_LINE  { std::cerr << std::endl << "DBG_LINE " << __LINE__ \
 	<< " at " << __FILE__ << std::endl; }
 
+#ifdef WIN32
 #define ASSERT(X) if (!(X)) {_ASSERTE(X); throw 1;}
+#else
+#define ASSERT(X) if (!(X)) {assert(X); throw 1;}
+#endif
 
 #define WARNING(X, M) \
 	if(X) { \
@@ -103,6 +103,12 @@ public:
 	void Create(const DAG& g1, const DAG& g2, bool bIncludeRootNodes);
 	void Create(const BipartiteNodeGraph& src, const NodeMatchInfoPtr& ptrNMI);
 
+	//! The DAG node of v, which is the same in the graphs of all the solution sets of a match
+	virtual int GetNodeLabel(leda::node v) const
+	{
+		return index(inf(v));
+	}
+
 	//! Sorts the given list of node assignments
 	void SortAssignment(AssignmentInfoList* pList, SORT_TYPE type)
 	{
@@ -143,6 +149,8 @@ public:
 		return sum;
 	}
 
+	double AssignmentUpperBound() const;
+
 	void GetNonZeroAssignments(AssignmentInfoList* pAssignmentInfo, SORT_TYPE sortType)
 	{
 		leda::edge e;
@@ -0,0 +1,207 @@
+/* ************* Begin file BitMatrix.h ***************************************/
+/*
+** 2015 October 05
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file BitMatrix.h
+*	\brief Packed binary matrix, used to store the transitive closure of the DAGs.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _BIT_MATRIX_H_
+#define _BIT_MATRIX_H_
+
+#include <vector>
+#include <iostream>
+
+/*!
+	\brief Binary matrix storing 64 elements per word. Every row starts on
+	a new word, so rows can be combined and tested a word at a time.
+
+	Read() and Write() use the layout of SmartMatrix<int>, so that files
+	written before the closure was packed can still be read, and the other way round.
+*/
+class BitMatrix
+{
+public:
+	typedef unsigned long long Word;
+	typedef std::vector<Word> Mask; //!< A set of column indices, WordsPerRow() words long
+
+	enum { WORD_BITS = 64 };
+
+private:
+	int m_nRows;
+	int m_nCols;
+	int m_nWordsPerRow;
+	std::vector<Word> m_words;
+
+public:
+	BitMatrix() : m_nRows(0), m_nCols(0), m_nWordsPerRow(0) { }
+
+	BitMatrix(int rows, int cols) { Resize(rows, cols); }
+
+	//! Resizes the matrix. All the elements are set to zero.
+	void Resize(int rows, int cols)
+	{
+		m_nRows = rows;
+		m_nCols = cols;
+		m_nWordsPerRow = (cols + WORD_BITS - 1) / WORD_BITS;
+		m_words.assign((size_t) rows * m_nWordsPerRow, 0);
+	}
+
+	void Clear() { Resize(0, 0); }
+
+	int NRows() const       { return m_nRows; }
+	int NCols() const       { return m_nCols; }
+	int WordsPerRow() const { return m_nWordsPerRow; }
+
+	double Size() const     { return (double) m_nRows * m_nCols; }
+	double GetSize() const  { return Size(); }
+
+	const Word* Row(int i) const { return &m_words[(size_t) i * m_nWordsPerRow]; }
+	Word* Row(int i)             { return &m_words[(size_t) i * m_nWordsPerRow]; }
+
+	bool Test(int i, int j) const
+	{
+		return ((Row(i)[j / WORD_BITS] >> (j % WORD_BITS)) & 1) != 0;
+	}
+
+	void Set(int i, int j)   { Row(i)[j / WORD_BITS] |= Word(1) << (j % WORD_BITS); }
+	void Reset(int i, int j) { Row(i)[j / WORD_BITS] &= ~(Word(1) << (j % WORD_BITS)); }
+
+	//! Row i |= row k
+	void OrRow(int i, int k)
+	{
+		Word* dst = Row(i);
+		const Word* src = Row(k);
+
+		for (int w = 0; w < m_nWordsPerRow; w++)
+			dst[w] |= src[w];
+	}
+
+	//! mask |= row i
+	void OrRowInto(int i, Mask& mask) const
+	{
+		const Word* src = Row(i);
+
+		for (int w = 0; w < m_nWordsPerRow; w++)
+			mask[w] |= src[w];
+	}
+
+	//! True if row i and the mask have at least one column in common
+	bool RowIntersects(int i, const Mask& mask) const
+	{
+		const Word* src = Row(i);
+
+		for (int w = 0; w < m_nWordsPerRow; w++)
+			if (src[w] & mask[w])
+				return true;
+
+		return false;
+	}
+
+	//! Number of non-zero elements in row i
+	int RowCount(int i) const
+	{
+		const Word* src = Row(i);
+		int n = 0;
+
+		for (int w = 0; w < m_nWordsPerRow; w++)
+			n += PopCount(src[w]);
+
+		return n;
+	}
+
+	//! An empty mask with the width of the rows
+	Mask NewMask() const { return Mask(m_nWordsPerRow, 0); }
+
+	static void SetMaskBit(Mask& mask, int j) { mask[j / WORD_BITS] |= Word(1) << (j % WORD_BITS); }
+	static void ResetMaskBit(Mask& mask, int j) { mask[j / WORD_BITS] &= ~(Word(1) << (j % WORD_BITS)); }
+	static bool TestMaskBit(const Mask& mask, int j) { return ((mask[j / WORD_BITS] >> (j % WORD_BITS)) & 1) != 0; }
+
+	//! Rows and columns are swapped
+	BitMatrix Transpose() const
+	{
+		BitMatrix t(m_nCols, m_nRows);
+
+		for (int i = 0; i < m_nRows; i++)
+			for (int j = 0; j < m_nCols; j++)
+				if (Test(i, j))
+					t.Set(j, i);
+
+		return t;
+	}
+
+	static int PopCount(Word x)
+	{
+		x = x - ((x >> 1) & 0x5555555555555555ULL);
+		x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+		x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+		return (int) ((x * 0x0101010101010101ULL) >> 56);
+	}
+
+	//! Writes the matrix as a SmartMatrix<int> of zeros and ones
+	std::ostream& Write(std::ostream& os) const
+	{
+		std::vector<int> row(m_nCols);
+		int i, j;
+
+		os.write((char*) &m_nRows, sizeof(m_nRows));
+
+		for (i = 0; i < m_nRows; i++)
+		{
+			for (j = 0; j < m_nCols; j++)
+				row[j] = Test(i, j) ? 1 : 0;
+
+			os.write((char*) &m_nCols, sizeof(m_nCols));
+
+			if (m_nCols > 0)
+				os.write((char*) &row[0], sizeof(int) * m_nCols);
+		}
+
+		return os;
+	}
+
+	//! Reads a matrix written as a SmartMatrix<int>. Any non-zero element is set.
+	std::istream& Read(std::istream& is)
+	{
+		std::vector<int> row;
+		int rows = 0, cols = 0, i, j; // set to zero in case read fails
+
+		is.read((char*) &rows, sizeof(rows));
+
+		for (i = 0; i < rows; i++)
+		{
+			is.read((char*) &cols, sizeof(cols));
+
+			if (i == 0)
+				Resize(rows, cols);
+
+			row.resize(cols);
+
+			if (cols > 0)
+				is.read((char*) &row[0], sizeof(int) * cols);
+
+			for (j = 0; j < cols && j < m_nCols; j++)
+				if (row[j] != 0)
+					Set(i, j);
+		}
+
+		if (rows <= 0)
+			Clear();
+
+		return is;
+	}
+};
+
+#endif //_BIT_MATRIX_H_
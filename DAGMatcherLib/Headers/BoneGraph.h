@@ -47,8 +47,6 @@ class BoneGraph : public DAG
 protected:
    SkeletalGraph* m_pSkeleton;
 
-   static DAGMatcher* s_pDAGMatcher; //!< Matching algorithm for bone graphs
-
 public:
    // Member variables for displaying and debugging the representation
    BezierSegmentArray m_skeletalGaps;
@@ -79,9 +77,7 @@ public:
    virtual double ComputeTSVs(leda::node root);
 
    // DAG pure virtual functions
-   virtual DAGMatcher* GetMatchingAlgorithm() const { return s_pDAGMatcher; }
-
-   virtual void SetMatchingAlgorithm();
+   virtual DAGMatcher* CreateMatchingAlgorithm(const DAGMatcher::MatchParams& params) const;
    virtual bool AreNodesRelated(leda_node g1Node, const DAG& g2, leda_node g2Node) const;
    virtual DAG* CreateObject() const;
    virtual DAGNodePtr CreateNodeObject(NODE_LABEL lbl) const;
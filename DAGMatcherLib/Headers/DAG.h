@@ -39,6 +39,8 @@
 #include "DAGNode.h"
 #include "DAGEdge.h"
 #include "DMLString.h"
+#include "BitMatrix.h"
+#include "FrozenDAG.h"
 
 #include "DAGMatcher.h"
 
@@ -69,11 +71,19 @@ typedef leda::GRAPH<DAGNodePtr, DAGEdgePtr> DAG_BASE_CLASS;
 class DAG : public DAG_BASE_CLASS
 {
 public:
+	//! Algorithms available to compute the eigen-sums of the TSVs
+	enum TSV_SOLVER {
+		TSV_SOLVER_FULL_SVD,    //!< NEWMAT SVD of the adjacency submatrix, with its left singular vectors
+		TSV_SOLVER_EIGENVALUES  //!< Eigenvalues only of the symmetric product adj' * adj
+	};
+
 	struct ConstructParams
 	{
 		int nUseDirNameAsObjName;
+		int nTSVSolver;            //!< One of TSV_SOLVER. Both give the same TSVs up to rounding.
+		int nTSVThreads;           //!< Threads computing the TSV eigen-sums of a DAG. 1 = serial, 0 = one per core.
 
-		ConstructParams() { nUseDirNameAsObjName = 1; }
+		ConstructParams() { nUseDirNameAsObjName = 1; nTSVSolver = TSV_SOLVER_EIGENVALUES; nTSVThreads = 1; }
 	};
 
 private:
@@ -85,7 +95,11 @@ private:
 	// Derived values
 	int m_nMaxBFactor;                 //!< Maximum branching factor of the DAG.
 	double m_dTotalTSVSum;             //!< Sum of all the node's TSV magnitudes.
-	SmartMatrix<int> m_transClosMat;   //!< The adjacency matrix of the transitive closure graph
+	BitMatrix m_transClosMat;          //!< The adjacency matrix of the transitive closure graph
+	BitMatrix m_ancestorMat;           //!< Its transpose: row v holds the ancestors of v
+	FrozenDAG m_frozen;                //!< Flat copy of the data used for matching (see Freeze())
+	MemoryArena* m_pArena;             //!< Storage of the nodes, edges and shock points built by this DAG
+	unsigned int m_nEdits;             //!< Number of edits, so that the flat view can tell it's out of date
 	double m_dDAGCost;                 //!< Som of all node and edge costs
 
 public:
@@ -108,7 +122,7 @@ public:
 
 public:
 // Virtual functions:
-	virtual ~DAG() { /* default virtual destructor */ }
+	virtual ~DAG() { ReleaseArena(); }
 	virtual DAG& operator=(const DAG& rhs);
 	virtual void Clear();
 	virtual void Print(std::ostream& os = std::cout, bool bXMLFormat = false) const;
@@ -128,8 +142,15 @@ public:
 	}
 
 // Pure virtual functions:
-	virtual DAGMatcher* GetMatchingAlgorithm() const = 0;
-	virtual void SetMatchingAlgorithm() = 0;
+	//! Creates the matching algorithm selected by 'params' for this class of DAG
+	virtual DAGMatcher* CreateMatchingAlgorithm(const DAGMatcher::MatchParams& params) const = 0;
+
+	//! Matching algorithm of this class of DAG in the current MatchContext
+	DAGMatcher* GetMatchingAlgorithm() const;
+
+	//! Discards the matcher of the current MatchContext so that it is recreated with the current parameters
+	void SetMatchingAlgorithm() const;
+
 	virtual bool AreNodesRelated(leda::node g1Node, const DAG& g2, leda::node g2Node) const = 0;
 	virtual DAGNodePtr CreateNodeObject(NODE_LABEL lbl) const = 0;
 	virtual DAGNodePtr ReadNode(std::istream& is) const = 0;
@@ -151,28 +172,85 @@ public:
 // Simple inline functions:
 	DAG()
 	{
+		m_pArena = NULL;
+		m_nEdits = 0;
+
 		// Init all default values
 		Clear();
 	}
 
+	//! The copy shares the nodes and edges of 'rhs' but not its arena
+	DAG(const DAG& rhs) : DAG_BASE_CLASS()
+	{
+		m_pArena = NULL;
+		m_nEdits = 0;
+
+		DAG::operator=(rhs);
+	}
+
+	/*!
+		@brief Arena from which the nodes and edges of the DAG are allocated while
+		it is built (see MemoryArena::Scope). It is created on first use and
+		released by Clear().
+	*/
+	MemoryArena* GetArena()
+	{
+		if (!m_pArena)
+			m_pArena = MemoryArena::Create();
+
+		return m_pArena;
+	}
+
+	void ReleaseArena()
+	{
+		if (m_pArena)
+		{
+			m_pArena->Release();
+			m_pArena = NULL;
+		}
+	}
+
 	leda::node NewNode(DAGNodePtr ptr)
 	{
+		m_nEdits++;
 		return DAG_BASE_CLASS::new_node(ptr);
 	}
 
 	leda::edge NewEdge(leda::node u, leda::node v, double dVal = DEFAULT_DAG_EDGE_WEIGHT)
 	{
+		m_nEdits++;
 		return DAG_BASE_CLASS::new_edge(u, v, new DAGEdge(dVal));
 	}
 
 	leda::edge NewEdge(leda::node u, leda::node v, DAGEdgePtr ptr)
 	{
+		m_nEdits++;
 		return DAG_BASE_CLASS::new_edge(u, v, ptr);
 	}
 
+	/*!
+		Number of times the DAG may have been modified. Every function that
+		can modify its structure or the data of its nodes and edges,
+		including the non-const accessors, increments it. Code that only
+		reads a DAG must therefore use the const accessors, or it drops the
+		flat view (see IsFrozen()). The node colors are not in the flat view,
+		so SetNodeColor() doesn't count.
+	*/
+	unsigned int GetEditCount() const                { return m_nEdits; }
+
+	//! The data of the nodes and edges. The non-const versions count as edits.
+	DAGNodePtr& operator[](leda::node v)             { m_nEdits++; return DAG_BASE_CLASS::operator[](v); }
+	const DAGNodePtr& operator[](leda::node v) const { return DAG_BASE_CLASS::operator[](v); }
+	DAGEdgePtr& operator[](leda::edge e)             { m_nEdits++; return DAG_BASE_CLASS::operator[](e); }
+	const DAGEdgePtr& operator[](leda::edge e) const { return DAG_BASE_CLASS::operator[](e); }
+
+	//! Base class' functions, counted as edits
+	void del_node(leda::node v)                      { m_nEdits++; DAG_BASE_CLASS::del_node(v); }
+	void del_edge(leda::edge e)                      { m_nEdits++; DAG_BASE_CLASS::del_edge(e); }
+
 	void GetClassAndModel(char* szClassName, int* pModelId) const;
 
-	void DelEdge(leda::edge e)                       { del_edge(e); }
+	void DelEdge(leda::edge e, bool bUpdateTSVs = false);
 	void DelNode(leda::node v)                       { del_node(v); }
 
 	int GetNodeCount() const                         { return number_of_nodes(); }
@@ -210,7 +288,7 @@ public:
 	int GetNodeIndex(leda::node v) const             { return index(v); }
 
 	leda::color GetNodeColor(leda::node v) const     { return inf(v)->GetColor(); }
-	void SetNodeColor(leda::node v, leda::color c)   { operator[](v)->SetColor(c); }
+	void SetNodeColor(leda::node v, leda::color c)   { DAG_BASE_CLASS::operator[](v)->SetColor(c); }
 
 	String GetDAGLbl() const                         { return m_strGraphLbl; }
 	void SetDAGLbl(const char* szLbl)                { m_strGraphLbl = szLbl; }
@@ -259,15 +337,26 @@ public:
 	leda::node GetFirstChild(leda::node v) const     { return target(first_adj_edge(v)); }
 	leda::node GetSecondChild(leda::node v) const    { return target(adj_succ(first_adj_edge(v))); }
 
-	void DeleteSubDAG(leda::node v);
+	void DeleteSubDAG(leda::node v, bool bUpdateTSVs = false);
 
 	virtual double ComputeTSVs(leda::node root);
 	double ComputeTSVs(leda::node v, int& j, Matrix& adj, NodeIndexMap& loopyNodeMap);
+	void UpdateTSVs(const leda::list<leda::node>& changedNodes);
+
+	struct TSVPlan;
+	void ComputeTSVsParallel(const SmartArray<leda::node>& roots, int nThreads);
+	int PlanTSVs(leda::node root, TSVPlan& plan);
+	int PlanTSVs(leda::node v, int& j, Matrix& adj, NodeIndexMap& loopyNodeMap, TSVPlan& plan);
+	void UpdateNodeTSV(leda::node v, leda::node_array<char>& state);
+	int CountSubDAGNodes(leda::node v, NodeIndexMap& visited) const;
+	void FillSubDAGAdjMatrix(leda::node v, int& j, Matrix& adj, NodeIndexMap& loopyNodeMap) const;
 	//double ComputeTSVs(leda::node v, Matrix& adj);
 	int AddTreeToMatrix(leda::node r, int i, Matrix& adj);
 
 // Static functions:
 	static double ComputeEigenSum(const Matrix& adj, int nVals);
+	static double ComputeEigenSumSVD(const Matrix& adj, int nVals);
+	static double ComputeEigenSumSymmetric(const Matrix& adj, int nVals);
 	static double ComputeLaplacian(const Matrix& adj);
 	static void ComputeHeights(const Matrix& adj, Matrix& m);
 
@@ -283,7 +372,17 @@ public:
 	leda::node DFSGetNext(leda::node v, EdgeList& l, bool bVisitNode = true) const;
 	leda::node BFSGetNext(leda::node v, EdgeList& l, bool bVisitNode = true) const;
 
-	const SmartMatrix<int>& GetTransClosMat() const { return m_transClosMat; }
+	const BitMatrix& GetTransClosMat() const { return m_transClosMat; }
+	const BitMatrix& GetAncestorMat() const { return m_ancestorMat; }
+
+	//! Builds the flat view of the DAG used by the matchers. Called once the derived values are known.
+	virtual void Freeze() { m_frozen.Build(*this); }
+
+	//! True if the flat view is up to date, ie, the DAG hasn't been edited since Freeze() (see GetEditCount())
+	bool IsFrozen() const { return m_frozen.IsBuiltFrom(*this); }
+
+	//! Flat view of the DAG. Only valid if IsFrozen().
+	const FrozenDAG& GetFrozenView() const { return m_frozen; }
 
 // Non-virtual non-const functions:
 	DAGPtr SplitSubGraph(leda::node v, bool bRecomputeTSVs = false);
@@ -292,6 +391,7 @@ public:
 		DynamicNodeMap& nodeParentMap, leda::edge inEdge);
 
 	void ComputeTransiveClosure();
+	void AddDescendantsToClosure(leda::node v, leda::node_array<bool>& done);
 	int ComputeNodesInfo(leda::node v, int nLevel, int nDFSIndex);
 	void ResetNodesInfo();
 	void ComputeNodesMass();
@@ -337,7 +437,7 @@ public:
 	{
 		ASSERT_GRAPH2(this, a, v);
 
-		return (m_transClosMat[GetNodeDFSIndex(a)][GetNodeDFSIndex(v)] != 0);
+		return m_transClosMat.Test(GetNodeDFSIndex(a), GetNodeDFSIndex(v));
 	}
 
 	/*!
@@ -349,7 +449,17 @@ public:
 	{
 		ASSERT_GRAPH2(this, d, v);
 
-		return (m_transClosMat[GetNodeDFSIndex(v)][GetNodeDFSIndex(d)] != 0);
+		return m_transClosMat.Test(GetNodeDFSIndex(v), GetNodeDFSIndex(d));
+	}
+
+	/*!
+		True if an ancestor of the node with DFS index 'i' (itself included) is
+		in 'nodes', a mask of DFS indices built with GetTransClosMat().NewMask()
+		and BitMatrix::SetMaskBit().
+	*/
+	bool HasAncestorIn(int i, const BitMatrix::Mask& nodes) const
+	{
+		return m_ancestorMat.RowIntersects(i, nodes);
 	}
 
 	/*!
@@ -385,10 +495,11 @@ public:
 	{
 		ASSERT_GRAPH2(this, u, v);
 
+		BitMatrix::Mask parents = m_transClosMat.NewMask();
 		leda::edge e;
 		leda::node p;
 
-		// See if v is a descendant of any parent of the matched node u
+		// Collect the parents of the matched node u
 		forall_in_edges(e, u)
 		{
 			p = source(e); // p is a parent of node u
@@ -396,11 +507,12 @@ public:
 			// Deal with the special case of v being a parent node
 			if (p == v)
 				return false;
-			else if (IsDescendant(v, p))
-				return true;
+
+			BitMatrix::SetMaskBit(parents, GetNodeDFSIndex(p));
 		}
 
-		return false;
+		// See if v is a descendant of any parent of u
+		return HasAncestorIn(GetNodeDFSIndex(v), parents);
 	}
 
 	//! Finds the first edge in the path that goes from 'v0' to 'v1'
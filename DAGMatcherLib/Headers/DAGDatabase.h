@@ -48,9 +48,16 @@ namespace dml {
 class MatchInfo;
 }
 
+#ifdef DML_NO_LEDA
+// 'leda' is then an alias of dml::gc, which can't be reopened by name
+namespace dml { namespace gc {
+int compare(const dml::MatchInfo& a, const dml::MatchInfo& b);
+} }
+#else
 namespace leda {
 int compare(const dml::MatchInfo& a, const dml::MatchInfo& b);
 }
+#endif //DML_NO_LEDA
 
 namespace dml {
 
@@ -140,6 +147,9 @@ public:
 
 	friend int leda::compare(const MatchInfo& a, const MatchInfo& b);
 
+	//! Same order as compare(), for containers that sort with operator<
+	bool operator<(const MatchInfo& rhs) const { return leda::compare(*this, rhs) < 0; }
+
 	// The stream operators are implemented only to satisfy LEDA requirements
 	friend std::ostream& operator<<(std::ostream &os, const MatchInfo& mi) { return os; }
 	friend std::istream& operator>>(std::istream &is, MatchInfo& mi) { return is; }
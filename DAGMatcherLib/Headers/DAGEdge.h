@@ -53,6 +53,7 @@ protected:
 	double weight;
 
 public:
+	DECLARE_ARENA_ALLOCATION()
 
 	DAGEdge(const double& w = DEFAULT_DAG_EDGE_WEIGHT)
 	{
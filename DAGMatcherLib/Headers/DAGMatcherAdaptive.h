@@ -88,9 +88,7 @@ public:
 
 	virtual ~DAGMatcherAdaptive()
 	{
-		// Must call the destructor of the base class
-		//DAGMatcher::~DAGMatcher();
-		delete m_pSimilarityMeasurer;
+		// The similarity measurer is deleted by ~DAGMatcher()
 	}
 
 	virtual void Clear()
@@ -42,6 +42,7 @@ class DAGMatcherOptimal : public DAGMatcher
 {
 	SolutionSetPtr m_ptrBestSet;
 	bool m_bIsSolSetFull;
+	bool m_bIsOptimal;
 
 protected:
 	void FindBestNodeAssigment(SolutionQueue& sq);
@@ -50,25 +51,38 @@ public:
 	DAGMatcherOptimal(SimilarityMeasurer* pNodeDistMeasurer)
 		: DAGMatcher(pNodeDistMeasurer)
 	{
+		m_bIsSolSetFull = false;
+		m_bIsOptimal = false;
 	}
 
 	virtual ~DAGMatcherOptimal()
 	{
-		// Must call the destructor of the base class
-		//DAGMatcher::~DAGMatcher();
-		delete m_pSimilarityMeasurer;
+		// The similarity measurer is deleted by ~DAGMatcher()
 	}
 
 	BipartiteNodeGraph::SORT_TYPE GetSortType() const
 	{
-		return (BipartiteNodeGraph::SORT_TYPE)
-			DAGMatcher::GetMatchParams().nNodeAssignSortType;
+		return (BipartiteNodeGraph::SORT_TYPE) Params().nNodeAssignSortType;
 	}
 
 	double ComputeNormalizationFactor(const DAG& g1, const DAG& g2);
 
+	/*!
+		True if the last match explored every solution set that could beat
+		the one found. False if the search was cut by the limits in the
+		match params, in which case the result is the best set seen.
+	*/
+	bool IsOptimal() const
+	{
+		return m_bIsOptimal;
+	}
+
 	virtual double Match(const DAG& g1, const DAG& g2);
 
+	virtual bool BoundsSimilarity() const { return true; }
+
+	virtual double SimilarityBound(const DAG& g1, const DAG& g2, double dNodeSimSum) const;
+
 	//! Gets a one-to-one map from g1 nodes to g2 nodes
 	virtual void GetNodeMap(NodeMatchMap& nodeMap) const
 	{
@@ -80,9 +80,7 @@ public:
 
 	virtual ~DAGMatcherTopological()
 	{
-		// Must call the destructor of the base class
-		//DAGMatcher::~DAGMatcher();
-		delete m_pSimilarityMeasurer;
+		// The similarity measurer is deleted by ~DAGMatcher()
 	}
 
 	virtual double Match(const DAG& g1, const DAG& g2);
@@ -91,6 +91,8 @@ class DAGNode
 public:
 	typedef int label_type;
 
+	DECLARE_ARENA_ALLOCATION()
+
 	DAGNode(NODE_LABEL lbl = NODE_LBL_DEFAULT_VAL);
 
 	DAGNode(const DAGNode& rhs) { DAGNode::operator=(rhs); }
@@ -44,8 +44,14 @@
 
 #define MAX_PATH_SIZE 260 // ie, MAX_PATH in Windows.h
 
+#ifdef WIN32
 typedef void* HANDLE;
 struct _WIN32_FIND_DATAA;
+#else
+# include <sys/types.h>
+# include <dirent.h>
+typedef DIR* HANDLE;
+#endif
 
 
 /*!
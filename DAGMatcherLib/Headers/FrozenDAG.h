@@ -0,0 +1,103 @@
+/* ************* Begin file FrozenDAG.h ***************************************/
+/*
+** 2015 October 07
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file FrozenDAG.h
+*	\brief Flat, read-only copy of the data of a DAG used by the matchers.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _FROZEN_DAG_H_
+#define _FROZEN_DAG_H_
+
+#include <vector>
+
+namespace dml {
+class DAG; // Forward Declaration of the class contained in DAG.h
+
+/*!
+	\brief Snapshot of a DAG laid out in flat arrays indexed by DFS index.
+
+	The adjacency is stored in compressed sparse rows (children and parents
+	of node i are in [ChildBegin(i), ChildEnd(i)) and [ParentBegin(i), ParentEnd(i))),
+	every node attribute is stored in its own array, and all the TSVs are
+	stored one after the other in a single array.
+
+	It is built by DAG::Freeze() once the derived values are computed, and is
+	only valid as long as the DAG isn't modified (see DAG::IsFrozen()).
+	Slots of DFS indices that are not used by the DAG are left empty.
+*/
+class FrozenDAG
+{
+	const DAG* m_pDag;        //!< The graph this view was built from
+	unsigned int m_nEdits;    //!< Edit count of the DAG when it was built
+
+	std::vector<leda::node> m_nodes; //!< DFS index -> node. nil for the unused indices
+
+	std::vector<int> m_childOffsets;
+	std::vector<int> m_children;
+	std::vector<int> m_parentOffsets;
+	std::vector<int> m_parents;
+
+	std::vector<int> m_types;
+	std::vector<int> m_masses;
+	std::vector<int> m_levels;
+	std::vector<double> m_tsvNorms;
+	std::vector<double> m_childTSVNorms; //!< Norms of the children TSVs, without the eigen labels
+	std::vector<double> m_subtreeCosts;
+
+	std::vector<int> m_tsvOffsets;   //!< TSV of node i is in [m_tsvOffsets[i], m_tsvOffsets[i + 1])
+	std::vector<double> m_tsvValues;
+
+public:
+	FrozenDAG() { Clear(); }
+
+	void Build(const DAG& dag);
+	void Clear();
+
+	//! True if the view was built from 'dag' and the DAG wasn't edited since (see DAG::GetEditCount())
+	bool IsBuiltFrom(const DAG& dag) const;
+
+	//! Number of slots, ie, the greatest DFS index plus one
+	int Size() const                  { return (int) m_nodes.size(); }
+	leda::node Node(int i) const      { return m_nodes[i]; }
+
+	int ChildBegin(int i) const       { return m_childOffsets[i]; }
+	int ChildEnd(int i) const         { return m_childOffsets[i + 1]; }
+	int Child(int k) const            { return m_children[k]; }
+	int OutDegree(int i) const        { return ChildEnd(i) - ChildBegin(i); }
+
+	int ParentBegin(int i) const      { return m_parentOffsets[i]; }
+	int ParentEnd(int i) const        { return m_parentOffsets[i + 1]; }
+	int Parent(int k) const           { return m_parents[k]; }
+	int InDegree(int i) const         { return ParentEnd(i) - ParentBegin(i); }
+
+	int NodeType(int i) const         { return m_types[i]; }
+	int NodeMass(int i) const         { return m_masses[i]; }
+	int NodeLevel(int i) const        { return m_levels[i]; }
+	double TSVNorm(int i) const       { return m_tsvNorms[i]; }
+	double ChildTSVNorm(int i) const  { return m_childTSVNorms[i]; }
+	double SubtreeCost(int i) const   { return m_subtreeCosts[i]; }
+
+	int TSVSize(int i) const          { return m_tsvOffsets[i + 1] - m_tsvOffsets[i]; }
+	const double* TSVData(int i) const
+	{
+		return m_tsvValues.empty() ? NULL : &m_tsvValues[0] + m_tsvOffsets[i];
+	}
+
+	//! Same as (tsv_i - tsv_j).Norm2(), where j is a node of 'g'. The shortest TSV is padded with zeros.
+	double TSVDiffNorm(int i, const FrozenDAG& g, int j) const;
+};
+} //namespace dml
+
+#endif //_FROZEN_DAG_H_
@@ -55,8 +55,6 @@ class GestureGraph : public DAG
    SmartMatrix<GGRelation> relationMatrix;			//!< Matrix of the relations
    int m_nRootNodeCount;			                //!< Number of roots in the graph
 
-   static DAGMatcher* s_pDAGMatcher;               //!< Matching algorithm for gesture graphs
-
 public:
    GestureGraph() { m_nRootNodeCount = 0; }
 
@@ -74,9 +72,7 @@ public:
    virtual void Clear();
 
    // DAG pure virtual functions
-   virtual DAGMatcher* GetMatchingAlgorithm() const { return s_pDAGMatcher; }
-
-   virtual void SetMatchingAlgorithm();
+   virtual DAGMatcher* CreateMatchingAlgorithm(const DAGMatcher::MatchParams& params) const;
    virtual bool AreNodesRelated(leda_node g1Node, const DAG& g2, leda_node g2Node) const;
    virtual DAG* CreateObject() const;
    virtual DAGNodePtr CreateNodeObject(NODE_LABEL lbl) const;
@@ -0,0 +1,1203 @@
+/* ************* Begin file GraphCore.h ***************************************/
+/*
+** 2015 October 08
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file GraphCore.h
+*	\brief Graphs and containers with the call surface of the LEDA ones used by DAGMatcherLib.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*
+*	Used instead of LEDA when DML_NO_LEDA is defined (see LEDA_issues.h), where the
+*	namespace leda becomes an alias of dml::gc. Only the parts of LEDA used by the
+*	matching code are provided: directed graphs with node and edge information,
+*	node/edge arrays and maps, lists, queues, priority queues, dictionaries, and the
+*	algorithms TOPSORT, COMPONENTS and MAX_WEIGHT_BIPARTITE_MATCHING.
+*	The windows and GraphWin used by the views still need LEDA.
+*/
+
+#ifndef _GRAPH_CORE_H_
+#define _GRAPH_CORE_H_
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <istream>
+
+#ifndef nil
+	#define nil 0
+#endif
+
+namespace dml {
+namespace gc {
+
+class graph;
+struct node_struct;
+struct edge_struct;
+
+typedef node_struct* node;
+typedef edge_struct* edge;
+
+//! Raises the errors LEDA reports through its error handler
+inline void error_handler(int, const char* msg)
+{
+	throw std::logic_error(msg);
+}
+
+/* *******************************************************************
+*                               Graphs                               *
+ ********************************************************************/
+
+struct node_struct
+{
+	int id;
+	graph* owner;
+	node_struct* prev;  //!< Previous node of the graph
+	node_struct* next;  //!< Next node of the graph
+	edge_struct* firstOut;
+	edge_struct* lastOut;
+	edge_struct* firstIn;
+	edge_struct* lastIn;
+	int outdeg;
+	int indeg;
+};
+
+struct edge_struct
+{
+	int id;
+	node_struct* s;
+	node_struct* t;
+	edge_struct* prev;    //!< Previous edge of the graph
+	edge_struct* next;    //!< Next edge of the graph
+	edge_struct* outPrev; //!< Previous out edge of s
+	edge_struct* outNext; //!< Next out edge of s
+	edge_struct* inPrev;  //!< Previous in edge of t
+	edge_struct* inNext;  //!< Next in edge of t
+};
+
+template <class T> class list;
+template <class T> class node_array;
+
+/*!
+	\brief Directed graph with adjacency lists.
+
+	Nodes and edges keep the order in which they are created. Their
+	indices are never reused until the graph is cleared, so node and
+	edge arrays can be indexed by them.
+*/
+class graph
+{
+	node_struct* m_firstNode;
+	node_struct* m_lastNode;
+	edge_struct* m_firstEdge;
+	edge_struct* m_lastEdge;
+	int m_nNodes, m_nEdges;
+	int m_nNextNodeId, m_nNextEdgeId;
+
+	void init();
+	void unlink_out(edge e);
+	void unlink_in(edge e);
+	void link_out(edge e);
+	void link_in(edge e);
+
+protected:
+	//! Called before a node is deleted, to release its information
+	virtual void release_inf(node) { }
+	//! Called before an edge is deleted, to release its information
+	virtual void release_inf(edge) { }
+	//! Called after a clear(), when the node and edge indices start from 0 again
+	virtual void reset_infs() { }
+
+	/*!
+		Copies the nodes and edges of G, in the same order. The k-th node
+		(edge) of G is mapped to nodes[k] (edges[k]).
+	*/
+	void copy_structure(const graph& G, std::vector<node>& nodes, std::vector<edge>& edges);
+
+public:
+	graph()                              { init(); }
+	graph(const graph& G)                { init(); operator=(G); }
+	virtual ~graph()                     { clear(); }
+
+	graph& operator=(const graph& G);
+
+	node new_node();
+	edge new_edge(node v, node w);
+	void del_node(node v);
+	void del_edge(edge e);
+	void del_all_nodes()                 { clear(); }
+	void del_all_edges();
+	void del_nodes(const list<node>& L);
+	void del_edges(const list<edge>& L);
+	void clear();
+
+	//! Makes e go from v to w, keeping its information
+	void move_edge(edge e, node v, node w);
+	void rev_edge(edge e)                { move_edge(e, e->t, e->s); }
+
+	int number_of_nodes() const          { return m_nNodes; }
+	int number_of_edges() const          { return m_nEdges; }
+	bool empty() const                   { return m_nNodes == 0; }
+	int max_node_index() const           { return m_nNextNodeId - 1; }
+	int max_edge_index() const           { return m_nNextEdgeId - 1; }
+
+	node first_node() const              { return m_firstNode; }
+	node last_node() const               { return m_lastNode; }
+	node succ_node(node v) const         { return v->next; }
+	node pred_node(node v) const         { return v->prev; }
+	edge first_edge() const              { return m_firstEdge; }
+	edge last_edge() const               { return m_lastEdge; }
+	edge succ_edge(edge e) const         { return e->next; }
+	edge pred_edge(edge e) const         { return e->prev; }
+
+	edge first_adj_edge(node v) const    { return v->firstOut; }
+	edge last_adj_edge(node v) const     { return v->lastOut; }
+	edge adj_succ(edge e) const          { return e->outNext; }
+	edge adj_pred(edge e) const          { return e->outPrev; }
+	edge first_out_edge(node v) const    { return v->firstOut; }
+	edge out_succ(edge e) const          { return e->outNext; }
+	edge first_in_edge(node v) const     { return v->firstIn; }
+	edge last_in_edge(node v) const      { return v->lastIn; }
+	edge in_succ(edge e) const           { return e->inNext; }
+	edge in_pred(edge e) const           { return e->inPrev; }
+
+	node source(edge e) const            { return e->s; }
+	node target(edge e) const            { return e->t; }
+	node opposite(node v, edge e) const  { return (v == e->s) ? e->t : e->s; }
+	int outdeg(node v) const             { return v->outdeg; }
+	int indeg(node v) const              { return v->indeg; }
+	int degree(node v) const             { return v->outdeg + v->indeg; }
+
+	list<node> all_nodes() const;
+	list<edge> all_edges() const;
+};
+
+inline node source(edge e)                { return e->s; }
+inline node target(edge e)                { return e->t; }
+inline node opposite(node v, edge e)      { return (v == e->s) ? e->t : e->s; }
+inline int outdeg(node v)                 { return v->outdeg; }
+inline int indeg(node v)                  { return v->indeg; }
+inline int degree(node v)                 { return v->outdeg + v->indeg; }
+inline int index(node v)                  { return v->id; }
+inline int index(edge e)                  { return e->id; }
+inline graph* graph_of(node v)            { return v->owner; }
+inline graph* graph_of(edge e)            { return e->s->owner; }
+inline edge first_adj_edge(node v)        { return v->firstOut; }
+inline edge first_in_edge(node v)         { return v->firstIn; }
+inline edge adj_succ(edge e)              { return e->outNext; }
+inline edge in_succ(edge e)               { return e->inNext; }
+
+/*!
+	\brief Graph with an information of type V in every node and of type E
+	in every edge. The references to the informations stay valid as long as
+	their node or edge exists.
+*/
+template <class V, class E> class GRAPH : public graph
+{
+	std::deque<V> m_nodeInf;
+	std::deque<E> m_edgeInf;
+
+	template <class T> static T& slot(std::deque<T>& d, int id)
+	{
+		if (id >= (int) d.size())
+			d.resize(id + 1);
+
+		return d[id];
+	}
+
+protected:
+	virtual void release_inf(node v)  { if (v->id < (int) m_nodeInf.size()) m_nodeInf[v->id] = V(); }
+	virtual void release_inf(edge e)  { if (e->id < (int) m_edgeInf.size()) m_edgeInf[e->id] = E(); }
+	virtual void reset_infs()         { m_nodeInf.clear(); m_edgeInf.clear(); }
+
+public:
+	GRAPH() { }
+	GRAPH(const GRAPH<V, E>& G) : graph() { operator=(G); }
+	~GRAPH() { clear(); }
+
+	GRAPH<V, E>& operator=(const GRAPH<V, E>& G)
+	{
+		if (this == &G)
+			return *this;
+
+		std::vector<node> nodes;
+		std::vector<edge> edges;
+		size_t k = 0;
+
+		copy_structure(G, nodes, edges);
+
+		for (node v = G.first_node(); v; v = G.succ_node(v))
+			slot(m_nodeInf, nodes[k++]->id) = G.inf(v);
+
+		k = 0;
+
+		for (edge e = G.first_edge(); e; e = G.succ_edge(e))
+			slot(m_edgeInf, edges[k++]->id) = G.inf(e);
+
+		return *this;
+	}
+
+	node new_node()                       { return new_node(V()); }
+	node new_node(const V& x)
+	{
+		node v = graph::new_node();
+		slot(m_nodeInf, v->id) = x;
+		return v;
+	}
+
+	edge new_edge(node v, node w)         { return new_edge(v, w, E()); }
+	edge new_edge(node v, node w, const E& x)
+	{
+		edge e = graph::new_edge(v, w);
+		slot(m_edgeInf, e->id) = x;
+		return e;
+	}
+
+	const V& inf(node v) const            { return m_nodeInf[v->id]; }
+	const E& inf(edge e) const            { return m_edgeInf[e->id]; }
+	V& operator[](node v)                 { return m_nodeInf[v->id]; }
+	E& operator[](edge e)                 { return m_edgeInf[e->id]; }
+	const V& operator[](node v) const     { return m_nodeInf[v->id]; }
+	const E& operator[](edge e) const     { return m_edgeInf[e->id]; }
+
+	void assign(node v, const V& x)       { m_nodeInf[v->id] = x; }
+	void assign(edge e, const E& x)       { m_edgeInf[e->id] = x; }
+
+	/*!
+		The informations of the nodes. Unlike LEDA's, it is a copy, so it
+		must be bound to a const reference and isn't updated by the graph.
+	*/
+	node_array<V> node_data() const;
+};
+
+/* *******************************************************************
+*                       Node and edge arrays                         *
+ ********************************************************************/
+
+//! Storage used for the elements of the arrays, so that bool elements can be referenced
+template <class T> struct array_slot       { typedef T type; };
+template <> struct array_slot<bool>        { typedef unsigned char type; };
+
+/*!
+	\brief Array indexed by the node (or edge) indices. It grows when
+	written at an index it doesn't hold yet, so it is also valid for the
+	nodes created after it was initialized (like a LEDA node_map).
+*/
+template <class T, class ITEM> class graph_array
+{
+	typedef typename array_slot<T>::type S;
+
+	std::vector<S> m_vals;
+	T m_def;
+	const graph* m_pGraph;
+
+	static int size_of(const graph& G, node)  { return G.max_node_index() + 1; }
+	static int size_of(const graph& G, edge)  { return G.max_edge_index() + 1; }
+
+public:
+	graph_array() : m_def(), m_pGraph(NULL) { }
+	graph_array(const graph& G) : m_def(), m_pGraph(NULL) { init(G); }
+	graph_array(const graph& G, const T& x) : m_def(), m_pGraph(NULL) { init(G, x); }
+
+	void init()                       { m_vals.clear(); m_pGraph = NULL; }
+	void init(const graph& G)         { init(G, T()); }
+	void init(const graph& G, const T& x)
+	{
+		m_def = x;
+		m_pGraph = &G;
+		m_vals.assign(size_of(G, ITEM()), (S) x);
+	}
+
+	T& operator[](ITEM it)
+	{
+		if (it->id >= (int) m_vals.size())
+			m_vals.resize(it->id + 1, (S) m_def);
+
+		return *reinterpret_cast<T*>(&m_vals[it->id]);
+	}
+
+	const T& operator[](ITEM it) const
+	{
+		return (it->id < (int) m_vals.size()) ? *reinterpret_cast<const T*>(&m_vals[it->id]) : m_def;
+	}
+
+	T& operator()(ITEM it)                 { return operator[](it); }
+	const T& operator()(ITEM it) const     { return operator[](it); }
+
+	const graph& get_graph() const         { return *m_pGraph; }
+};
+
+template <class T> class node_array : public graph_array<T, node>
+{
+public:
+	node_array() { }
+	node_array(const graph& G) : graph_array<T, node>(G) { }
+	node_array(const graph& G, const T& x) : graph_array<T, node>(G, x) { }
+};
+
+template <class T> class edge_array : public graph_array<T, edge>
+{
+public:
+	edge_array() { }
+	edge_array(const graph& G) : graph_array<T, edge>(G) { }
+	edge_array(const graph& G, const T& x) : graph_array<T, edge>(G, x) { }
+};
+
+template <class T> class node_map : public node_array<T>
+{
+public:
+	node_map() { }
+	node_map(const graph& G) : node_array<T>(G) { }
+	node_map(const graph& G, const T& x) : node_array<T>(G, x) { }
+};
+
+template <class T> class edge_map : public edge_array<T>
+{
+public:
+	edge_map() { }
+	edge_map(const graph& G) : edge_array<T>(G) { }
+	edge_map(const graph& G, const T& x) : edge_array<T>(G, x) { }
+};
+
+template <class V, class E> node_array<V> GRAPH<V, E>::node_data() const
+{
+	node_array<V> A(*this);
+
+	for (node v = first_node(); v; v = succ_node(v))
+		A[v] = inf(v);
+
+	return A;
+}
+
+//! As in LEDA, nodes and edges are written as addresses and can't be read back
+inline std::istream& operator>>(std::istream& is, node&)   { return is; }
+inline std::istream& operator>>(std::istream& is, edge&)   { return is; }
+
+/* *******************************************************************
+*                          Linear containers                         *
+ ********************************************************************/
+
+//! Default order used by the sorted containers. Can be specialized like in LEDA.
+template <class T> int compare(const T& a, const T& b)
+{
+	return (a < b) ? -1 : ((b < a) ? 1 : 0);
+}
+
+struct list_elem_base
+{
+	list_elem_base* prev;
+	list_elem_base* next;
+};
+
+typedef list_elem_base* list_item;
+
+//! Doubly linked list. Its items stay valid until they are deleted.
+template <class T> class list
+{
+	struct elem : list_elem_base
+	{
+		T val;
+		elem(const T& x) : val(x) { }
+	};
+
+	list_elem_base* m_first;
+	list_elem_base* m_last;
+	int m_nSize;
+
+	static T& val(list_item it)       { return static_cast<elem*>(it)->val; }
+
+	list_item link(list_item it, list_item pos, bool bAfter)
+	{
+		if (pos == nil)
+			pos = bAfter ? m_last : m_first;
+
+		if (pos == nil)
+		{
+			it->prev = it->next = nil;
+			m_first = m_last = it;
+		}
+		else if (bAfter)
+		{
+			it->prev = pos;
+			it->next = pos->next;
+			(pos->next ? pos->next->prev : m_last) = it;
+			pos->next = it;
+		}
+		else
+		{
+			it->next = pos;
+			it->prev = pos->prev;
+			(pos->prev ? pos->prev->next : m_first) = it;
+			pos->prev = it;
+		}
+
+		m_nSize++;
+		return it;
+	}
+
+	void unlink(list_item it)
+	{
+		(it->prev ? it->prev->next : m_first) = it->next;
+		(it->next ? it->next->prev : m_last) = it->prev;
+		m_nSize--;
+	}
+
+public:
+	typedef list_item item;
+
+	list() : m_first(nil), m_last(nil), m_nSize(0) { }
+	list(const list<T>& L) : m_first(nil), m_last(nil), m_nSize(0) { operator=(L); }
+	~list() { clear(); }
+
+	list<T>& operator=(const list<T>& L)
+	{
+		if (this != &L)
+		{
+			clear();
+
+			for (list_item it = L.m_first; it; it = it->next)
+				append(val(it));
+		}
+
+		return *this;
+	}
+
+	int size() const                    { return m_nSize; }
+	int length() const                  { return m_nSize; }
+	bool empty() const                  { return m_nSize == 0; }
+
+	list_item first() const             { return m_first; }
+	list_item last() const              { return m_last; }
+	list_item first_item() const        { return m_first; }
+	list_item last_item() const         { return m_last; }
+	list_item succ(list_item it) const  { return it->next; }
+	list_item pred(list_item it) const  { return it->prev; }
+	list_item next_item(list_item it) const { return it->next; }
+	list_item cyclic_succ(list_item it) const { return it->next ? it->next : m_first; }
+	list_item cyclic_pred(list_item it) const { return it->prev ? it->prev : m_last; }
+
+	const T& inf(list_item it) const    { return val(it); }
+	const T& contents(list_item it) const { return val(it); }
+	T& operator[](list_item it)         { return val(it); }
+	const T& operator[](list_item it) const { return val(it); }
+	void assign(list_item it, const T& x) { val(it) = x; }
+
+	const T& head() const               { return val(m_first); }
+	const T& tail() const               { return val(m_last); }
+	const T& front() const              { return val(m_first); }
+	const T& back() const               { return val(m_last); }
+
+	list_item append(const T& x)        { return link(new elem(x), nil, true); }
+	list_item push(const T& x)          { return link(new elem(x), nil, false); }
+	list_item push_back(const T& x)     { return append(x); }
+	list_item push_front(const T& x)    { return push(x); }
+	//! Inserts x after (or before) the item it
+	list_item insert(const T& x, list_item it, bool bAfter = true)
+	{
+		return link(new elem(x), it, bAfter);
+	}
+
+	list<T>& operator+=(const T& x)     { append(x); return *this; }
+
+	T del_item(list_item it)
+	{
+		T x = val(it);
+		unlink(it);
+		delete static_cast<elem*>(it);
+		return x;
+	}
+
+	T del(list_item it)                 { return del_item(it); }
+	void erase(list_item it)            { del_item(it); }
+	T pop()                             { return del_item(m_first); }
+	T pop_front()                       { return del_item(m_first); }
+	T pop_back()                        { return del_item(m_last); }
+	T Pop()                             { return del_item(m_last); }
+
+	void clear()
+	{
+		while (m_first)
+			pop();
+	}
+
+	list_item search(const T& x) const
+	{
+		for (list_item it = m_first; it; it = it->next)
+			if (val(it) == x)
+				return it;
+
+		return nil;
+	}
+
+	//! Removes all the elements equal to x
+	void remove(const T& x)
+	{
+		list_item it = m_first, nx;
+
+		for (; it; it = nx)
+		{
+			nx = it->next;
+
+			if (val(it) == x)
+				del_item(it);
+		}
+	}
+
+	list_item get_item(int i) const
+	{
+		list_item it = m_first;
+
+		while (it && i-- > 0)
+			it = it->next;
+
+		return it;
+	}
+
+	int rank(const T& x) const
+	{
+		int r = 1;
+
+		for (list_item it = m_first; it; it = it->next, r++)
+			if (val(it) == x)
+				return r;
+
+		return 0;
+	}
+
+	//! Appends the elements of L, which becomes empty
+	void conc(list<T>& L)
+	{
+		if (&L == this || L.empty())
+			return;
+
+		if (m_last)
+		{
+			m_last->next = L.m_first;
+			L.m_first->prev = m_last;
+		}
+		else
+			m_first = L.m_first;
+
+		m_last = L.m_last;
+		m_nSize += L.m_nSize;
+		L.m_first = L.m_last = nil;
+		L.m_nSize = 0;
+	}
+
+	void reverse()
+	{
+		list_item it = m_first, nx;
+
+		std::swap(m_first, m_last);
+
+		for (; it; it = nx)
+		{
+			nx = it->next;
+			std::swap(it->prev, it->next);
+		}
+	}
+
+	void reverse_items() { reverse(); }
+
+	//! Stable sort with the function cmp, which returns <0, 0 or >0 like LEDA's compare
+	void sort(int (*cmp)(const T&, const T&))
+	{
+		std::vector<list_item> items;
+		items.reserve(m_nSize);
+
+		for (list_item it = m_first; it; it = it->next)
+			items.push_back(it);
+
+		std::stable_sort(items.begin(), items.end(), item_less(cmp));
+
+		m_first = m_last = nil;
+		m_nSize = 0;
+
+		for (size_t i = 0; i < items.size(); i++)
+			link(items[i], nil, true);
+	}
+
+	void sort() { sort(&compare<T>); }
+
+private:
+	struct item_less
+	{
+		int (*cmp)(const T&, const T&);
+		item_less(int (*c)(const T&, const T&)) : cmp(c) { }
+		bool operator()(list_item a, list_item b) const { return cmp(val(a), val(b)) < 0; }
+	};
+};
+
+template <class T> class queue : public list<T>
+{
+public:
+	const T& top() const               { return this->head(); }
+	void append(const T& x)            { list<T>::append(x); }
+	T pop()                            { return list<T>::pop(); }
+};
+
+template <class T> class array
+{
+	std::vector<T> m_vals;
+
+public:
+	array() { }
+	array(int n) : m_vals(n) { }
+	array(int low, int high) : m_vals(high - low + 1) { check_low(low); }
+
+	static void check_low(int low)
+	{
+		if (low != 0)
+			error_handler(1, "array: only a lower bound of 0 is supported");
+	}
+
+	int size() const                   { return (int) m_vals.size(); }
+	int low() const                    { return 0; }
+	int high() const                   { return size() - 1; }
+	void resize(int n)                 { m_vals.resize(n); }
+	void resize(int low, int high)     { check_low(low); m_vals.resize(high + 1); }
+
+	T& operator[](int i)               { return m_vals[i]; }
+	const T& operator[](int i) const   { return m_vals[i]; }
+
+	void sort(int (*cmp)(const T&, const T&))
+	{
+		std::stable_sort(m_vals.begin(), m_vals.end(), less_by(cmp));
+	}
+
+	void sort()                        { sort(&compare<T>); }
+
+private:
+	struct less_by
+	{
+		int (*cmp)(const T&, const T&);
+		less_by(int (*c)(const T&, const T&)) : cmp(c) { }
+		bool operator()(const T& a, const T& b) const { return cmp(a, b) < 0; }
+	};
+};
+
+template <class A, class B> class two_tuple
+{
+	A m_a;
+	B m_b;
+
+public:
+	two_tuple() : m_a(), m_b() { }
+	two_tuple(const A& a, const B& b) : m_a(a), m_b(b) { }
+
+	A& first()                         { return m_a; }
+	const A& first() const             { return m_a; }
+	B& second()                        { return m_b; }
+	const B& second() const            { return m_b; }
+
+	bool operator==(const two_tuple<A, B>& x) const { return m_a == x.m_a && m_b == x.m_b; }
+};
+
+/* *******************************************************************
+*                           Priority queue                           *
+ ********************************************************************/
+
+struct pq_elem_base
+{
+	int pos; //!< Position in the heap
+};
+
+typedef pq_elem_base* pq_item;
+
+//! Binary min-heap of (priority, information) pairs, with stable items.
+template <class P, class I> class p_queue
+{
+	struct elem : pq_elem_base
+	{
+		P prio;
+		I inf;
+		elem(const P& p, const I& i) : prio(p), inf(i) { }
+	};
+
+	std::vector<elem*> m_heap;
+
+	static elem* cast(pq_item it) { return static_cast<elem*>(it); }
+
+	void place(elem* x, int i)     { m_heap[i] = x; x->pos = i; }
+
+	void sift_up(int i)
+	{
+		elem* x = m_heap[i];
+
+		while (i > 0)
+		{
+			int p = (i - 1) / 2;
+
+			if (!(compare(x->prio, m_heap[p]->prio) < 0))
+				break;
+
+			place(m_heap[p], i);
+			i = p;
+		}
+
+		place(x, i);
+	}
+
+	void sift_down(int i)
+	{
+		elem* x = m_heap[i];
+		int n = (int) m_heap.size();
+
+		for (;;)
+		{
+			int c = 2 * i + 1;
+
+			if (c >= n)
+				break;
+
+			if (c + 1 < n && compare(m_heap[c + 1]->prio, m_heap[c]->prio) < 0)
+				c++;
+
+			if (!(compare(m_heap[c]->prio, x->prio) < 0))
+				break;
+
+			place(m_heap[c], i);
+			i = c;
+		}
+
+		place(x, i);
+	}
+
+public:
+	typedef gc::pq_item pq_item;
+
+	p_queue() { }
+	p_queue(const p_queue<P, I>& Q) { operator=(Q); }
+	~p_queue() { clear(); }
+
+	p_queue<P, I>& operator=(const p_queue<P, I>& Q)
+	{
+		if (this != &Q)
+		{
+			clear();
+			m_heap.reserve(Q.m_heap.size());
+
+			for (size_t i = 0; i < Q.m_heap.size(); i++)
+			{
+				elem* x = new elem(*Q.m_heap[i]);
+				place(x, (int) i); // same heap layout
+			}
+		}
+
+		return *this;
+	}
+
+	int size() const                       { return (int) m_heap.size(); }
+	bool empty() const                     { return m_heap.empty(); }
+
+	pq_item insert(const P& p, const I& i)
+	{
+		elem* x = new elem(p, i);
+		m_heap.push_back(x);
+		sift_up((int) m_heap.size() - 1);
+		return x;
+	}
+
+	pq_item find_min() const               { return m_heap.empty() ? nil : m_heap[0]; }
+
+	const P& prio(pq_item it) const        { return cast(it)->prio; }
+	const I& inf(pq_item it) const         { return cast(it)->inf; }
+	void change_inf(pq_item it, const I& i) { cast(it)->inf = i; }
+
+	void decrease_p(pq_item it, const P& p)
+	{
+		cast(it)->prio = p;
+		sift_up(it->pos);
+	}
+
+	void del_item(pq_item it)
+	{
+		int i = it->pos;
+		elem* last = m_heap.back();
+
+		m_heap.pop_back();
+
+		if (last != it)
+		{
+			place(last, i);
+			sift_down(i);
+			sift_up(last->pos);
+		}
+
+		delete cast(it);
+	}
+
+	I del_min()
+	{
+		I i = cast(m_heap[0])->inf;
+		del_item(m_heap[0]);
+		return i;
+	}
+
+	void clear()
+	{
+		for (size_t i = 0; i < m_heap.size(); i++)
+			delete m_heap[i];
+
+		m_heap.clear();
+	}
+
+	//! Items in heap order (not sorted)
+	pq_item first_item() const             { return m_heap.empty() ? nil : m_heap[0]; }
+	pq_item next_item(pq_item it) const
+	{
+		return (it->pos + 1 < (int) m_heap.size()) ? m_heap[it->pos + 1] : nil;
+	}
+};
+
+/* *******************************************************************
+*                            Dictionaries                            *
+ ********************************************************************/
+
+//! Strict weak order defined by compare()
+template <class K> struct compare_less
+{
+	bool operator()(const K& a, const K& b) const { return compare(a, b) < 0; }
+};
+
+//! Ordered dictionary with a default value for the undefined keys
+template <class K, class V> class d_array
+{
+public:
+	typedef std::map<K, V, compare_less<K> > container;
+
+private:
+	container m_map;
+	V m_def;
+
+public:
+	d_array() : m_def() { }
+	d_array(const V& x) : m_def(x) { }
+
+	V& operator[](const K& k)
+	{
+		typename container::iterator it = m_map.find(k);
+
+		if (it == m_map.end())
+			it = m_map.insert(std::make_pair(k, m_def)).first;
+
+		return it->second;
+	}
+
+	const V& operator[](const K& k) const
+	{
+		typename container::const_iterator it = m_map.find(k);
+		return (it == m_map.end()) ? m_def : it->second;
+	}
+
+	bool defined(const K& k) const     { return m_map.find(k) != m_map.end(); }
+	void undefine(const K& k)          { m_map.erase(k); }
+	int size() const                   { return (int) m_map.size(); }
+	bool empty() const                 { return m_map.empty(); }
+	void clear()                       { m_map.clear(); }
+
+	typename container::const_iterator defined_begin() const { return m_map.begin(); }
+	typename container::const_iterator defined_end() const   { return m_map.end(); }
+};
+
+//! Hashed dictionary with a default value for the undefined keys
+template <class K, class V> class h_array
+{
+public:
+	typedef std::unordered_map<K, V> container;
+
+private:
+	container m_map;
+	V m_def;
+
+public:
+	h_array() : m_def() { }
+	h_array(const V& x, int table_sz = 0) : m_def(x) { if (table_sz > 0) m_map.rehash(table_sz); }
+
+	V& operator[](const K& k)
+	{
+		typename container::iterator it = m_map.find(k);
+
+		if (it == m_map.end())
+			it = m_map.insert(std::make_pair(k, m_def)).first;
+
+		return it->second;
+	}
+
+	const V& operator[](const K& k) const
+	{
+		typename container::const_iterator it = m_map.find(k);
+		return (it == m_map.end()) ? m_def : it->second;
+	}
+
+	bool defined(const K& k) const     { return m_map.find(k) != m_map.end(); }
+	void undefine(const K& k)          { m_map.erase(k); }
+	int size() const                   { return (int) m_map.size(); }
+	bool empty() const                 { return m_map.empty(); }
+	void clear()                       { m_map.clear(); }
+
+	typename container::const_iterator defined_begin() const { return m_map.begin(); }
+	typename container::const_iterator defined_end() const   { return m_map.end(); }
+};
+
+template <class K, class V> class map : public h_array<K, V>
+{
+public:
+	map() { }
+	map(const V& x, int table_sz = 0) : h_array<K, V>(x, table_sz) { }
+};
+
+struct seq_elem_base
+{
+};
+
+typedef seq_elem_base* seq_item;
+
+//! Sorted sequence of (key, information) pairs with stable items
+template <class K, class I> class sortseq
+{
+	struct elem : seq_elem_base
+	{
+		K key;
+		I inf;
+		elem(const K& k, const I& i) : key(k), inf(i) { }
+	};
+
+	typedef std::map<K, elem*, compare_less<K> > container;
+	container m_map;
+
+	static elem* cast(seq_item it)     { return static_cast<elem*>(it); }
+
+public:
+	sortseq() { }
+	sortseq(const sortseq<K, I>& S) { operator=(S); }
+	~sortseq() { clear(); }
+
+	sortseq<K, I>& operator=(const sortseq<K, I>& S)
+	{
+		if (this != &S)
+		{
+			clear();
+
+			for (typename container::const_iterator it = S.m_map.begin(); it != S.m_map.end(); ++it)
+				insert(it->first, it->second->inf);
+		}
+
+		return *this;
+	}
+
+	seq_item lookup(const K& k) const
+	{
+		typename container::const_iterator it = m_map.find(k);
+		return (it == m_map.end()) ? nil : it->second;
+	}
+
+	seq_item insert(const K& k, const I& i)
+	{
+		typename container::iterator it = m_map.find(k);
+
+		if (it != m_map.end())
+		{
+			it->second->inf = i;
+			return it->second;
+		}
+
+		elem* x = new elem(k, i);
+		m_map.insert(std::make_pair(k, x));
+		return x;
+	}
+
+	void del(const K& k)
+	{
+		typename container::iterator it = m_map.find(k);
+
+		if (it != m_map.end())
+		{
+			delete it->second;
+			m_map.erase(it);
+		}
+	}
+
+	void del_item(seq_item it)          { del(cast(it)->key); }
+
+	const K& key(seq_item it) const     { return cast(it)->key; }
+	const I& inf(seq_item it) const     { return cast(it)->inf; }
+	I& operator[](seq_item it)          { return cast(it)->inf; }
+	const I& operator[](seq_item it) const { return cast(it)->inf; }
+
+	int size() const                    { return (int) m_map.size(); }
+	bool empty() const                  { return m_map.empty(); }
+
+	void clear()
+	{
+		for (typename container::iterator it = m_map.begin(); it != m_map.end(); ++it)
+			delete it->second;
+
+		m_map.clear();
+	}
+
+	seq_item min_item() const           { return m_map.empty() ? nil : m_map.begin()->second; }
+	seq_item max_item() const           { return m_map.empty() ? nil : m_map.rbegin()->second; }
+
+	seq_item succ(seq_item it) const
+	{
+		typename container::const_iterator i = m_map.upper_bound(cast(it)->key);
+		return (i == m_map.end()) ? nil : i->second;
+	}
+
+	seq_item first_item() const         { return min_item(); }
+	seq_item next_item(seq_item it) const { return succ(it); }
+};
+
+/* *******************************************************************
+*                               Colors                               *
+ ********************************************************************/
+
+enum color_cons {
+	invisible = -1, white = 0, black, red, green, blue, yellow, violet, orange,
+	cyan, brown, pink, green2, blue2, grey1, grey2, grey3, ivory, grey = grey2
+};
+
+//! Display color. Only stored by the graphs, since they are drawn by the LEDA views.
+class color
+{
+	int m_r, m_g, m_b;
+
+public:
+	color(color_cons c = black)
+	{
+		static const int rgb[][3] = {
+			{255, 255, 255}, {0, 0, 0}, {255, 0, 0}, {0, 255, 0}, {0, 0, 255},
+			{255, 255, 0}, {160, 32, 240}, {255, 165, 0}, {0, 255, 255}, {165, 42, 42},
+			{255, 192, 203}, {0, 205, 0}, {0, 0, 205}, {224, 224, 224}, {192, 192, 192},
+			{128, 128, 128}, {255, 255, 240}
+		};
+
+		if (c == invisible)
+			m_r = m_g = m_b = -1;
+		else
+			m_r = rgb[c][0], m_g = rgb[c][1], m_b = rgb[c][2];
+	}
+
+	color(int r, int g, int b) : m_r(r), m_g(g), m_b(b) { }
+
+	void get_rgb(int& r, int& g, int& b) const { r = m_r; g = m_g; b = m_b; }
+
+	bool operator==(const color& c) const { return m_r == c.m_r && m_g == c.m_g && m_b == c.m_b; }
+	bool operator!=(const color& c) const { return !operator==(c); }
+};
+
+/* *******************************************************************
+*                             Algorithms                             *
+ ********************************************************************/
+
+/*!
+	Numbers the nodes from 1 to n such that ord[v] < ord[w] for every edge
+	(v, w). Returns false if G has a cycle.
+*/
+bool TOPSORT(const graph& G, node_array<int>& ord);
+bool TOPSORT(const graph& G, list<node>& L);
+
+//! Numbers the connected components (ignoring edge directions) from 0. Returns their count.
+int COMPONENTS(const graph& G, node_array<int>& compnum);
+
+/*!
+	Maximum weight matching of a bipartite graph whose edges go from
+	one side to the other. Edges with a non-positive weight are never
+	part of the matching.
+*/
+list<edge> MAX_WEIGHT_BIPARTITE_MATCHING(const graph& G, const edge_array<double>& c);
+
+template <class NT> list<edge> MAX_WEIGHT_BIPARTITE_MATCHING_T(const graph& G, const edge_array<NT>& c)
+{
+	edge_array<double> w(G);
+
+	for (edge e = G.first_edge(); e; e = G.succ_edge(e))
+		w[e] = (double) c[e];
+
+	return MAX_WEIGHT_BIPARTITE_MATCHING(G, w);
+}
+
+//! The matching is computed in doubles, so the weights never need to be scaled
+template <class NT> bool MWBM_SCALE_WEIGHTS(const graph&, edge_array<NT>&)
+{
+	return true;
+}
+
+template <class NT> void scale_weights(const graph&, edge_array<NT>&, double) { }
+
+} // namespace gc
+} // namespace dml
+
+/* *******************************************************************
+*                             Iteration                              *
+ ********************************************************************/
+
+// The successor is read before the body runs, so the current node or edge may be deleted.
+
+#define forall_nodes(v, G) \
+	for (dml::gc::node gc_nx_ = ((v) = (G).first_node()) ? (v)->next : nil; (v); \
+		(v) = gc_nx_, gc_nx_ = (v) ? (v)->next : nil)
+
+#define forall_rev_nodes(v, G) \
+	for (dml::gc::node gc_nx_ = ((v) = (G).last_node()) ? (v)->prev : nil; (v); \
+		(v) = gc_nx_, gc_nx_ = (v) ? (v)->prev : nil)
+
+#define forall_edges(e, G) \
+	for (dml::gc::edge gc_nx_ = ((e) = (G).first_edge()) ? (e)->next : nil; (e); \
+		(e) = gc_nx_, gc_nx_ = (e) ? (e)->next : nil)
+
+#define forall_out_edges(e, v) \
+	for (dml::gc::edge gc_nx_ = ((e) = (v)->firstOut) ? (e)->outNext : nil; (e); \
+		(e) = gc_nx_, gc_nx_ = (e) ? (e)->outNext : nil)
+
+#define forall_adj_edges(e, v) forall_out_edges(e, v)
+
+#define forall_in_edges(e, v) \
+	for (dml::gc::edge gc_nx_ = ((e) = (v)->firstIn) ? (e)->inNext : nil; (e); \
+		(e) = gc_nx_, gc_nx_ = (e) ? (e)->inNext : nil)
+
+//! The out edges of v, then its in edges
+#define forall_inout_edges(e, v) \
+	for (dml::gc::edge gc_nx_ = ((e) = ((v)->firstOut ? (v)->firstOut : (v)->firstIn)) ? \
+			dml::gc::inout_succ(v, e) : nil; (e); \
+		(e) = gc_nx_, gc_nx_ = (e) ? dml::gc::inout_succ(v, e) : nil)
+
+#define forall_adj_nodes(u, v) \
+	for (dml::gc::edge gc_e_ = (v)->firstOut; gc_e_ && (((u) = gc_e_->t), true); gc_e_ = gc_e_->outNext)
+
+#define forall_items(it, L) \
+	for ((it) = (L).first_item(); (it); (it) = (L).next_item(it))
+
+#define forall(x, L) \
+	for (dml::gc::list_item gc_it_ = (L).first(); gc_it_ && (((x) = (L).inf(gc_it_)), true); \
+		gc_it_ = (L).succ(gc_it_))
+
+#define forall_defined(k, A) \
+	for (auto gc_it_ = (A).defined_begin(); gc_it_ != (A).defined_end() && (((k) = gc_it_->first), true); ++gc_it_)
+
+namespace dml {
+namespace gc {
+//! Next edge of forall_inout_edges: the out edges of v come first, then its in edges
+inline edge inout_succ(node v, edge e)
+{
+	if (e->s == v && e->outNext)
+		return e->outNext;
+
+	return (e->s == v) ? v->firstIn : e->inNext;
+}
+} // namespace gc
+} // namespace dml
+
+#endif //_GRAPH_CORE_H_
@@ -47,7 +47,40 @@
 
 #define LEDA_VERSION 44
 
-#if LEDA_VERSION == 43
+#ifdef DML_NO_LEDA
+
+/*!
+  The in-house graphs and containers have the same names as the LEDA ones,
+  so the code keeps using the namespace leda and the leda_* names.
+*/
+#include "GraphCore.h"
+
+namespace leda = dml::gc;
+namespace LEDA = dml::gc;
+
+#define leda_node               leda::node
+#define leda_edge               leda::edge
+#define leda_graph              leda::graph
+#define leda_list               leda::list
+#define leda_list_item          leda::list_item
+#define leda_node_array         leda::node_array
+#define leda_edge_array         leda::edge_array
+#define leda_node_map           leda::node_map
+#define leda_edge_map           leda::edge_map
+#define leda_array              leda::array
+#define leda_d_array            leda::d_array
+#define leda_h_array            leda::h_array
+#define leda_p_queue            leda::p_queue
+#define leda_pq_item            leda::pq_item
+#define leda_sortseq            leda::sortseq
+#define leda_seq_item           leda::seq_item
+#define leda_color              leda::color
+#define leda_white              leda::white
+#define leda_grey               leda::grey
+
+#define LEDA_GRAPH              leda::GRAPH
+
+#elif LEDA_VERSION == 43
 
 #define leda_list_item          list_item
 #define leda_seq_item           seq_item
@@ -37,7 +37,7 @@
 #ifndef __MG_SHOCKGRAPH_H__
 #define __MG_SHOCKGRAPH_H__
 
-#include <LEDA\internal\PREAMBLE.h>
+#include <LEDA/internal/PREAMBLE.h>
 
 namespace dml {
 
@@ -0,0 +1,110 @@
+/* ************* Begin file MatchBounds.h ***************************************/
+/*
+** 2015 October 16
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file MatchBounds.h
+*	\brief Cheap upper bounds of the similarity computed by a DAGMatcher.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _MATCH_BOUNDS_H_
+#define _MATCH_BOUNDS_H_
+
+#include <vector>
+
+namespace dml {
+
+/*!
+	\brief Bounds the similarity of a query to a model without matching them,
+	with a sequence of bounds, each tighter and more expensive than the last.
+
+	The matches pair the nodes one-to-one, so the sum of their node
+	similarities is at most the weight of the best assignment between the
+	nodes, where the weight of a pair is the bound given by
+	DAGMatcher::NodeSimilarityBound(). The stages bound that sum:
+
+	- NODE_COUNT_BOUND: the smaller node count. O(1).
+	- LABEL_BOUND: the number of pairs with the same node type, when the
+	  measurer only compares nodes of the same type. O(n log n).
+	- TSV_BOUND: the best pair of each row or column, bounding the TSV
+	  similarity with the norms of the children TSVs. O(n^2).
+	- ASSIGNMENT_BOUND: the assignment itself, without the structural
+	  constraints of the matchers. O(n^3).
+
+	and DAGMatcher::SimilarityBound() turns it into a bound of the
+	similarity. The cascade stops at the first stage whose bound is below
+	the given threshold. Matchers whose similarity can't be bounded this
+	way (see DAGMatcher::BoundsSimilarity()) get a bound of one.
+*/
+class MatchBoundCascade
+{
+public:
+	enum STAGE { NO_BOUND_STAGE = -1, NODE_COUNT_BOUND, LABEL_BOUND, TSV_BOUND,
+		ASSIGNMENT_BOUND, NUM_BOUND_STAGES };
+
+private:
+	//! What the bounds read from a DAG
+	struct Profile
+	{
+		std::vector<int> types;        //!< Type of each node
+		std::vector<int> sortedTypes;  //!< The same, sorted
+		std::vector<double> tsvNorms;  //!< TSV norm of each node
+		std::vector<double> childTSVNorms; //!< Norm of the children TSV of each node
+
+		void Read(const DAG& dag);
+	};
+
+	const DAG* m_pQuery;
+	const DAGMatcher* m_pMatcher;
+	Profile m_query;
+
+	// Scratch buffers
+	Profile m_model;
+	std::vector<double> m_pairBounds;  //!< Bound of each pair of nodes, row after row
+	std::vector<double> m_colMax;
+
+	double ComputeLabelBound() const;
+	double ComputeTSVBound();
+	double ComputeAssignmentBound() const;
+
+public:
+	MatchBoundCascade() { m_pQuery = NULL; m_pMatcher = NULL; }
+
+	/*!
+		Sets the query, which is matched by the matcher of the current
+		MatchContext. The query must not be modified while the cascade is used.
+	*/
+	void Init(const DAG& query);
+
+	/*!
+		Bounds the similarity between the query and the model.
+
+		@param dThreshold the cascade stops once the bound is below it
+		@param pBound the bound of the last stage computed
+		@return the last stage computed, or NO_BOUND_STAGE if the similarity
+		        can't be bounded
+	*/
+	STAGE ComputeBound(const DAG& model, double dThreshold, double* pBound);
+
+	static const char* GetStageName(STAGE stage);
+
+	/*!
+		Bound of DAGMatcher::TSVSimilarity() for two nodes whose children
+		TSVs have norms c1 and c2, and whose TSVs have norms n1 and n2.
+	*/
+	static double TSVSimilarityBound(double c1, double n1, double c2, double n2);
+};
+
+} //namespace dml
+
+#endif //_MATCH_BOUNDS_H_
@@ -0,0 +1,100 @@
+/* ************* Begin file MatchContext.h ***************************************/
+/*
+** 2015 October 11
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file MatchContext.h
+*	\brief State of the matches run by one query: parameters, matchers, scratch buffers and counters.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _MATCH_CONTEXT_H_
+#define _MATCH_CONTEXT_H_
+
+#include <map>
+#include <string>
+#include <boost/thread/mutex.hpp>
+
+namespace dml {
+class DAG; // Forward Declaration of the class contained in DAG.h
+
+/*!
+	\brief Everything that a match reads or writes besides the two graphs.
+
+	Each thread that runs matches makes its own context current with a
+	MatchContext::Scope. The matchers, similarity measurers and vote counters
+	used within the scope belong to that context, so threads matching with
+	different parameters don't share any mutable state. The models
+	themselves can be shared, as long as they are not modified.
+
+	Without a scope, the process-wide default context is used, which is
+	what DAGMatcher::SetMatchParams() and DAGMatcher::GetMatchParams()
+	refer to in single-threaded programs.
+*/
+class MatchContext
+{
+	typedef std::map<std::string, DAGMatcher*> MatcherMap;
+
+	DAGMatcher::MatchParams m_params;
+	MatcherMap m_matchers;              //!< Matching algorithm of each DAG class, created on first use
+	boost::mutex m_matchersMutex;       //!< Only needed by the default context, but cheap
+
+	MatchContext(const MatchContext&);            // not copyable
+	MatchContext& operator=(const MatchContext&);
+
+public:
+	// Counters
+	long nExpandedSolSets;              //!< Solution sets expanded by the optimal matcher in the last match
+
+	// Scratch buffers
+	SmartArray<leda::node> modelNodeMap; //!< Model node index -> node of the vote graph (see PartitionBins)
+	AssignmentSolver assignmentSolver;   //!< Solver of the bipartite graphs (see BipartiteGraph)
+	BeliefPropSolver beliefPropSolver;   //!< Its approximate alternative, with USE_BELIEF_PROP_ASSIGNMENT
+
+	MatchContext();
+	explicit MatchContext(const DAGMatcher::MatchParams& params);
+	~MatchContext();
+
+	const DAGMatcher::MatchParams& GetParams() const { return m_params; }
+
+	//! Sets the parameters. The matchers are recreated, since they depend on them.
+	void SetParams(const DAGMatcher::MatchParams& params);
+
+	//! Matching algorithm for the class of 'dag', created with the parameters of this context
+	DAGMatcher* GetMatcher(const DAG& dag);
+
+	//! Deletes the matcher of a DAG class so that it is recreated on next use
+	void ResetMatcher(const std::string& strClassName);
+	void ResetMatchers();
+
+	static MatchContext& Default();
+	static MatchContext& Current();
+
+	/*!
+		\brief Makes a context the current one of the calling thread
+		until the end of the scope. Scopes can be nested.
+	*/
+	class Scope
+	{
+		MatchContext* m_pPrevious;
+
+		Scope(const Scope&);
+		Scope& operator=(const Scope&);
+
+	public:
+		Scope(MatchContext& context);
+		~Scope();
+	};
+};
+} //namespace dml
+
+#endif //_MATCH_CONTEXT_H_
@@ -0,0 +1,120 @@
+/* ************* Begin file MemoryArena.h ***************************************/
+/*
+** 2015 October 09
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file MemoryArena.h
+*	\brief Monotonic memory arena owning the nodes, edges and shock points of a DAG.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _MEMORY_ARENA_H_
+#define _MEMORY_ARENA_H_
+
+#include <vector>
+#include <boost/smart_ptr/detail/atomic_count.hpp>
+
+#ifdef _MSC_VER
+	#define DML_THREAD_LOCAL __declspec(thread)
+#else
+	#define DML_THREAD_LOCAL __thread
+#endif
+
+namespace dml {
+
+/*!
+	\brief Allocates memory from large blocks by moving a pointer forward.
+
+	Memory is never given back to the arena one object at a time. All the
+	blocks are released in one shot when the arena is released by its owner
+	and every object allocated from it has been deleted. Objects shared with
+	other graphs (eg, the nodes of a copied DAG) keep the arena alive.
+
+	Classes opt in with DECLARE_ARENA_ALLOCATION(), which makes their
+	operator new take the memory from the arena of the current thread
+	(see MemoryArena::Scope), or from the heap if there is none. Filling an
+	arena is not thread-safe, but its objects can be deleted from any thread.
+*/
+class MemoryArena
+{
+	//! Placed before every object so that operator delete knows where it came from
+	union Header {
+		MemoryArena* pArena;  //!< NULL for objects allocated on the heap
+		double dAlign;
+		long long llAlign;
+	};
+
+	enum { DEFAULT_BLOCK_SIZE = 64 * 1024 };
+
+	std::vector<char*> m_blocks;
+	char* m_pTop;                 //!< Next free byte of the current block
+	char* m_pEnd;                 //!< End of the current block
+	size_t m_nBlockSize;
+	size_t m_nUsedBytes;
+	size_t m_nReservedBytes;
+	boost::detail::atomic_count m_nRefs; //!< One for the owner plus one per live object
+
+	MemoryArena(size_t nBlockSize);
+	~MemoryArena();
+
+	MemoryArena(const MemoryArena&);            // not copyable
+	MemoryArena& operator=(const MemoryArena&);
+
+	void* Allocate(size_t nBytes);
+
+public:
+	//! Creates an arena with a single reference, which belongs to the caller
+	static MemoryArena* Create(size_t nBlockSize = DEFAULT_BLOCK_SIZE)
+	{
+		return new MemoryArena(nBlockSize);
+	}
+
+	void AddRef()  { ++m_nRefs; }
+	void Release() { if (--m_nRefs == 0) delete this; }
+
+	size_t GetUsedBytes() const     { return m_nUsedBytes; }
+	size_t GetReservedBytes() const { return m_nReservedBytes; }
+
+	static MemoryArena* GetCurrent();
+
+	//! Allocates from the current arena, or from the heap if there is none
+	static void* New(size_t nBytes);
+	static void Delete(void* p);
+
+	/*!
+		\brief Makes an arena the current one of the calling thread
+		until the end of the scope. Scopes can be nested.
+	*/
+	class Scope
+	{
+		MemoryArena* m_pPrevious;
+		MemoryArena* m_pArena;
+
+		Scope(const Scope&);
+		Scope& operator=(const Scope&);
+
+	public:
+		Scope(MemoryArena* pArena);
+		~Scope();
+	};
+};
+
+} //namespace dml
+
+//! Declares the operators new and delete of a class allocated from the current MemoryArena
+#define DECLARE_ARENA_ALLOCATION() \
+	static void* operator new(size_t n)     { return dml::MemoryArena::New(n); } \
+	static void* operator new[](size_t n)   { return dml::MemoryArena::New(n); } \
+	static void operator delete(void* p)    { dml::MemoryArena::Delete(p); } \
+	static void operator delete[](void* p)  { dml::MemoryArena::Delete(p); }
+
+#endif //_MEMORY_ARENA_H_
@@ -45,19 +45,98 @@ struct MINMAX
 	MINMAX(int mi, int ma) { min = mi; max = ma; }
 };
 
+/*!
+	\brief The data of a shock graph node that ModelFit reads, either as the
+	points to fit or as the model fitted to them.
+
+	It doesn't depend on the node it's compared with, so it's built once per
+	node (see ShockGraph::Freeze()) and shared, read-only, by all the fits.
+
+	The points are also kept as separate arrays of arc lengths (x) and radii
+	(y), which is the layout read by the vectorized kernels of SimdKernels.h.
+*/
+struct ModelFitDescriptor
+{
+	POINTS points[2];                 //!< Velocity/radius points in forward [0] and reverse [1] order
+	std::vector<double> arcLens[2];   //!< X of the points of each order, ie, the cumulative velocities
+	std::vector<double> radii[2];     //!< Y of the points of each order
+	SmartArray<double> dataLens[2];   //!< Cumulative lengths of the points of each order
+	LineSegmentArray segments;        //!< Line segments of the node
+	SmartArray<double> lineLens;      //!< Cumulative lengths of the segments
+
+	// Radial properties of the whole node, compared before trying any fit
+	int nShocks;
+	double firstRadius, avgRadius, length;
+
+	ModelFitDescriptor() { nShocks = 0; firstRadius = avgRadius = length = 0; }
+
+	void Set(const POINTS& forwardPts, const POINTS& reversePts, const LineSegmentArray& segs);
+
+	//! Sets the points of one order (0 is forward, 1 is reverse) and their cumulative lengths
+	void SetPoints(int k, const POINTS& pts);
+
+	void SetModel(const LineSegmentArray& segs);
+
+	void SetShape(int nShockCount, double dFirstRadius, double dAvgRadius, double dLength)
+	{
+		nShocks = nShockCount;
+		firstRadius = dFirstRadius;
+		avgRadius = dAvgRadius;
+		length = dLength;
+	}
+};
+
 class ModelFit
 {
 	MEMORY2 m_minerrors;
 	LineSegmentArray m_segments;
 	POINTS m_points;
-	SmartArray<double> m_minLineLen;
+	const double* m_xs;               //!< X of m_points, either in a ModelFitDescriptor or in m_xBuf
+	const double* m_ys;               //!< Y of m_points, either in a ModelFitDescriptor or in m_yBuf
+	std::vector<double> m_xBuf, m_yBuf;
+	SmartArray<double> m_lineLen;     //!< Cumulative lengths of the segments, before scaling by m_minLenCoeff
 	SmartArray<double> m_minDataLen;
+	std::vector<double> m_errorSums;  //!< Prefix sums of the error of the points wrt each segment, segment after segment
 	double m_minLenCoeff, m_totalMinLineLen, m_totalMaxLineLen, m_totalDataLen;
+	bool m_bUsePrefixSums;
+
+	void ComputeErrorSums();
+
+	double Fit(const POINTS& vertices, const double* xs, const double* ys,
+		const SmartArray<double>& dataLens, const LineSegmentArray& segs,
+		const SmartArray<double>& lineLens);
 
 public:
-	ModelFit(double minLenCoeff) { m_minLenCoeff = minLenCoeff; }
+	ModelFit(double minLenCoeff)
+	{
+		m_minLenCoeff = minLenCoeff;
+		m_bUsePrefixSums = true;
+		m_xs = m_ys = NULL;
+	}
+
+	//! Sums the errors with the prefix sums (the default) or point by point. Only useful to measure the difference.
+	void UsePrefixSums(bool bOn) { m_bUsePrefixSums = bOn; }
+
+	//! Cumulative lengths of the polyline through the vertices, starting at zero
+	static SmartArray<double> CumulativeLengths(const POINTS& vertices);
+
+	//! Cumulative lengths of the segments, up to and including each one
+	static SmartArray<double> CumulativeLengths(const LineSegmentArray& segs);
 
 	double Fit(const POINTS& vertices, const LineSegmentArray& segs);
+
+	//! Fit() with the cumulative lengths already computed, eg, by a ModelFitDescriptor
+	double Fit(const POINTS& vertices, const SmartArray<double>& dataLens,
+		const LineSegmentArray& segs, const SmartArray<double>& lineLens);
+
+	//! Fits the model of a node to the points of another node, in the given order
+	double Fit(const ModelFitDescriptor& data, bool bReverseOrder, const ModelFitDescriptor& model)
+	{
+		const int k = bReverseOrder ? 1 : 0;
+
+		return Fit(data.points[k], &data.arcLens[k][0], &data.radii[k][0],
+			data.dataLens[k], model.segments, model.lineLens);
+	}
 	MEMDATA Min(int ls, int le, int ps, int pe);
 	void UpdateSegments(int ls, int le, int ps, int pe);
 	double CompLSError(int ls, int ps, int pe) const;
@@ -73,6 +73,92 @@ public:
 
 typedef SmartArray< SmartMatrix<MEMDATA> > MEMORY;
 
+/*!
+	\brief Prefix sums of x, y, x^2, xy and y^2 of a sequence of points,
+	which give the least squares line of any run of consecutive points in O(1).
+
+	The points are shifted by their mean before being summed, so that the
+	differences of prefix sums don't lose the precision of small runs.
+*/
+class PointPrefixSums
+{
+	struct SUMS
+	{
+		double x, y, xx, xy, yy;
+	};
+
+	double m_x0, m_y0;         //!< Mean of the points
+	std::vector<SUMS> m_sums;  //!< m_sums[i] is the sum over the first i points
+
+public:
+	void Init(const POINTS& pts)
+	{
+		const int n = pts.GetSize();
+		SUMS s = {0, 0, 0, 0, 0};
+		int i;
+
+		m_x0 = m_y0 = 0;
+
+		for (i = 0; i < n; i++)
+		{
+			m_x0 += pts[i].x;
+			m_y0 += pts[i].y;
+		}
+
+		if (n > 0)
+		{
+			m_x0 /= n;
+			m_y0 /= n;
+		}
+
+		m_sums.resize(n + 1);
+		m_sums[0] = s;
+
+		for (i = 0; i < n; i++)
+		{
+			const double x = pts[i].x - m_x0;
+			const double y = pts[i].y - m_y0;
+
+			s.x += x;
+			s.y += y;
+			s.xx += x * x;
+			s.xy += x * y;
+			s.yy += y * y;
+
+			m_sums[i + 1] = s;
+		}
+	}
+
+	/*!
+		Fits the line y = m * x + b to the points s to e (both included)
+		by least squares.
+
+		@return the sum of the squared errors of the points
+	*/
+	double FitLine(int s, int e, double* pM, double* pB) const
+	{
+		const SUMS& a = m_sums[s];
+		const SUMS& z = m_sums[e + 1];
+		const double n = e - s + 1;
+		const double sx = z.x - a.x, sy = z.y - a.y;
+
+		// Centered sums of squares of the run
+		const double cxx = (z.xx - a.xx) - sx * sx / n;
+		const double cxy = (z.xy - a.xy) - sx * sy / n;
+		const double cyy = (z.yy - a.yy) - sy * sy / n;
+
+		const double m = cxy / cxx;
+
+		*pM = m;
+		*pB = m_y0 + (sy - m * sx) / n - m * m_x0;
+
+		// The residual is cyy - m * cxy, which can only go below zero by rounding
+		const double err = cyy - m * cxy;
+
+		return (err > 0) ? err : 0;
+	}
+};
+
 struct SLOPE
 {
 	double m;
@@ -117,6 +203,7 @@ public:
 
 	SmartArray<KNOT> m_knots;
 	POINTS m_points;
+	PointPrefixSums m_sums;  //!< Sums of the points, for the subclasses that fit segments with them
 	SmartMatrix<SEGMENT> m_segments;
 	MEMORY m_minerrors;
 
@@ -139,6 +226,12 @@ public:
 		return LeastSquares(vertices + fromIdx, toIdx - fromIdx + 1, s);
 	}
 
+	//! Fits a segment to the points from s to e of the data. Overridden by the subclasses that use m_sums.
+	virtual double FitSegment(int s, int e, SEGMENT& seg)
+	{
+		return LeastSquares(m_points, s, e, seg);
+	}
+
 	void Fit(const POINTS vertices);
 	double FindMaxYDiff(int seg_num, int s, int e) const;
 
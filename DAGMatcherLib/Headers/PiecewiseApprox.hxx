@@ -98,6 +98,7 @@ void PiecewiseApprox<SEGMENT>::Fit(const POINTS pts)
 	ASSERT(n > 1);
 
 	m_points = pts;
+	m_sums.Init(pts);
 	m_segments.Resize(n, n);
 	m_minerrors.Resize(n);
 	m_knots.Clear();
@@ -141,7 +142,7 @@ MEMDATA PiecewiseApprox<SEGMENT>::Min(int seg_num, int s, int e)
 
 		if (seg_num == 1)
 		{
-			minerror = LeastSquares(m_points, s, e, m_segments[s][e]);
+			minerror = FitSegment(s, e, m_segments[s][e]);
 			minpt = s;
 		}
 		else
@@ -225,13 +226,18 @@ double PiecewiseApprox<SEGMENT>::CompAcuteAngle(int seg1, int seg2) const
 
 	double s = (s2.p1.x - s1.p0.x) / (m_ymax - m_ymin);
 
-	Logger::Log( "disp('scaling: " + m_ymin + "," + m_ymax + "," + s + "');", constants::LogCore);
+	Logger::Log("disp('scaling: " + to_string((long double) m_ymin) + ","
+		+ to_string((long double) m_ymax) + "," + to_string((long double) s) + "');",
+		constants::LogCore);
 
 	//find vectors
 	POINT v1(s1.p0.x - s1.p1.x, (s1.p0.y - s1.p1.y) * s);
 	POINT v2(s2.p1.x - s2.p0.x, (s2.p1.y - s2.p0.y) * s);
 
-	Logger::Log( "disp('v1: " + v1 + " v2: " + v2 << "');", constants::LogCore);
+	std::ostringstream oss;
+
+	oss << "disp('v1: " << v1 << " v2: " << v2 << "');";
+	Logger::Log(oss.str(), constants::LogCore);
 
 	// compute angle
 	return acos(v1.Dot(v2) / (v1.L2() * v2.L2())) * (180 / 3.14159265);
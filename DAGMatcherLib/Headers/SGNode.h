@@ -61,6 +61,8 @@ struct ShockInfo
 	int type;
 	int dir;		//!< Direction: increasing=1, decreasing=-1, constant=0
 
+	DECLARE_ARENA_ALLOCATION() // the point arrays of the branches live in the arena of their graph
+
 	ShockInfo() { xcoord = ycoord = radius = speed = dr_ds = dr = 0; color = 0; type = dir = 0; }
 
 	/*virtual*/ std::istream& Read(std::istream& is);
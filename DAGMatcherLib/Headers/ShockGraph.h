@@ -71,7 +71,7 @@ protected:
 	int m_nLastIndexUsed;
 	ShockGraphParams m_compParams;
 
-	static DAGMatcher* s_pDAGMatcher; //!< Matching algorithm for shock graphs
+	std::vector<ModelFitDescriptor> m_fitDescriptors; //!< Fit data of each node, by DFS index (see Freeze())
 
 protected:
 	const char* GetNextIdx();
@@ -114,6 +114,12 @@ public:
 
 	GRAMMAR_RULE GetRewriteRule(leda_node r) const;
 
+	//! Fit data of the node with DFS index i. Only valid if IsFrozen().
+	const ModelFitDescriptor& GetFitDescriptor(int i) const { return m_fitDescriptors[i]; }
+
+	//! Computes the fit data of a non-root node, as Freeze() does
+	void ComputeFitDescriptor(leda_node v, ModelFitDescriptor* pDesc) const;
+
 	bool CheckChildNodeTypes(leda_node r, SmartArray<int> validTypes,
 		const ShockInfo* pInvJointPt = NULL) const;
 
@@ -124,11 +130,10 @@ public:
 	virtual ShockGraph& operator=(const ShockGraph& rhs);
 
 	virtual void Clear();
+	virtual void Freeze();
 
 	// DAG pure virtual functions
-	virtual DAGMatcher* GetMatchingAlgorithm() const { return s_pDAGMatcher; }
-
-	virtual void SetMatchingAlgorithm();
+	virtual DAGMatcher* CreateMatchingAlgorithm(const DAGMatcher::MatchParams& params) const;
 	virtual bool AreNodesRelated(leda_node g1Node, const DAG& g2, leda_node g2Node) const;
 	virtual DAG* CreateObject() const;
 	virtual DAGNodePtr CreateNodeObject(NODE_LABEL lbl) const;
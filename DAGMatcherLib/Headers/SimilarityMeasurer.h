@@ -39,18 +39,101 @@
 
 namespace dml {
 typedef std::vector<int> ParamIndices;
+class MatchContext; // Forward Declaration of the class contained in MatchContext.h
+
+/*!
+	\brief Node similarities between the nodes of two DAGs, each computed
+	at most once.
+
+	The values are kept in a dense matrix indexed by the DFS indices of
+	the nodes, which is only valid as long as the DAGs are not modified.
+	That's why the matchers clear it at the start of each match.
+*/
+class NodeSimilarityMemo
+{
+	const DAG* m_pDag1;
+	const DAG* m_pDag2;
+	int m_nRows, m_nCols;
+	std::vector<double> m_values;  //!< Similarity of each pair of DFS indices, row after row. Negative if not computed
+
+public:
+	long nHits;                    //!< Similarities read from the memo instead of being recomputed
+	long nMisses;                  //!< Similarities computed
+
+	NodeSimilarityMemo() { Clear(); }
+
+	//! Forgets the DAGs, the values and the counters
+	void Clear();
+
+	//! Makes the memo refer to another pair of DAGs. Nothing is forgotten if the pair doesn't change.
+	void Reset(const DAG* pDag1, const DAG* pDag2);
+
+	const DAG* GetDAG1() const { return m_pDag1; }
+	const DAG* GetDAG2() const { return m_pDag2; }
+	int GetRowCount() const { return m_nRows; }
+	int GetColCount() const { return m_nCols; }
+
+	//! Cell of the nodes with DFS indices i and j, or NULL if there is none
+	double* Find(int i, int j)
+	{
+		return (i >= 0 && i < m_nRows && j >= 0 && j < m_nCols) ? &m_values[i * m_nCols + j] : NULL;
+	}
+
+	//! Cell of node v1 of the first DAG and node v2 of the second one, or NULL if there is none
+	double* Find(leda::node v1, leda::node v2);
+};
 
 /*!
 	Abstract class for measuring the attribute distance between
 	two nodes of two different DAGs.
+
+	Measurers whose node similarity only depends on the two nodes
+	(see MemoizesNodeSimilarities()) compute it through the memo,
+	so that each pair of nodes is compared at most once per match.
 */
 class SimilarityMeasurer
 {
+protected:
+	const MatchContext* m_pContext; //!< Context of the matcher that owns the measurer
+	mutable NodeSimilarityMemo m_memo;
+
+	//! Reads the similarity of v1 and v2 from the memo, or computes it with ComputeNodePairSimilarity()
+	double MemoizedNodeSimilarity(leda::node v1, leda::node v2) const;
+
+	//! Similarity stored by the memo. Must only depend on v1 and v2. See MemoizesNodeSimilarities().
+	virtual double ComputeNodePairSimilarity(leda::node v1, leda::node v2) const { return 0; }
+
+	//! Makes the memo refer to the pair of DAGs being compared
+	void InitMemo(const DAG* pDag1, const DAG* pDag2) { m_memo.Reset(pDag1, pDag2); }
+
+	struct MemoPlan;
+	static void FillMemoRows(MemoPlan* pPlan);
+
 public:
+	SimilarityMeasurer() { m_pContext = NULL; }
 	virtual ~SimilarityMeasurer() {}
 
+	void SetContext(const MatchContext* pContext) { m_pContext = pContext; }
+
+	//! The context of the measurer, or the current one if it has none
+	const MatchContext& Context() const;
+
 	virtual void Init(const DAG* pDag1, const DAG* pDag2) = 0;
 
+	//! True if the measurer computes its node similarities through the memo
+	virtual bool MemoizesNodeSimilarities() const { return false; }
+
+	//! True if the similarity of two nodes of different types (see DAG::NodeType()) is always zero
+	virtual bool ComparesOnlySameTypes() const { return false; }
+
+	//! Forgets the memoized node similarities and resets the counters of the memo
+	void ClearMemo() { m_memo.Clear(); }
+
+	const NodeSimilarityMemo& GetMemo() const { return m_memo; }
+
+	//! Fills the memo of the current pair of DAGs using nThreads threads
+	void ComputeAllNodeSimilarities(int nThreads);
+
 	virtual double ComputeNodeSimilarity(leda::node v1, leda::node v2,
 		NodeMatchInfoPtr ptrMatchInfo) const = 0;
 
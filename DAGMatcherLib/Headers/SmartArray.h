@@ -46,6 +46,14 @@
 	a chance that a function is modifying the contents of a shared array. Therefore,
 	whenever possible, the constant version of operator[]() must be called to avoid
 	unnecessary copies of the array.
+
+	The reference count is atomic (see dml::RefCount), so copies of the same
+	array can be used from different threads. A copy is made before any thread
+	modifies a shared array, so each thread only ever writes to its own data.
+
+	AddTail() grows the array geometrically, by at least the grow factor, so
+	appending n elements one at a time costs O(n). Use Reserve() when the final
+	size is known. Arrays of trivially assignable types are copied with memcpy.
 */
 template<class T> class SmartArray
 {
@@ -55,15 +63,53 @@ template<class T> class SmartArray
 		int nSize;
 		int nRealSize;
 		int nGrowFactor;
-		int nLinks;
+		dml::RefCount links;
 
-		DATAREF(int nGF)  { nLinks = 1; nGrowFactor = nGF; ASSERT(nGF > 0); }
+		DATAREF(int nGF) : pData(NULL), nLastItem(0), nSize(0), nRealSize(0)
+		{
+			nGrowFactor = nGF;
+			ASSERT(nGF > 0);
+		}
 	};
 
 	DATAREF* ptr;
 
 private:
 	void Unlink();
+	void Reallocate(int nCapacity);
+
+	//! Capacity after the next growth of the array
+	int NextCapacity() const
+	{
+		return MAX(ptr->nRealSize + ptr->nGrowFactor, 2 * ptr->nRealSize);
+	}
+
+	static void CopyItems(T* pDst, const T* pSrc, int n, boost::true_type /*trivial*/)
+	{
+		if (n > 0)
+			memcpy(pDst, pSrc, n * sizeof(T));
+	}
+
+	static void CopyItems(T* pDst, const T* pSrc, int n, boost::false_type /*trivial*/)
+	{
+		for (int i = 0; i < n; i++)
+			pDst[i] = pSrc[i];
+	}
+
+	static void CopyItems(T* pDst, const T* pSrc, int n)
+	{
+		CopyItems(pDst, pSrc, n, boost::has_trivial_assign<T>());
+	}
+
+	//! Drops a reference to 'p' and destroys it if it was the last one
+	static void Release(DATAREF* p)
+	{
+		if (p->links.Release())
+		{
+			delete[] p->pData;
+			delete p;
+		}
+	}
 
 protected:
 	const T* GetData() const { return ptr->pData; }
@@ -81,15 +127,17 @@ public:
 
 	SmartArray(const SmartArray& x)	{
 		ptr = x.ptr;
-		ptr->nLinks++;
+		ptr->links.AddRef();
+	}
+
+	//! Takes the data of 'x', which is left empty
+	SmartArray(SmartArray&& x) {
+		ptr = x.ptr;
+		x.ptr = new DATAREF(ptr->nGrowFactor);
 	}
 
 	~SmartArray() {
-		if (--ptr->nLinks == 0)
-		{
-			delete[] ptr->pData;
-			delete ptr;
-		}
+		Release(ptr);
 	}
 
 	const T& operator[](int i) const {
@@ -246,7 +294,7 @@ public:
 	{
 		ASSERT(nGrowFactor > 0);
 
-		if (ptr->nLinks > 1)
+		if (ptr->links.IsShared())
 			Unlink();
 
 		ptr->nGrowFactor = nGrowFactor;
@@ -259,7 +307,7 @@ public:
 
 		ASSERT(i >= 0 && i < ptr->nSize);
 
-		if (ptr->nLinks > 1)
+		if (ptr->links.IsShared())
 			Unlink();
 
 		return ptr->pData[i];
@@ -269,23 +317,25 @@ public:
 	const T& GetHead() const { return operator[](0); }
 
 	SmartArray& operator=(const SmartArray& rhs) {
-		rhs.ptr->nLinks++;	// protect against 'x = x'
+		rhs.ptr->links.AddRef();	// protect against 'x = x'
 
-		if (--ptr->nLinks == 0)
-		{
-			delete[] ptr->pData;
-			delete ptr;
-		}
+		Release(ptr);
 
 		ptr = rhs.ptr;
 		return *this;
 	}
 
+	//! Swaps the data with 'rhs', which releases ours when it is destroyed
+	SmartArray& operator=(SmartArray&& rhs) {
+		std::swap(ptr, rhs.ptr);
+		return *this;
+	}
+
 	void Sort(int (*Compare)(const void *elem1, const void *elem2 ) )
 	{
 		if (GetSize() > 0)
 		{
-		  if (ptr->nLinks > 1)
+		  if (ptr->links.IsShared())
 			Unlink();
 
 		  qsort(ptr->pData, ptr->nSize, sizeof(T), Compare);
@@ -303,7 +353,11 @@ public:
 	//! the size of the array.
 	void Add(const T& x) {
 		ASSERT(ptr->nLastItem < ptr->nSize);
-		ptr->pData[ptr->nLastItem++] = x; // operator[]'ll handle the reference problem.
+
+		if (ptr->links.IsShared())
+			Unlink();
+
+		ptr->pData[ptr->nLastItem++] = x;
 	}
 
 	//! Adds an element after the last element. It increases
@@ -312,28 +366,22 @@ public:
 	{
 		if (ptr->nLastItem >= ptr->nSize)
 		{
-			if (ptr->nLastItem < ptr->nRealSize)
+			ASSERT(ptr->nLastItem == ptr->nSize);
+
+			if (ptr->nSize >= ptr->nRealSize)
 			{
-				if (ptr->nLinks > 1)
-					Unlink();
+				const T item(x); // x may be an element of this array
 
+				Reserve(NextCapacity());
 				ptr->nSize++;
+				Add(item);
+				return;
 			}
-			else
-			{
-				ASSERT(ptr->nSize == ptr->nRealSize);
-
-				const SmartArray<T> a(*this);
-
-				Resize(ptr->nRealSize + ptr->nGrowFactor);
-				//memcpy(ptr->pData, a.GetData(), a.GetSize() * sizeof(T));
 
-				for (int i = 0; i < a.GetSize(); i++)
-					ptr->pData[i] = a.ptr->pData[i];
+			if (ptr->links.IsShared())
+				Reallocate(ptr->nRealSize);
 
-				ptr->nSize = a.GetSize() + 1;
-				ptr->nLastItem = a.GetSize();
-			}
+			ptr->nSize++;
 		}
 
 		Add(x);
@@ -341,19 +389,31 @@ public:
 
 	void AddTail(const SmartArray<T>& tail)
 	{
-		const int nGF = GetGrowFactor();
-		const int nFreeSlots = ptr->nRealSize - ptr->nSize;
+		const SmartArray<T> t(tail); // in case 'tail' is this array
+		const int nNewSize = ptr->nSize + t.GetSize();
 
-		if (tail.GetSize() > nFreeSlots + nGF)
-			SetGrowFactor(tail.GetSize() - nFreeSlots);
+		if (nNewSize > ptr->nRealSize)
+			Reserve(MAX(nNewSize, NextCapacity()));
 
-		for (int i = 0; i < tail.GetSize(); i++)
-			AddTail(tail[i]);
+		for (int i = 0; i < t.GetSize(); i++)
+			AddTail(t[i]);
+	}
 
-		// Restore original growth factor
-		SetGrowFactor(nGF);
+	/*!
+		Makes room for at least nCapacity elements without changing the
+		size of the array, so that the following calls to AddTail() don't
+		need to reallocate it.
+	*/
+	void Reserve(int nCapacity)
+	{
+		if (nCapacity > ptr->nRealSize)
+			Reallocate(nCapacity);
+		else if (ptr->links.IsShared())
+			Reallocate(ptr->nRealSize);
 	}
 
+	int GetCapacity() const { return ptr->nRealSize; }
+
 	void AddHead(const SmartArray<T>& head)
 	{
 		SmartArray<T> aux(head);
@@ -367,12 +427,14 @@ public:
 	{
 		ASSERT(size >= 0);
 
-		if (size != ptr->nSize || ptr->nLinks > 1)
+		if (size != ptr->nSize || ptr->links.IsShared())
 		{
-			if (ptr->nLinks > 1)
+			if (ptr->links.IsShared())
 			{
-				ptr->nLinks--;
-				ptr = new DATAREF(ptr->nGrowFactor);
+				DATAREF* op = ptr;
+
+				ptr = new DATAREF(op->nGrowFactor);
+				Release(op);
 			}
 			else if (ptr->pData)
 				delete[] ptr->pData;
@@ -441,25 +503,35 @@ public:
 	friend std::istream& operator>>(std::istream& is, SmartArray<T>& x) { return x.Read(is); }
 };
 
+//! Gives this array its own copy of the data
 template<class T> void SmartArray<T>::Unlink()
 {
-	ASSERT(ptr->nLinks > 1);
+	Reallocate(ptr->nSize);
+
+	//WARNING(true, "possible not desired copy of data");
+}
+
+/*!
+	Moves the elements to a new block of nCapacity elements owned by
+	this array only. The reference to the old block is dropped after
+	the copy is made, since its other owners may release theirs at the
+	same time.
+*/
+template<class T> void SmartArray<T>::Reallocate(int nCapacity)
+{
+	ASSERT(nCapacity >= ptr->nSize);
 
 	DATAREF* op = ptr;
 	ptr = new DATAREF(op->nGrowFactor);
 
-	ptr->pData = new T[op->nSize];
+	ptr->pData = (nCapacity > 0) ? new T[nCapacity] : NULL;
 	ptr->nLastItem = op->nLastItem;
 	ptr->nSize = op->nSize;
-	ptr->nRealSize = op->nSize;
-
-	//memcpy(ptr->pData, op->pData, op->nSize * sizeof(T));
-	for (int i = 0; i < op->nSize; i++)
-		ptr->pData[i] = op->pData[i];
+	ptr->nRealSize = nCapacity;
 
-	op->nLinks--;
+	CopyItems(ptr->pData, op->pData, op->nSize);
 
-	//WARNING(true, "possible not desired copy of data");
+	Release(op);
 }
 
 #endif //_SMART_ARRAY_H_
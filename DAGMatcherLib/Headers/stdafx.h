@@ -43,7 +43,6 @@
 
 #include <iostream>
 #include <iomanip>
-#include <io.h>
 #include <string>
 #include <map>
 #include <list>
@@ -52,16 +51,26 @@
 #include <stdexcept>
 #include <sstream>
 #include <fstream>
-#include <direct.h>
 #include <cerrno>
 #include <memory>
 #include <random>
 #include <stack>
 #include <functional>
+#include <algorithm>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/type_traits/has_trivial_assign.hpp>
+#ifdef WIN32
+#include <io.h>
+#include <direct.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
-#include <process.h>
 #include <math.h>
 #include <fcntl.h> // for open()
 #include <cstdio> // for perror()
@@ -78,6 +87,9 @@
 
 /* ================= LEDA HEADERS ================ */
 
+// Define DML_NO_LEDA to build with the in-house graphs of GraphCore.h instead of LEDA.
+// The views (DAGView, VisualDAG, PlotView, ShockGraphView, BoneGraphView) are left out.
+#ifndef DML_NO_LEDA
 #include <LEDA/internal/PREAMBLE.h>
 #include <LEDA/core/list.h>
 #include <LEDA/core/string.h>
@@ -93,6 +105,7 @@
 #include <LEDA/graphics/color.h>
 #include <LEDA/graphics/graphwin.h>
 #include <LEDA/graphics/window.h>
+#endif
 
 #include "LEDA_issues.h"
 #include "LEDA_utils.h"
@@ -102,32 +115,32 @@
 
 #include "constants.h"
 #include "StandardException.h"
-#include "SDK\graphDB.h"
-#include "SDK\ObjectClass.h"
-#include "SDK\GraphClass.h"
-#include "SDK\Graph.h"
-#include "SDK\Node.h"
-#include "SDK\Edge.h"
-#include "SDK\Point.h"
+#include "SDK/graphDB.h"
+#include "SDK/ObjectClass.h"
+#include "SDK/GraphClass.h"
+#include "SDK/Graph.h"
+#include "SDK/Node.h"
+#include "SDK/Edge.h"
+#include "SDK/Point.h"
 
 /* ================ EXTERNAL LIBS ================ */
 
 #include "constants.h"
 #include "CLogger.h"
 
-#include "FluxSkeleton\include\Point.h"
-#include "FluxSkeleton\include\DDSGraphProject.h"
-#include "FluxSkeleton\include\sg.h"
+#include "FluxSkeleton/include/Point.h"
+#include "FluxSkeleton/include/DDSGraphProject.h"
+#include "FluxSkeleton/include/sg.h"
 
 #include "ann_1.1/include/ANN/ANN.h"
 
-#include "AFMMSkeleton\include\field.h"
+#include "AFMMSkeleton/include/field.h"
 
-#include "tools\connected.h"
+#include "tools/connected.h"
 
-#include "Newmat\newmat.h"
-#include "Newmat\newmatap.h"
-#include "Newmat\newmatio.h"
+#include "Newmat/newmat.h"
+#include "Newmat/newmatap.h"
+#include "Newmat/newmatio.h"
 
 //#include "CImg/CImg.h"
 
@@ -144,10 +157,14 @@
 #include "HelperFunctions.h"
 #include "Exceptions.h"
 
+#include "RefCount.h"
 #include "SmartArray.h"
 #include "SmartMatrix.h"
+#include "BitMatrix.h"
 #include "SmartPtr.h"
 #include "SharedPtr.h"
+#include "MemoryArena.h"
+#include "SimdKernels.h"
 
 #include <DDSGraphProject.h>
 #include "DDSGraphUtils.h"
@@ -168,6 +185,8 @@
 
 #include "KDTree.h"
 
+#include "AssignmentSolver.h"
+#include "BeliefPropMWBGM.h"
 #include "BipartiteGraph.h"
 #include "BipartiteNodeGraph.h"
 
@@ -195,34 +214,44 @@
 
 #include "DAGNode.h"
 #include "DAGEdge.h"
+#ifndef DML_NO_LEDA
 #include "DAGView.h"
 #include "VisualDAG.h"
+#endif
 
 //#include "Emd.h"
+#ifndef DML_NO_LEDA
 #include "PlotView.h"
+#endif
+
+#include "ModelFit.h"
 
 #include "ShockPoint.h"
 #include "SGNode.h"
 #include "ShockGraph.h"
+#ifndef DML_NO_LEDA
 #include "ShockGraphView.h"
+#endif
 
 #include "BGElement.h"
 #include "BGNode.h"
 #include "BGEdge.h"
 #include "BoneGraphConstructor.h"
 #include "BoneGraph.h"
+#ifndef DML_NO_LEDA
 #include "BoneGraphView.h"
+#endif
 
 #include "GGNode.h"
 #include "GestureGraph.h"
 
-#include "ModelFit.h"
-
 #include "DAGSearchDatabase.h"
 #include "DAGDBFile.h"
 #include "DAGDatabase.h"
 #include "DAGMatcher.h"
+#include "MatchContext.h"
 
+#include "FrozenDAG.h"
 #include "DAG.h"
 #include "NodePairInfo.h" // needed by FillNodeMap
 #include "NodeMatchInfo.h"
@@ -238,6 +267,9 @@
 #include "DAGMatcherAdaptive.h"
 #include "SGSimilarityMeasurer.h"
 #include "BGSimilarityMeasurer.h"
+#include "MatchBounds.h"
+#include "MatchEngine.h"
+#include "AllPairsMatcher.h"
 
 // ============================= STOP ADDING LIBS ==============================
 
@@ -0,0 +1,656 @@
+/* ************* Begin file AllPairsMatcher.cpp ***************************************/
+/*
+** 2015 October 17
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file AllPairsMatcher.cpp
+*	\brief AllPairsMatcher source file.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+#include <exception>
+
+using namespace dml;
+
+/////////////////////////////////////////////////////////////////////////////
+// Checkpoint file
+//
+// A header (magic, model count, fingerprint of the models, fingerprint of
+// the matching parameters, tile size, symmetry, shard and shard count)
+// followed by one record per finished
+// tile: its index, its number of values, the values and a checksum of the
+// record. A record cut by an interrupted run fails the checksum and is
+// overwritten by the next one.
+
+static const char s_szCheckpointMagic[8] = "DMLAPM2";
+
+//! FNV-1a hash of the bytes, continuing from h
+static unsigned int HashBytes(const void* pData, size_t nBytes, unsigned int h = 2166136261U)
+{
+	const unsigned char* p = (const unsigned char*) pData;
+
+	for (size_t i = 0; i < nBytes; i++)
+		h = (h ^ p[i]) * 16777619U;
+
+	return h;
+}
+
+template <typename T> static unsigned int HashValue(const T& val, unsigned int h)
+{
+	return HashBytes(&val, sizeof(val), h);
+}
+
+//! Hashes the characters and the terminating null, so that "ab", "c" differs from "a", "bc"
+static unsigned int HashString(const char* sz, unsigned int h)
+{
+	return HashBytes(sz, strlen(sz) + 1, h);
+}
+
+template <typename T> static void WriteValue(std::ostream& os, const T& val)
+{
+	os.write((const char*) &val, sizeof(val));
+}
+
+template <typename T> static bool ReadValue(std::istream& is, T* pVal)
+{
+	return is.read((char*) pVal, sizeof(*pVal)).gcount() == sizeof(*pVal);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// MatlabTileWriter class implementation
+
+void MatlabTileWriter::WriteTile(const MatrixTile& tile, bool bSymmetric)
+{
+	std::ostringstream block;
+	int i, j;
+
+	// MATLAB indices start at one
+	block << m_strVarName << "(" << tile.nRow0 + 1 << ":" << tile.nRow0 + tile.nRows
+		<< ", " << tile.nCol0 + 1 << ":" << tile.nCol0 + tile.nCols << ")";
+
+	m_os << block.str() << " = [";
+
+	for (i = 0; i < tile.nRows; i++)
+	{
+		m_os << ((i > 0) ? ";\n\t" : "\n\t");
+
+		for (j = 0; j < tile.nCols; j++)
+			m_os << ((j > 0) ? " " : "") << tile.values[i * tile.nCols + j];
+	}
+
+	m_os << "];\n";
+
+	if (bSymmetric && tile.nRow0 != tile.nCol0)
+	{
+		m_os << m_strVarName << "(" << tile.nCol0 + 1 << ":" << tile.nCol0 + tile.nCols
+			<< ", " << tile.nRow0 + 1 << ":" << tile.nRow0 + tile.nRows << ") = "
+			<< block.str() << "';\n";
+	}
+
+	m_os.flush();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// AllPairsMatcher class implementation
+
+struct AllPairsMatcher::RunPlan
+{
+	const AllPairsMatcher* pMatcher;
+	int nThreads;
+	std::vector<MatrixTile> tiles;
+	std::vector<char> done;          //!< Tiles read from the checkpoint
+
+	// Work distribution among the threads
+	boost::mutex mutexWork;
+	size_t nNext;
+	bool bFailed;
+	std::exception_ptr error;        //!< First exception thrown by a thread, of any type
+
+	//! Copying a DAG may attach node arrays to it, so the copies are made one at a time
+	boost::mutex mutexCopy;
+
+	// Output of the finished tiles
+	boost::mutex mutexOutput;
+	std::fstream* pCheckpoint;
+	SmartMatrix<double>* pMatrix;
+	Stats stats;
+
+	/*!
+		Keeps the exception being handled, if it's the first one, and makes
+		the other threads stop. Run() rethrows it once they have. Must be
+		called from a catch block.
+	*/
+	void Fail(long nMatches)
+	{
+		boost::mutex::scoped_lock lock(mutexWork);
+
+		if (!bFailed)
+		{
+			bFailed = true;
+			error = std::current_exception();
+		}
+
+		// Let the other threads finish
+		nNext = tiles.size();
+		stats.nMatches += nMatches;
+	}
+};
+
+AllPairsMatcher::AllPairsMatcher()
+	: m_params(MatchContext::Current().GetParams())
+{
+	m_nThreads = -1;
+	m_nTileSize = 32;
+	m_nShard = 0;
+	m_nShardCount = 1;
+	m_bSymmetric = true;
+	m_pSink = NULL;
+}
+
+AllPairsMatcher::AllPairsMatcher(const DAGMatcher::MatchParams& params)
+	: m_params(params)
+{
+	m_nThreads = -1;
+	m_nTileSize = 32;
+	m_nShard = 0;
+	m_nShardCount = 1;
+	m_bSymmetric = true;
+	m_pSink = NULL;
+}
+
+void AllPairsMatcher::SetShard(int nShard, int nShardCount)
+{
+	ASSERT(nShardCount > 0 && nShard >= 0 && nShard < nShardCount);
+
+	m_nShard = nShard;
+	m_nShardCount = nShardCount;
+}
+
+void AllPairsMatcher::AddModel(DAGPtr ptrModel)
+{
+	ASSERT(!ptrModel.IsNull());
+
+	m_models.push_back(ptrModel);
+}
+
+void AllPairsMatcher::GetShardTiles(std::vector<MatrixTile>* pTiles) const
+{
+	const int N = (int) m_models.size();
+	MatrixTile tile;
+	int nTile = 0;
+
+	pTiles->clear();
+	tile.bResumed = false;
+
+	for (int r = 0; r < N; r += m_nTileSize)
+	{
+		for (int c = m_bSymmetric ? r : 0; c < N; c += m_nTileSize, nTile++)
+		{
+			if (nTile % m_nShardCount != m_nShard)
+				continue;
+
+			tile.nTile = nTile;
+			tile.nRow0 = r;
+			tile.nCol0 = c;
+			tile.nRows = MIN(m_nTileSize, N - r);
+			tile.nCols = MIN(m_nTileSize, N - c);
+
+			pTiles->push_back(tile);
+		}
+	}
+}
+
+/*!
+	The parameters are hashed one by one, since the padding bytes of
+	MatchParams are not initialized. nNodeSimThreads and nExtreme are left
+	out: they change how the similarities are computed, not their values,
+	so a run can be resumed with another number of threads.
+*/
+unsigned int AllPairsMatcher::GetParamsFingerprint() const
+{
+	const DAGMatcher::MatchParams& p = m_params;
+	unsigned int h = HashBytes(NULL, 0);
+
+	h = HashValue(p.nMatchingAlgorithm, h);
+	h = HashValue(p.nNodeSimilarityFunction, h);
+	h = HashValue(p.dTSVSimWeight, h);
+	h = HashValue(p.dSimilMassWeight, h);
+	h = HashValue(p.dRelMassWeight, h);
+	h = HashValue(p.dDiffAttachPosWeight, h);
+
+	h = HashValue(p.dBreakAncestorRelPen, h);
+	h = HashValue(p.dBreakDescendantRelPen, h);
+	h = HashValue(p.dBreakSiblingRelPen, h);
+
+	h = HashValue(p.dAncestorPathSigma, h);
+	h = HashValue(p.dDescendantPathSigma, h);
+	h = HashValue(p.dSiblingPathSigma, h);
+
+	h = HashValue(p.nCompareNodes, h);
+	h = HashValue(p.nCompareEdges, h);
+	h = HashValue(p.nDisableNodeSkipping, h);
+	h = HashValue(p.dCertaintyParam, h);
+	h = HashValue(p.nNodeAssignSortType, h);
+	h = HashValue(p.nPreserveAncestorRel, h);
+	h = HashValue(p.nUseMWBMHeuristic, h);
+
+	h = HashValue(p.nMaxNumSolSets, h);
+	h = HashValue(p.nMaxSolSetsPerIter, h);
+	h = HashValue(p.nMaxExpandedSolSets, h);
+
+	h = HashValue(p.dBGWrongSidePen, h);
+	h = HashValue(p.dBGPositionSigma, h);
+	h = HashValue(p.dSaliencyParam, h);
+	h = HashValue(p.dSlopeSigma, h);
+
+	h = HashValue(p.nUseNewVoteWeightFunc, h);
+	h = HashValue(p.nUseMOOVC, h);
+
+	return h;
+}
+
+/*!
+	Each model is identified by its database key (its DAG id, object name
+	and view numbers) and by the attributes of its nodes and edges that the
+	matchers read, so that a checkpoint isn't resumed over models that were
+	edited or rebuilt with other parameters, even if their sizes are equal.
+*/
+unsigned int AllPairsMatcher::GetModelsFingerprint() const
+{
+	unsigned int h = HashBytes(NULL, 0);
+	leda::node v;
+	leda::edge e;
+	int nView0, nView1;
+
+	for (size_t i = 0; i < m_models.size(); i++)
+	{
+		const DAG& dag = *m_models[i];
+
+		dag.GetViewNumbers(&nView0, &nView1);
+
+		h = HashValue(dag.GetDAGId(), h);
+		h = HashString(dag.GetObjName().c_str(), h);
+		h = HashValue(nView0, h);
+		h = HashValue(nView1, h);
+		h = HashValue(dag.GetNodeCount(), h);
+		h = HashValue(dag.GetCumulativeMass(), h);
+
+		forall_nodes(v, dag)
+		{
+			h = HashString(dag.GetNodeLbl(v).c_str(), h);
+			h = HashValue(dag.GetNodeMass(v), h);
+			h = HashValue(dag.GetNodeTSVNorm(v), h);
+			h = HashValue(dag.GetNodeCost(v), h);
+		}
+
+		forall_edges(e, dag)
+		{
+			h = HashValue(dag.GetNodeIndex(source(e)), h);
+			h = HashValue(dag.GetNodeIndex(target(e)), h);
+			h = HashValue(dag.GetEdgeWeight(e), h);
+		}
+	}
+
+	return h;
+}
+
+void AllPairsMatcher::WriteCheckpointHeader(std::ostream& os) const
+{
+	os.write(s_szCheckpointMagic, sizeof(s_szCheckpointMagic));
+
+	WriteValue(os, (int) m_models.size());
+	WriteValue(os, GetModelsFingerprint());
+	WriteValue(os, GetParamsFingerprint());
+	WriteValue(os, m_nTileSize);
+	WriteValue(os, (int) m_bSymmetric);
+	WriteValue(os, m_nShard);
+	WriteValue(os, m_nShardCount);
+}
+
+/*!
+	Reads the tiles saved by a previous run and leaves the file ready to
+	append the next ones. The tiles read are stored as if they had just
+	been computed.
+*/
+void AllPairsMatcher::ReadCheckpoint(std::fstream& fs, RunPlan* pPlan) const
+{
+	std::ostringstream expected;
+	std::vector<char> header(sizeof(s_szCheckpointMagic) + 7 * sizeof(int));
+
+	WriteCheckpointHeader(expected);
+
+	fs.seekg(0, std::ios_base::end);
+
+	// A new file only needs the header
+	if (fs.tellg() == std::streampos(0))
+	{
+		fs.clear();
+		fs.seekp(0);
+		WriteCheckpointHeader(fs);
+		fs.flush();
+		return;
+	}
+
+	fs.seekg(0);
+
+	if (fs.read(&header[0], header.size()).gcount() != (std::streamsize) header.size() ||
+		std::string(header.begin(), header.end()) != expected.str())
+	{
+		THROW_EXCEPTION("The checkpoint file belongs to other models, matching parameters, tile size or shard.");
+	}
+
+	// Index of each tile in the shard
+	std::map<int, int> tileIndices;
+	std::streampos endPos = fs.tellg();
+	size_t k;
+
+	for (k = 0; k < pPlan->tiles.size(); k++)
+		tileIndices[pPlan->tiles[k].nTile] = (int) k;
+
+	for (;;)
+	{
+		int nTile, nValues;
+		unsigned int checksum;
+
+		if (!ReadValue(fs, &nTile) || !ReadValue(fs, &nValues))
+			break;
+
+		std::map<int, int>::const_iterator it = tileIndices.find(nTile);
+
+		if (it == tileIndices.end())
+			break;
+
+		MatrixTile& tile = pPlan->tiles[it->second];
+
+		if (nValues != tile.nRows * tile.nCols)
+			break;
+
+		tile.values.resize(nValues);
+
+		if (fs.read((char*) &tile.values[0], nValues * sizeof(double)).gcount() !=
+			(std::streamsize) (nValues * sizeof(double)) || !ReadValue(fs, &checksum))
+		{
+			break;
+		}
+
+		unsigned int h = HashBytes(&nTile, sizeof(nTile));
+
+		h = HashBytes(&nValues, sizeof(nValues), h);
+		h = HashBytes(&tile.values[0], nValues * sizeof(double), h);
+
+		if (h != checksum)
+			break;
+
+		endPos = fs.tellg();
+
+		if (!pPlan->done[it->second])
+		{
+			pPlan->done[it->second] = 1;
+			tile.bResumed = true;
+
+			StoreTile(pPlan, tile);
+		}
+
+		std::vector<double>().swap(tile.values);
+	}
+
+	fs.clear();
+	fs.seekp(endPos);
+}
+
+/*!
+	Saves the tile to the checkpoint, the matrix and the sink. Tiles that
+	come from the checkpoint aren't saved to it again.
+*/
+void AllPairsMatcher::StoreTile(RunPlan* pPlan, const MatrixTile& tile)
+{
+	const AllPairsMatcher& matcher = *pPlan->pMatcher;
+	boost::mutex::scoped_lock lock(pPlan->mutexOutput);
+	int i, j;
+
+	if (pPlan->pCheckpoint && !tile.bResumed)
+	{
+		std::fstream& fs = *pPlan->pCheckpoint;
+		const int nValues = (int) tile.values.size();
+		unsigned int h = HashBytes(&tile.nTile, sizeof(tile.nTile));
+
+		h = HashBytes(&nValues, sizeof(nValues), h);
+		h = HashBytes(&tile.values[0], nValues * sizeof(double), h);
+
+		WriteValue(fs, tile.nTile);
+		WriteValue(fs, nValues);
+		fs.write((const char*) &tile.values[0], nValues * sizeof(double));
+		WriteValue(fs, h);
+
+		// The tile must be on disk before anyone relies on it
+		fs.flush();
+
+		if (!fs)
+			THROW_EXCEPTION("Cannot write to the checkpoint file.");
+	}
+
+	if (pPlan->pMatrix)
+	{
+		SmartMatrix<double>& S = *pPlan->pMatrix;
+
+		for (i = 0; i < tile.nRows; i++)
+		{
+			for (j = 0; j < tile.nCols; j++)
+			{
+				S[tile.nRow0 + i][tile.nCol0 + j] = tile.values[i * tile.nCols + j];
+
+				if (matcher.m_bSymmetric)
+					S[tile.nCol0 + j][tile.nRow0 + i] = tile.values[i * tile.nCols + j];
+			}
+		}
+	}
+
+	if (matcher.m_pSink)
+		matcher.m_pSink->WriteTile(tile, matcher.m_bSymmetric);
+
+	if (tile.bResumed)
+		pPlan->stats.nTilesResumed++;
+	else
+		pPlan->stats.nTilesComputed++;
+}
+
+//! Makes a copy of the DAG, frozen if the DAG is, owned by *pPtrCopy
+static const DAG* CopyDAG(const DAG& dag, DAGPtr* pPtrCopy)
+{
+	DAG* pCopy = dag.CreateObject();
+
+	*pPtrCopy = pCopy;
+	*pCopy = dag;
+
+	if (dag.IsFrozen())
+		pCopy->Freeze();
+
+	return pCopy;
+}
+
+/*!
+	Thread body of Run(). Each thread takes the next tile that isn't in the
+	checkpoint, copies its models and matches them within its own context.
+*/
+void AllPairsMatcher::ComputeTiles(RunPlan* pPlan)
+{
+	const AllPairsMatcher& matcher = *pPlan->pMatcher;
+	DAGMatcher::MatchParams params = matcher.m_params;
+
+	// The matches already keep all the cores busy
+	if (pPlan->nThreads > 1 && params.nNodeSimThreads != 0)
+		params.nNodeSimThreads = 1;
+
+	MatchContext context(params);
+	MatchContext::Scope scope(context);
+
+	std::vector<DAGPtr> rowCopies, colCopies;
+	std::vector<const DAG*> rows, cols;
+	long nMatches = 0;
+	int i, j;
+
+	for (;;)
+	{
+		MatrixTile* pTile;
+
+		{
+			boost::mutex::scoped_lock lock(pPlan->mutexWork);
+
+			while (pPlan->nNext < pPlan->tiles.size() && pPlan->done[pPlan->nNext])
+				pPlan->nNext++;
+
+			if (pPlan->nNext >= pPlan->tiles.size())
+			{
+				pPlan->stats.nMatches += nMatches;
+				return;
+			}
+
+			pTile = &pPlan->tiles[pPlan->nNext++];
+		}
+
+		MatrixTile& tile = *pTile;
+		const bool bDiagonal = matcher.m_bSymmetric && tile.nRow0 == tile.nCol0;
+
+		try
+		{
+			rows.resize(tile.nRows);
+			cols.resize(tile.nCols);
+
+			// The models of other tiles are matched by other threads at the same time
+			if (pPlan->nThreads > 1)
+			{
+				boost::mutex::scoped_lock lock(pPlan->mutexCopy);
+
+				rowCopies.resize(tile.nRows);
+				colCopies.resize(bDiagonal ? 0 : tile.nCols);
+
+				for (i = 0; i < tile.nRows; i++)
+					rows[i] = CopyDAG(*matcher.m_models[tile.nRow0 + i], &rowCopies[i]);
+
+				for (j = 0; j < tile.nCols; j++)
+					cols[j] = bDiagonal ? rows[j] : CopyDAG(*matcher.m_models[tile.nCol0 + j], &colCopies[j]);
+			}
+			else
+			{
+				for (i = 0; i < tile.nRows; i++)
+					rows[i] = &*matcher.m_models[tile.nRow0 + i];
+
+				for (j = 0; j < tile.nCols; j++)
+					cols[j] = &*matcher.m_models[tile.nCol0 + j];
+			}
+
+			tile.values.resize(tile.nRows * tile.nCols);
+
+			for (i = 0; i < tile.nRows; i++)
+			{
+				// Below the diagonal, the transposed pair was already matched
+				for (j = bDiagonal ? i : 0; j < tile.nCols; j++)
+				{
+					tile.values[i * tile.nCols + j] = rows[i]->Similarity(*cols[j]);
+					nMatches++;
+				}
+
+				if (bDiagonal)
+					for (j = 0; j < i; j++)
+						tile.values[i * tile.nCols + j] = tile.values[j * tile.nCols + i];
+			}
+
+			StoreTile(pPlan, tile);
+		}
+		catch (...)
+		{
+			// Not only ExceptionInfo: anything escaping the thread would terminate the program
+			pPlan->Fail(nMatches);
+			return;
+		}
+
+		// The values are in the checkpoint, the matrix or the sink by now
+		std::vector<double>().swap(tile.values);
+	}
+}
+
+int AllPairsMatcher::Run(SmartMatrix<double>* pMatrix /*= NULL*/)
+{
+	const int N = (int) m_models.size();
+	std::fstream checkpoint;
+	RunPlan plan;
+
+	plan.pMatcher = this;
+	plan.nNext = 0;
+	plan.bFailed = false;
+	plan.pCheckpoint = NULL;
+	plan.pMatrix = pMatrix;
+
+	GetShardTiles(&plan.tiles);
+	plan.done.assign(plan.tiles.size(), 0);
+
+	// A matrix that is already N x N keeps the tiles of the other shards
+	if (pMatrix && (pMatrix->NRows() != N || pMatrix->NCols() != N))
+		pMatrix->Resize(N, N, true);
+
+	if (!m_strCheckpointFile.empty())
+	{
+		const std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out | std::ios_base::binary;
+
+		// Opening for reading and writing fails if the file doesn't exist yet
+		checkpoint.open(m_strCheckpointFile.c_str(), mode);
+
+		if (!checkpoint.is_open())
+			checkpoint.open(m_strCheckpointFile.c_str(), mode | std::ios_base::trunc);
+
+		if (!checkpoint.is_open())
+			THROW_EXCEPTION("Cannot open the checkpoint file.");
+
+		plan.pCheckpoint = &checkpoint;
+
+		ReadCheckpoint(checkpoint, &plan);
+
+		if (plan.stats.nTilesResumed > 0)
+		{
+			Logger::Log("Resumed " + to_string((long long) plan.stats.nTilesResumed) + " of "
+				+ to_string((long long) plan.tiles.size()) + " tiles from " + m_strCheckpointFile,
+				constants::LogCore);
+		}
+	}
+
+	const int nTilesLeft = (int) plan.tiles.size() - plan.stats.nTilesResumed;
+
+	plan.nThreads = (m_nThreads < 0) ? (int) boost::thread::hardware_concurrency() : m_nThreads;
+	plan.nThreads = MIN(plan.nThreads, nTilesLeft);
+
+	// The log written in debug mode isn't shared safely by the threads
+	if (DAG::IsDbgMode())
+		plan.nThreads = 1;
+
+	if (plan.nThreads <= 1)
+	{
+		ComputeTiles(&plan);
+	}
+	else
+	{
+		boost::thread_group threads;
+
+		for (int i = 0; i < plan.nThreads; i++)
+			threads.create_thread(boost::bind(&AllPairsMatcher::ComputeTiles, &plan));
+
+		threads.join_all();
+	}
+
+	m_stats = plan.stats;
+	m_stats.nTiles = (int) plan.tiles.size();
+
+	if (plan.bFailed)
+		std::rethrow_exception(plan.error);
+
+	return m_stats.nTiles;
+}
@@ -0,0 +1,381 @@
+/* ************* Begin file AssignmentSolver.cpp ***************************************/
+/*
+** 2015 October 12
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file AssignmentSolver.cpp
+*	\brief AssignmentSolver source file.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+
+#ifndef DML_NO_LEDA
+#ifdef USE_TEMPLATE_BASED_MWBM_FUNCTION
+#include <LEDA/graph/templates/mwb_matching.h>
+using namespace std; // Fixes an error in the next LEDA header scale_weights.h line 35
+#include <LEDA/graph/scale_weights.h>
+#else
+#include <LEDA/graph/mwb_matching.h>
+#endif
+#endif //DML_NO_LEDA
+
+#include <limits>
+
+using namespace dml;
+
+//! Makes room for index n - 1, filling the new slots with 'val'
+template <class T> static void Grow(std::vector<T>& a, int n, const T& val)
+{
+	if ((int) a.size() < n)
+		a.resize(n, val);
+}
+
+AssignmentSolver::AssignmentSolver()
+{
+	m_nRows = m_nCols = m_nSize = 0;
+}
+
+void AssignmentSolver::Init(int nRows, int nCols)
+{
+	m_nRows = nRows;
+	m_nCols = nCols;
+	m_nSize = MAX(nRows, nCols);
+
+	// assign() keeps the capacity, so this only allocates for bigger problems
+	m_cost.assign(m_nSize * m_nSize, 0.0);
+	m_edges.assign(m_nSize * m_nSize, (leda::edge) nil);
+	m_rowLabels.assign(m_nSize, -1);
+	m_colLabels.assign(m_nSize, -1);
+}
+
+void AssignmentSolver::Init(const leda::graph& G, const leda::list<leda::node>& A,
+	const leda::list<leda::node>& B, const leda::edge_array<double>& profits)
+{
+	leda::node v;
+	leda::edge e;
+	int i;
+
+	Init(A.size(), B.size());
+
+	m_nodeSlots.assign(G.max_node_index() + 1, -1);
+
+	i = 0;
+	forall(v, A)
+		m_nodeSlots[index(v)] = i++;
+
+	i = 0;
+	forall(v, B)
+		m_nodeSlots[index(v)] = i++;
+
+	forall_edges(e, G)
+	{
+		ASSERT(m_nodeSlots[index(source(e))] >= 0 && m_nodeSlots[index(target(e))] >= 0);
+
+		SetProfit(m_nodeSlots[index(source(e))], m_nodeSlots[index(target(e))], profits[e], e);
+	}
+}
+
+void AssignmentSolver::ClearWarmStart()
+{
+	m_lastPotentials.clear();
+	m_hasLastPotential.clear();
+	m_lastColOfRow.clear();
+	m_savedRowLabels.clear();
+	m_savedColLabels.clear();
+}
+
+/*!
+	Sets feasible dual variables, ie, reduced costs c[i][j] - u[i] - v[j] that
+	are all non-negative, and assigns the rows to the columns whose reduced
+	cost is zero, as long as no two rows take the same column.
+
+	With a warm start, the column potentials and the assignment come from the
+	last problem. Otherwise the potentials start at zero and each row tries
+	the column with its smallest cost.
+*/
+void AssignmentSolver::WarmStart()
+{
+	const int n = m_nSize;
+	int i, j, label;
+
+	m_u.assign(n, 0.0);
+	m_v.assign(n, 0.0);
+	m_rowToCol.assign(n, -1);
+	m_colToRow.assign(n, -1);
+
+	for (j = 0; j < n; j++)
+	{
+		label = m_colLabels[j];
+
+		if (label >= 0 && label < (int) m_hasLastPotential.size() && m_hasLastPotential[label])
+			m_v[j] = m_lastPotentials[label];
+	}
+
+	// The smallest reduced cost of each row is zero
+	double maxCost = 0;
+
+	for (i = 0; i < n; i++)
+	{
+		const double* row = &m_cost[i * n];
+		double minCost = row[0] - m_v[0];
+
+		for (j = 1; j < n; j++)
+			if (row[j] - m_v[j] < minCost)
+				minCost = row[j] - m_v[j];
+
+		m_u[i] = minCost;
+		maxCost = MAX(maxCost, fabs(minCost));
+	}
+
+	const double eps = 1e-12 * (1 + maxCost);
+
+	// Keep the assignments of the last problem that are still tight
+	for (j = 0; j < n; j++)
+	{
+		label = m_colLabels[j];
+
+		if (label >= 0)
+		{
+			Grow(m_colOfLabel, label + 1, -1);
+			m_colOfLabel[label] = j;
+		}
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		label = m_rowLabels[i];
+
+		if (label < 0 || label >= (int) m_lastColOfRow.size() || m_lastColOfRow[label] < 0)
+			continue;
+
+		label = m_lastColOfRow[label];
+		j = (label < (int) m_colOfLabel.size()) ? m_colOfLabel[label] : -1;
+
+		if (j >= 0 && m_colToRow[j] < 0 && m_cost[i * n + j] - m_u[i] - m_v[j] <= eps)
+		{
+			m_rowToCol[i] = j;
+			m_colToRow[j] = i;
+		}
+	}
+
+	for (j = 0; j < n; j++)
+		if (m_colLabels[j] >= 0)
+			m_colOfLabel[m_colLabels[j]] = -1;
+
+	// Give the other rows their tightest column if it's free
+	for (i = 0; i < n; i++)
+	{
+		if (m_rowToCol[i] >= 0)
+			continue;
+
+		const double* row = &m_cost[i * n];
+
+		for (j = 0; j < n; j++)
+		{
+			if (m_colToRow[j] < 0 && row[j] - m_u[i] - m_v[j] <= eps)
+			{
+				m_rowToCol[i] = j;
+				m_colToRow[j] = i;
+				break;
+			}
+		}
+	}
+}
+
+/*!
+	Assigns the free row f along the shortest path of reduced costs to a free
+	column (Dijkstra over the columns), and updates the dual variables so
+	that the reduced costs stay non-negative and zero on the assignment.
+*/
+void AssignmentSolver::Augment(int f)
+{
+	const int n = m_nSize;
+	const double inf = std::numeric_limits<double>::max();
+	double* dist = &m_dist[0];
+	int i, j, k, sink = -1, nScanned = 0;
+
+	for (j = 0; j < n; j++)
+	{
+		dist[j] = m_cost[f * n + j] - m_u[f] - m_v[j];
+		m_pred[j] = f;
+		m_isScanned[j] = 0;
+	}
+
+	double d = 0;
+
+	while (sink < 0)
+	{
+		// Closest column not reached yet
+		int jmin = -1;
+		d = inf;
+
+		for (j = 0; j < n; j++)
+		{
+			if (!m_isScanned[j] && dist[j] < d)
+			{
+				d = dist[j];
+				jmin = j;
+			}
+		}
+
+		ASSERT(jmin >= 0);
+
+		m_isScanned[jmin] = 1;
+		m_scanned[nScanned++] = jmin;
+
+		if (m_colToRow[jmin] < 0)
+		{
+			sink = jmin;
+			break;
+		}
+
+		// Continue the paths through the row assigned to the column
+		i = m_colToRow[jmin];
+
+		const double* row = &m_cost[i * n];
+		const double base = d - m_u[i];
+
+		for (j = 0; j < n; j++)
+		{
+			double dj = base + row[j] - m_v[j];
+
+			if (dj < dist[j] && !m_isScanned[j])
+			{
+				dist[j] = dj;
+				m_pred[j] = i;
+			}
+		}
+	}
+
+	// Update the potentials of the rows and columns in the tree of paths
+	for (k = 0; k < nScanned; k++)
+	{
+		j = m_scanned[k];
+
+		if (j != sink)
+			m_u[m_colToRow[j]] += d - dist[j];
+
+		m_v[j] += dist[j] - d;
+	}
+
+	m_u[f] += d;
+
+	// Flip the assignments along the path
+	for (j = sink; ; )
+	{
+		i = m_pred[j];
+		k = m_rowToCol[i];
+
+		m_colToRow[j] = i;
+		m_rowToCol[i] = j;
+
+		if (i == f)
+			break;
+
+		j = k;
+	}
+}
+
+//! Saves the column potentials and the assignment by label for the next warm start
+void AssignmentSolver::SaveState()
+{
+	size_t k;
+	int i, j;
+
+	for (k = 0; k < m_savedColLabels.size(); k++)
+		m_hasLastPotential[m_savedColLabels[k]] = 0;
+
+	for (k = 0; k < m_savedRowLabels.size(); k++)
+		m_lastColOfRow[m_savedRowLabels[k]] = -1;
+
+	m_savedColLabels.clear();
+	m_savedRowLabels.clear();
+
+	for (j = 0; j < m_nSize; j++)
+	{
+		int label = m_colLabels[j];
+
+		if (label >= 0)
+		{
+			Grow(m_lastPotentials, label + 1, 0.0);
+			Grow(m_hasLastPotential, label + 1, (char) 0);
+
+			m_lastPotentials[label] = m_v[j];
+			m_hasLastPotential[label] = 1;
+			m_savedColLabels.push_back(label);
+		}
+	}
+
+	for (i = 0; i < m_nSize; i++)
+	{
+		int label = m_rowLabels[i];
+
+		if (label >= 0 && m_rowToCol[i] >= 0 && m_colLabels[m_rowToCol[i]] >= 0)
+		{
+			Grow(m_lastColOfRow, label + 1, -1);
+
+			m_lastColOfRow[label] = m_colLabels[m_rowToCol[i]];
+			m_savedRowLabels.push_back(label);
+		}
+	}
+}
+
+double AssignmentSolver::Solve(bool bWarmStart)
+{
+	const int n = m_nSize;
+	double sum = 0;
+	int i;
+
+	if (n == 0)
+		return 0;
+
+	if (!bWarmStart)
+		ClearWarmStart();
+
+	m_dist.resize(n);
+	m_pred.resize(n);
+	m_scanned.resize(n);
+	m_isScanned.resize(n);
+
+	WarmStart();
+
+	for (i = 0; i < n; i++)
+		if (m_rowToCol[i] < 0)
+			Augment(i);
+
+	SaveState();
+
+	for (i = 0; i < m_nRows; i++)
+		if (GetAssignedCol(i) >= 0)
+			sum += GetProfit(i, GetAssignedCol(i));
+
+	return sum;
+}
+
+void AssignmentSolver::GetMatching(leda::list<leda::edge>* pMatching) const
+{
+	pMatching->clear();
+
+	for (int i = 0; i < m_nRows; i++)
+	{
+		int j = GetAssignedCol(i);
+
+		if (j >= 0 && m_edges[i * m_nSize + j] != nil)
+			pMatching->append(m_edges[i * m_nSize + j]);
+	}
+}
+
+AssignmentSolver& AssignmentSolver::Scratch()
+{
+	return MatchContext::Current().assignmentSolver;
+}
@@ -110,7 +110,7 @@ double BGCSM::ComputeNodeSimilarity(leda::node v1, leda::node v2,
 
 	double edgeSim;
 
-	if (DAGMatcher::GetMatchParams().nCompareEdges)
+	if (Context().GetParams().nCompareEdges)
 	{
 		// Sum the max of in degrees for both nodes
 		double numEdges1   = m_pG1->indeg(v1);
@@ -205,6 +205,15 @@ double BGCSM::MatchEdgesAndParams(BipartiteEdgeGraph& g,
 
 double BGSimilarityMeasurer::ComputeNodeSimilarity(leda::node v1, leda::node v2,
 												   NodeMatchInfoPtr ptrMatchInfo) const
+{
+	return MemoizedNodeSimilarity(v1, v2);
+}
+
+/*!
+	@brief The best similarity among the two positions of the nodes. It doesn't
+	depend on the match info, so it's computed once per pair of nodes.
+*/
+double BGSimilarityMeasurer::ComputeNodePairSimilarity(leda::node v1, leda::node v2) const
 {
 	double similarity, bestSim = -1;
 	ParamIndices parInds(1);
@@ -231,7 +240,7 @@ double BGSimilarityMeasurer::ComputeNodeDistance(leda::node v1, leda::node v2,
 												 const ParamIndices& parInds,
 												 double* pSimilarity) const
 {
-	if (!DAGMatcher::GetMatchParams().nCompareNodes)
+	if (!Context().GetParams().nCompareNodes)
 	{
 		*pSimilarity = 1;
 		return 0;
@@ -286,14 +295,14 @@ double BGSimilarityMeasurer::ComputeNodeDistance(leda::node v1, leda::node v2,
 
 		areaDiff = xi.XORArea();
 
-		*pSimilarity = xi.FunctionSimilarity(DAGMatcher::GetMatchParams().dSlopeSigma);
+		*pSimilarity = xi.FunctionSimilarity(Context().GetParams().dSlopeSigma);
 
 		if (params.bFlipPosition)
 		{
 			XORIntegral xi2(pNode1->GetRadiusFunction(),
 				pNode2->GetRadiusFunction(true));
 
-			double sim2 = xi2.FunctionSimilarity(DAGMatcher::GetMatchParams().dSlopeSigma);
+			double sim2 = xi2.FunctionSimilarity(Context().GetParams().dSlopeSigma);
 
 			if (*pSimilarity < sim2)
 			{
@@ -328,7 +337,7 @@ double BGSimilarityMeasurer::ComputeNodeDistance(leda::node v1, leda::node v2,
 double BGSimilarityMeasurer::ComputeEdgeSimilarity(leda::edge e1, leda::edge e2,
 												   const ParamIndices& parInds) const
 {
-	if (!DAGMatcher::GetMatchParams().nCompareEdges)
+	if (!Context().GetParams().nCompareEdges)
 	{
 		return 1;
 	}
@@ -385,12 +394,12 @@ double BGSimilarityMeasurer::ComputeEdgeSimilarity(leda::edge e1, leda::edge e2,
 	double angleSimilarity;
 
 	if (angle1 != 0 && angle2 != 0 && SIGN(angle1) != SIGN(angle2))
-		angleSimilarity = DAGMatcher::GetMatchParams().dBGWrongSidePen;
+		angleSimilarity = Context().GetParams().dBGWrongSidePen;
 	else
 		angleSimilarity = 1;
 
 	double positionSimilarity;
-	const double& sigma = DAGMatcher::GetMatchParams().dBGPositionSigma;
+	const double& sigma = Context().GetParams().dBGPositionSigma;
 
 	if (sigma == 0)
 	{
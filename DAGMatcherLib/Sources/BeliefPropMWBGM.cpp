@@ -4,273 +4,351 @@ C version of belief propagation b-matching.
 Bert Huang (2006)
 Send comments and questions to bert at cs.columbia.edu
 
-Please contact Bert if you use this code for anything other than 
-evaluation. 
+Please contact Bert if you use this code for anything other than
+evaluation.
 */
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <math.h>
-#include <time.h>
-#include "BipartiteNodeGraph.h"
+/**
+*	\file BeliefPropMWBGM.cpp
+*	\brief BeliefPropSolver source file.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
 
-#define NEG_INF -1
-#define MAX_ITER 10000
-#define CONVERGENCE_INSURANCE 20
+#include "stdafx.h"
 
-using namespace dml;
+#include <limits>
 
-struct node_t;
+#define DEFAULT_MAX_ITERS 200
+#define DEFAULT_STABLE_ITERS 5
+#define MIN_NODES_PER_THREAD 64
 
-typedef std::vector<node_t*> NodeArray;
+using namespace dml;
 
-struct node_t 
+struct BeliefPropSolver::SolvePlan
 {
-	
-	int id;
-	int neighborhood;              //number of neighbors (not counting itself)
-	NodeArray neighbors;           //vector of pointers to neighbors
-	std::vector<double> message;   //vector of messages from this node to all other nodes
-	std::vector<double> phi;       //potential
-	std::vector<int> beliefs;      //current top b node ids
+	BeliefPropSolver* pSolver;
+	int nThreads;
+	boost::barrier* pBarrier;
+	bool bStop;
 };
 
-node_t* initNode(int n, int id, int b, int total)
+BeliefPropSolver::BeliefPropSolver()
+{
+	m_nRows = m_nCols = m_nSize = 0;
+	m_nMaxIters = DEFAULT_MAX_ITERS;
+	m_nStableIters = DEFAULT_STABLE_ITERS;
+	m_nThreads = 1;
+	m_nIters = m_nStable = 0;
+	m_bConverged = false;
+}
+
+void BeliefPropSolver::Init(int nRows, int nCols)
 {
+	m_nRows = nRows;
+	m_nCols = nCols;
+	m_nSize = MAX(nRows, nCols);
+
+	// assign() keeps the capacity, so this only allocates for bigger problems
+	m_profit.assign(m_nSize * m_nSize, 0.0);
+	m_edges.assign(m_nSize * m_nSize, (leda::edge) nil);
+	m_rowToCol.assign(m_nSize, -1);
+	m_colToRow.assign(m_nSize, -1);
+}
+
+void BeliefPropSolver::Init(const leda::graph& G, const leda::list<leda::node>& A,
+	const leda::list<leda::node>& B, const leda::edge_array<double>& profits)
+{
+	leda::node v;
+	leda::edge e;
 	int i;
-	node_t* node = new node_t;
 
-	node->id = id;
-	node->neighborhood = n;
+	Init(A.size(), B.size());
 
-	node->message.resize(total);
-	node->phi.resize(n);
-	node->neighbors.resize(n);
-	node->beliefs.resize(b);
+	m_nodeSlots.assign(G.max_node_index() + 1, -1);
 
-	for (i = 0; i < total; i++)
-		node->message[i] = 1;		
+	i = 0;
+	forall(v, A)
+		m_nodeSlots[index(v)] = i++;
 
-	for (i = 0; i < n; i++)
-		node->phi[i] = 1;
+	i = 0;
+	forall(v, B)
+		m_nodeSlots[index(v)] = i++;
 
-	for (i = 0; i < b; i++)
-		node->beliefs[i] = i;
+	forall_edges(e, G)
+	{
+		ASSERT(m_nodeSlots[index(source(e))] >= 0 && m_nodeSlots[index(target(e))] >= 0);
 
-	return node;
+		SetProfit(m_nodeSlots[index(source(e))], m_nodeSlots[index(target(e))], profits[e], e);
+	}
 }
 
-/*
-	updates the messages stored in the given node
-	by using messages from neighbors in opposite
+/*!
+	Copies the profits to the row and column weight matrices, adding to
+	each a perturbation that depends only on its cell, so that the optimum
+	is unique. They add up to less than a millionth of the largest profit.
 */
-void updateMessages(node_t *node, int b)
+void BeliefPropSolver::PrepareWeights()
 {
-	int i, j, minind, bth, counter;
-	int n = node->neighborhood;
+	const int n = m_nSize;
+	double maxProfit = 0;
+	int i, j;
 
-	std::vector<double> workvec(n);
-	std::vector<int> topvals(b + 1);
+	for (i = 0; i < n * n; i++)
+		maxProfit = MAX(maxProfit, m_profit[i]);
 
-	//compute work vector
-	for (i = 0; i < n; i++) {
-		workvec[i] = node->phi[i]*node->neighbors[i]->message[node->id];
-	}
+	const double eps = ((maxProfit > 0) ? maxProfit : 1) * 1e-6 / n;
 
-	//initialize topvals to be the first b+1 indexes
-	minind = 0; bth = 0;
+	m_rowWeights.resize(n * n);
+	m_colWeights.resize(n * n);
 
-	for (i = 0; i < b + 1; i++) {
-		topvals[i] = i;
-		if (workvec[topvals[i]]<workvec[topvals[minind]])
-			minind=i;
-	}
+	for (i = 0; i < n; i++)
+	{
+		for (j = 0; j < n; j++)
+		{
+			// Knuth's multiplicative hash of the cell, scaled to [0, 1)
+			unsigned int h = (unsigned int) (i * n + j + 1) * 2654435761U;
+			double w = m_profit[i * n + j] + eps * (h / 4294967296.0) / n;
 
-	//find true topvals and true minind
-	for (i = b + 1; i < n; i++) {
-		if (workvec[i]>workvec[topvals[minind]]) {
-			topvals[minind] = i;
-			for (j=0; j<b+1; j++) {
-				if (workvec[topvals[j]]<workvec[topvals[minind]])
-					minind=j;
-			}
+			m_rowWeights[i * n + j] = w;
+			m_colWeights[j * n + i] = w;
 		}
 	}
+}
 
-	//find bth entry
-	if (minind==0)
-		bth=1;
-	for (i = 0; i < b + 1; i++) {
-		if (i!=minind && workvec[topvals[i]]<workvec[topvals[bth]])
-			bth = i;
-	}
+/*!
+	Sends the messages of node k, whose weights to the other side are
+	weights[0...n-1] and whose incoming messages are in[0...n-1]. The
+	message to node j is its weight minus the best alternative to it, ie,
+	weights[j] - MAX over l != j of (weights[l] + in[l]), and it's written
+	to out[j * n + k].
 
-	//update messages
-	for (i = 0; i < n; i++) {
-		if (workvec[i]>=workvec[topvals[bth]])
-			node->message[node->neighbors[i]->id]=node->phi[i]/workvec[topvals[minind]];
-		else
-			node->message[node->neighbors[i]->id]=node->phi[i]/workvec[topvals[bth]];
-	}
+	@return the node that node k believes it's matched with
+*/
+int BeliefPropSolver::UpdateMessages(const double* weights, const double* in, double* out, int n, int k)
+{
+	double max1 = -std::numeric_limits<double>::max(), max2 = max1, val;
+	int best = 0, j;
+
+	for (j = 0; j < n; j++)
+	{
+		val = weights[j] + in[j];
 
-	//update beliefs
-	counter=0;
-	for (i = 0; i < b + 1; i++) {
-		if (i!=minind) {
-			node->beliefs[counter++] = node->neighbors[topvals[i]]->id;
+		if (val > max1)
+		{
+			max2 = max1;
+			max1 = val;
+			best = j;
+		}
+		else if (val > max2)
+		{
+			max2 = val;
 		}
 	}
+
+	for (j = 0; j < n; j++)
+		out[j * n + k] = weights[j] - ((j == best) ? max2 : max1);
+
+	return best;
 }
 
-/*
-	checks if there is a valid bmatching in the beliefs
+/*!
+	Counts the iteration and checks the beliefs of the rows. Only the
+	beliefs in cells with a profit count, since the others aren't part of
+	the result. Telling those apart would take as many iterations as there
+	are ties among them.
+
+	@return true if the beliefs have been the same one-to-one assignment
+	        for long enough, or if there are no iterations left
 */
-int permCheck(NodeArray& nodes, SmartMatrix<double>& P, int n, int b) 
+bool BeliefPropSolver::EndIteration()
 {
-	int ret = 1, i, j;
+	const int n = m_nSize;
+	bool bValid = true;
+	int i;
 
-	std::vector<int> counters(n);
+	m_nIters++;
+	m_colCount.assign(n, 0);
 
 	for (i = 0; i < n; i++)
-		counters[i]=0;
-
-	for (i = 0; i < n; i++) {
-		for (j = 0; j < b; j++) {
-			P[i][j] = nodes[i]->beliefs[j];
-			counters[nodes[i]->beliefs[j]]++;
-		}
+	{
+		if (m_profit[i * n + m_belief[i]] <= 0)
+			m_belief[i] = -1;
+		else if (m_colCount[m_belief[i]]++ > 0)
+			bValid = false;
 	}
 
-	for (i = 0; i < n; i++) 
-		if (counters[i] != b)
-			ret = 0;
+	if (bValid && m_belief == m_lastBelief)
+		m_nStable++;
+	else
+		m_nStable = bValid ? 1 : 0;
 
-	return ret;
+	m_lastBelief = m_belief;
+	m_bConverged = (m_nStable >= m_nStableIters);
+
+	return m_bConverged || m_nIters >= m_nMaxIters;
 }
 
-/*BipartiteNodeGraph::NodeAssigmentList BipartiteNodeGraph::ComputeBeliefPropMWBM()
+/*!
+	Thread body of Solve(). Each iteration updates the messages of the
+	columns and then those of the rows, each side reading only the messages
+	of the other one, so thread t can update its share of each side
+	without locks. The threads wait for each other between the steps.
+*/
+void BeliefPropSolver::Iterate(SolvePlan* pPlan, int nThread)
 {
-	SmartMatrix<double> P;
-	NodeArray alpha, beta;
+	BeliefPropSolver& s = *pPlan->pSolver;
+	const int n = s.m_nSize;
+	const int first = nThread * n / pPlan->nThreads;
+	const int last = (nThread + 1) * n / pPlan->nThreads;
+	int k;
 
-	ASSERT(A.size() == B.size());
+	for (;;)
+	{
+		for (k = first; k < last; k++)
+			UpdateMessages(&s.m_colWeights[k * n], &s.m_toCol[k * n], &s.m_toRow[0], n, k);
 
-	const int n = A.size();
-	const int b = 1;
+		pPlan->pBarrier->wait();
 
-	P.Resize(n, b);
+		for (k = first; k < last; k++)
+			s.m_belief[k] = UpdateMessages(&s.m_rowWeights[k * n], &s.m_toRow[k * n], &s.m_toCol[0], n, k);
 
-	alpha.resize(n);
-	beta.resize(n);
+		pPlan->pBarrier->wait();
 
-	// Allocate node and initialize them
-	leda::node_map<node_t*> alphaMap(*this), betaMap(*this);
-	NodeSetIterator it;
-	leda::edge e;
-	leda::node v;
-	node_t* pNode;
-	int i;
+		if (nThread == 0)
+			pPlan->bStop = s.EndIteration();
 
-	//initialize alpha nodes
-	i = 0;
-	forall_items(it, A)
-	{ 
-		v = A[it];
-		alpha[i] = initNode(outdeg(v), i, b, n);
-		alphaMap[v] = alpha[i];
-		i++;
-	}
+		pPlan->pBarrier->wait();
 
-	i = 0;
-	forall_items(it, B)
-	{ 
-		v = B[it];
-		beta[i] = initNode(indeg(v), i, b, n);
-		betaMap[v] = beta[i];
-		i++;
+		if (pPlan->bStop)
+			return;
 	}
+}
 
-	// Connect nodes
-	forall_items(it, A)
+/*!
+	Turns the beliefs into an assignment. Each row keeps its belief if no
+	earlier row took it. Then the rows left take their best free column,
+	if it has a profit, which can only happen when not converged.
+*/
+void BeliefPropSolver::Decode()
+{
+	const int n = m_nSize;
+	int i, j;
+
+	m_rowToCol.assign(n, -1);
+	m_colToRow.assign(n, -1);
+
+	for (i = 0; i < n; i++)
 	{
-		v = A[it];
-		pNode = alphaMap[v];
-		i = 0;
+		j = m_belief[i];
 
-		forall_out_edges(e, v)
+		if (j >= 0 && m_colToRow[j] < 0)
 		{
-			pNode->neighbors[i] = betaMap[target(e)];
-			pNode->phi[i]       = exp(edgeValues[e]);
-			i++;
+			m_rowToCol[i] = j;
+			m_colToRow[j] = i;
 		}
 	}
 
-	forall_items(it, B)
+	for (i = 0; i < n; i++)
 	{
-		v = B[it];
-		pNode = betaMap[v];
-		i = 0;
+		if (m_rowToCol[i] >= 0)
+			continue;
 
-		forall_out_edges(e, v)
+		int best = -1;
+
+		for (j = 0; j < n; j++)
+			if (m_colToRow[j] < 0 && m_profit[i * n + j] > 0 &&
+				(best < 0 || m_rowWeights[i * n + j] > m_rowWeights[i * n + best]))
+				best = j;
+
+		if (best >= 0)
 		{
-			pNode->neighbors[i] = alphaMap[source(e)];
-			pNode->phi[i]       = exp(edgeValues[e]);
-			i++;
+			m_rowToCol[i] = best;
+			m_colToRow[best] = i;
 		}
 	}
+}
 
-	// Start belief propagation
-	int converged = CONVERGENCE_INSURANCE, iters = 0;
+double BeliefPropSolver::Solve()
+{
+	const int n = m_nSize;
+	double sum = 0;
+	int i;
 
-	while(converged > 0) {
+	m_nIters = m_nStable = 0;
+	m_bConverged = false;
 
-		for (i = 0; i < n; i++) {
-			updateMessages(beta[i], b);
-		}
-		for (i=0; i < n; i++) {
-			updateMessages(alpha[i], b);
-		}
-
-		//printf("message update successful\n");
-		//check for convergence
-		converged -= permCheck(alpha, P, n, b);
+	if (n == 0)
+		return 0;
 
-		//printf("permcheck successful\n");
+	if (n == 1)
+	{
+		m_bConverged = true;
+		m_rowToCol.assign(1, 0);
+		m_colToRow.assign(1, 0);
 
-		if (++iters > MAX_ITER) {
-			ShowMsg("Reached maximum iterations without converging");
-			converged = 0;
-		}			
+		return (m_nRows > 0 && m_nCols > 0) ? m_profit[0] : 0;
 	}
 
-	NodeAssigmentList edgeList;
+	PrepareWeights();
 
-	// Copy the mapping to a list of edges
-	leda::node u;
-	i = 0;
-	forall_items(it, A)
+	// The messages start at log(1)
+	m_toRow.assign(n * n, 0.0);
+	m_toCol.assign(n * n, 0.0);
+	m_belief.assign(n, 0);
+	m_lastBelief.assign(n, -1);
+
+	SolvePlan plan;
+
+	plan.pSolver = this;
+	plan.nThreads = (m_nThreads < 0) ? (int) boost::thread::hardware_concurrency() : m_nThreads;
+	plan.nThreads = MAX(1, MIN(plan.nThreads, n / MIN_NODES_PER_THREAD));
+	plan.bStop = false;
+
+	boost::barrier barrier(plan.nThreads);
+
+	plan.pBarrier = &barrier;
+
+	if (plan.nThreads == 1)
+	{
+		Iterate(&plan, 0);
+	}
+	else
 	{
-		u = A[it];
-		v = B[B.get_item(P[i][0])];
+		boost::thread_group threads;
 
-		forall_out_edges(e, u)
-		{
-			if (target(e) == v)
-			{
-				edgeList.push_back(e);
-				break;
-			}
-		}
+		// The caller is thread 0
+		for (i = 1; i < plan.nThreads; i++)
+			threads.create_thread(boost::bind(&BeliefPropSolver::Iterate, &plan, i));
+
+		Iterate(&plan, 0);
 
-		i++;
+		threads.join_all();
 	}
 
-	// Delete nodes
-	for (i = 0; i < n; i++)
-		delete alpha[i];
+	Decode();
 
-	for (i = 0; i < n; i++)
-		delete beta[i];
+	for (i = 0; i < m_nRows; i++)
+		if (GetAssignedCol(i) >= 0)
+			sum += GetProfit(i, GetAssignedCol(i));
 
-	return edgeList;
-}*/
+	return sum;
+}
+
+void BeliefPropSolver::GetMatching(leda::list<leda::edge>* pMatching) const
+{
+	pMatching->clear();
+
+	for (int i = 0; i < m_nRows; i++)
+	{
+		int j = GetAssignedCol(i);
+
+		if (j >= 0 && m_edges[i * m_nSize + j] != nil)
+			pMatching->append(m_edges[i * m_nSize + j]);
+	}
+}
+
+BeliefPropSolver& BeliefPropSolver::Scratch()
+{
+	return MatchContext::Current().beliefPropSolver;
+}
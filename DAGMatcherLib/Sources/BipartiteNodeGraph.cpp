@@ -60,6 +60,42 @@ void BNG::TransferEdgeValues()
 	}
 }
 
+/*!
+	@brief Upper bound of the value of the max weight assignment that
+	doesn't require solving it. Each node in an assignment gets at most
+	the value of its best edge, so the sum of the best edge values of
+	the nodes in either set is a bound. The smallest of the two is returned.
+*/
+double BNG::AssignmentUpperBound() const
+{
+	double sum[2] = {0, 0};
+	double maxVal;
+	leda::node v;
+	leda::edge e;
+
+	forall(v, m_setA)
+	{
+		maxVal = 0;
+
+		forall_out_edges(e, v)
+			maxVal = MAX(maxVal, m_edgeValues[e]);
+
+		sum[0] += maxVal;
+	}
+
+	forall(v, m_setB)
+	{
+		maxVal = 0;
+
+		forall_in_edges(e, v)
+			maxVal = MAX(maxVal, m_edgeValues[e]);
+
+		sum[1] += maxVal;
+	}
+
+	return MIN(sum[0], sum[1]);
+}
+
 /*!
 	@brief Creates a bipartite node graph between the nodes
 	in g1 and those in g2. The edge values of the graph encode
@@ -33,28 +33,19 @@
 
 using namespace dml;
 
-/////////////////////////////////////////////////////////////////////////////
-// Init static variables
-
-DAGMatcher* BoneGraph::s_pDAGMatcher = NULL;
-
 /////////////////////////////////////////////////////////////////////////////
 // BoneGraph class implementation
 
 BoneGraph::BoneGraph()
 {
 	m_pSkeleton = NULL;
-
-	// Init the matching algorithm for bone graphs
-	if (s_pDAGMatcher == NULL)
-		SetMatchingAlgorithm();
 }
 
-//! Sets the matching algorithm from the values in the match params
-void BoneGraph::SetMatchingAlgorithm()
+//! Creates the matching algorithm selected by the values in the match params
+DAGMatcher* BoneGraph::CreateMatchingAlgorithm(const DAGMatcher::MatchParams& params) const
 {
-	int matchAlgo = DAGMatcher::GetMatchParams().nMatchingAlgorithm;
-	int nodeSimFunc = DAGMatcher::GetMatchParams().nNodeSimilarityFunction;
+	int matchAlgo = params.nMatchingAlgorithm;
+	int nodeSimFunc = params.nNodeSimilarityFunction;
 	SimilarityMeasurer* pNDM;
 
 	if (nodeSimFunc == 0) // default is zero
@@ -71,17 +62,14 @@ void BoneGraph::SetMatchingAlgorithm()
 		throw;
 	}
 
-	// Delete any existing algorithm before creating a new one
-	delete s_pDAGMatcher;
-
 	if (matchAlgo == 0)
-		s_pDAGMatcher = new DAGMatcherGreedy(pNDM);
+		return new DAGMatcherGreedy(pNDM);
 	else if (matchAlgo == 1)
-		s_pDAGMatcher = new DAGMatcherOptimal(pNDM);
+		return new DAGMatcherOptimal(pNDM);
 	else if (matchAlgo == 2)
-		s_pDAGMatcher = new DAGMatcherTopological(pNDM);
+		return new DAGMatcherTopological(pNDM);
 	else if (matchAlgo == 3)
-		s_pDAGMatcher = new DAGMatcherAdaptive(pNDM);
+		return new DAGMatcherAdaptive(pNDM);
 	else
 	{
 		ShowError("Unknown matching algorithm ID");
@@ -139,6 +127,8 @@ void BoneGraph::ComputeDerivedValues()
 			}
 		}
 	}
+
+	Freeze(); // the node types have changed
 }
 
 //! Extends the behaviour of the same function in the base class.
@@ -317,6 +307,8 @@ bool BoneGraph::Create(const ImageInfo& imgInfo, const BoneGraphParams& bgparams
 {
 	Clear(); //make sure the current bone graph is empty
 
+	MemoryArena::Scope arenaScope(GetArena());
+
 	SetDAGLbl(imgInfo.strFileName);
 
 	m_pSkeleton = new SkeletalGraph();
@@ -357,6 +349,8 @@ bool BoneGraph::Create(SkeletalGraph* pSkeleton, const ShapeDims& dims,
 {
   	DAG::Clear();
 
+	MemoryArena::Scope arenaScope(GetArena());
+
 	m_dims = dims;
 	SetDAGLbl(strLbl);
 
@@ -33,6 +33,8 @@
 
 #include "stdafx.h"
 
+#ifndef DML_NO_LEDA // The views need the LEDA windows
+
 // matching window parms
 #define Y_OFFSET 10
 
@@ -914,4 +916,6 @@ void BoneGraphView::DrawWarpedShape()
 
 		m_pWnd->draw_arc(start, leda::point(mid_x, mid_y), end, leda::blue);
 	}
-}
\ No newline at end of file
+}
+
+#endif // DML_NO_LEDA
@@ -33,6 +33,7 @@
 
 #include "stdafx.h"
 
+#ifndef DML_NO_LEDA
 #ifdef USE_TEMPLATE_BASED_MWBM_FUNCTION
 #include <LEDA/graph/templates/mwb_matching.h>
 using namespace std; // Fixes an error in the next LEDA header scale_weights.h line 35
@@ -40,6 +41,7 @@ using namespace std; // Fixes an error in the next LEDA header scale_weights.h l
 #else
 #include <LEDA/graph/mwb_matching.h>
 #endif
+#endif //DML_NO_LEDA
 
 //#include <LEDA/graphwin.h>
 
@@ -57,6 +59,9 @@ using namespace std; // Fixes an error in the next LEDA header scale_weights.h l
 #define ROOT_NODE_LEVEL			0
 #define ROOT_NODE_DFS_INDEX		0
 
+// Smaller DAGs are not worth starting threads for
+#define MIN_NODES_FOR_PARALLEL_TSVS	32
+
 using namespace dml;
 using namespace leda;
 
@@ -116,54 +121,79 @@ void DAG::ResetNodesInfo()
 	}
 }
 
+/*!
+	Computes the transitive closure matrix, indexed by DFS index. The row of
+	each node is built once all its children's rows are complete: it is the
+	node itself plus the union of its children's rows. A node is considered
+	an ancestor (and a descendant) of itself.
+*/
 void DAG::ComputeTransiveClosure()
 {
-	leda::node u, v;
-	int i, n = GetNodeCount();
+	leda::node_array<bool> done(*this, false);
+	leda::node v;
+	int n = GetNodeCount();
 
-	m_transClosMat.Resize(n, n, true);
+	m_transClosMat.Resize(n, n);
 
-#if LEDA_VERSION == 43
-	leda::graph g = TRANSITIVE_CLOSURE(*this);
+	forall_nodes(v, *this)
+		if (!done[v])
+			AddDescendantsToClosure(v, done);
 
-	// Translate the transitive closure graph into a matrix form
-	forall_nodes(v, g)
-	{
-		i = GetNodeDFSIndex(v);
+	m_ancestorMat = m_transClosMat.Transpose();
+}
 
-		forall_adj_nodes(u, v)
-			m_transClosMat[i][GetNodeDFSIndex(u)] = 1;
-	}
-#else
-	LEDA_GRAPH<leda::node,leda::edge> g = TRANSITIVE_CLOSURE(*this);
+//! Sets the row of <v> in the transitive closure matrix, after those of its descendants.
+void DAG::AddDescendantsToClosure(leda::node v, leda::node_array<bool>& done)
+{
+	leda::node w;
+	const int i = GetNodeDFSIndex(v);
 
-	// Translate the transitive closure graph into a matrix form
-	forall_nodes(v, g)
+	m_transClosMat.Set(i, i);
+
+	forall_adj_nodes(w, v)
 	{
-		i = GetNodeDFSIndex(g[v]);
+		if (!done[w])
+			AddDescendantsToClosure(w, done);
 
-		forall_adj_nodes(u, v)
-			m_transClosMat[i][GetNodeDFSIndex(g[u])] = 1;
+		m_transClosMat.OrRow(i, GetNodeDFSIndex(w));
 	}
-#endif
+
+	done[v] = true;
 }
 
+/*!
+	The mass of a node is T * (T * 1) at its row, where T is the transitive
+	closure matrix: the sum of the number of descendants of all its descendants.
+*/
 void DAG::ComputeNodesMass()
 {
 	leda::node v;
+	int i, j, k;
 
 	ASSERT(GetNodeCount() * GetNodeCount() == m_transClosMat.GetSize());
 
-	/*forall_nodes(v, *this)
-		GetNode(v)->SetMass(m_transClosMat.RowSum(GetNodeDFSIndex(v)));*/
-
-	SmartArray<int> ones(m_transClosMat.NRows());
-	ones.Set(1);
+	const int n = m_transClosMat.NRows();
+	SmartArray<int> descendants(n);
 
-	SmartArray<int> relMasses = m_transClosMat * (m_transClosMat * ones);
+	for (i = 0; i < n; i++)
+		descendants[i] = m_transClosMat.RowCount(i);
 
 	forall_nodes(v, *this)
-		GetNode(v)->SetMass(relMasses[GetNodeDFSIndex(v)]);
+	{
+		const BitMatrix::Word* row = m_transClosMat.Row(GetNodeDFSIndex(v));
+		int nMass = 0;
+
+		for (k = 0; k < m_transClosMat.WordsPerRow(); k++)
+		{
+			BitMatrix::Word w = row[k];
+
+			for (j = k * BitMatrix::WORD_BITS; w != 0; j++, w >>= 1)
+				if (w & 1)
+					nMass += descendants[j];
+		}
+
+		GetNode(v)->SetMass(nMass);
+	}
 }
 
 /*!
@@ -201,10 +231,23 @@ void DAG::ComputeDerivedValues()
 	m_nMaxBFactor = 0;
 	m_dTotalTSVSum = 0;
 
+	int nTSVThreads = s_constructParams.nTSVThreads;
+
+	if (nTSVThreads == 0)
+		nTSVThreads = (int) boost::thread::hardware_concurrency();
+
+	bool bParallelTSVs = nTSVThreads > 1 && GetNodeCount() >= MIN_NODES_FOR_PARALLEL_TSVS;
+
+	if (bParallelTSVs)
+		ComputeTSVsParallel(roots, nTSVThreads);
+
 	for (i = 0; i < roots.GetSize(); i++)
 	{
 		v = roots[i];
-		ComputeTSVs(v);
+
+		if (!bParallelTSVs)
+			ComputeTSVs(v);
+
 		m_nCumulativeMass += GetNodeMass(v);
 	}
 
@@ -224,6 +267,8 @@ void DAG::ComputeDerivedValues()
 	}
 
 	SetObjectNameAndViewNumber(GetDAGLbl());
+
+	Freeze();
 }
 
 /*!
@@ -235,7 +280,8 @@ void DAG::ComputeDerivedValues()
 
 	\param v root of the subtree.
 	\param bRecomputeTSVs controls whether the TSVs that remains in
-	the original graph should be recomputed.
+	the original graph should be recomputed. Only the former parents of
+	the subtree and their ancestors are updated (see UpdateTSVs()).
 */
 DAGPtr DAG::SplitSubGraph(leda::node v, bool bRecomputeTSVs)
 {
@@ -247,23 +293,33 @@ DAGPtr DAG::SplitSubGraph(leda::node v, bool bRecomputeTSVs)
 		// Create a map for the parents of nodes with more
 		// than one parent
 		DynamicNodeMap nodeParentMap;
+		leda::list<leda::node> changedNodes;
+		leda::edge e;
+
+		if (bRecomputeTSVs)
+			forall_in_edges(e, v)
+				changedNodes.append(source(e));
 
 		SplitSubGraph(v, subg, nodeParentMap, nil);
 
 		// Now it is safe to eliminate those nodes in the
-		// subtre that have multiple parents
+		// subtre that have multiple parents. Their remaining
+		// parents are outside the subtree and lose a child.
 		forall_defined(v, nodeParentMap)
+		{
+			if (bRecomputeTSVs)
+				forall_in_edges(e, v)
+					changedNodes.append(source(e));
+
 			del_node(v);
+		}
 
 		subg->m_transClosMat = GetTransClosMat();
+		subg->m_ancestorMat = GetAncestorMat();
 		subg->m_nCumulativeMass = m_nCumulativeMass;
 
 		if (bRecomputeTSVs)
-		{
-			SmartArray<leda::node> roots = GetAllRoots();
-			for (int i = 0; i < roots.GetSize(); i++)
-				ComputeTSVs(roots[i]);
-		}
+			UpdateTSVs(changedNodes);
 	}
 	else
 	{
@@ -360,8 +416,24 @@ void DAG::AddEdge(Matrix& adj, leda::edge e, int srcNodeIdx, int tgtNodeIdx) con
 
 	\todo Find out the impact of summing all the eigenvalues instead of the $k$ largest ones.5s3l1
 
+	The algorithm is selected by s_constructParams.nTSVSolver.
 */
 double DAG::ComputeEigenSum(const Matrix& adj, int nVals)
+{
+	// Leaves have nothing to sum. They are most of the nodes, so skip the decomposition.
+	if (nVals <= 0)
+		return 0.0;
+
+	if (s_constructParams.nTSVSolver == TSV_SOLVER_FULL_SVD)
+		return ComputeEigenSumSVD(adj, nVals);
+	else
+		return ComputeEigenSumSymmetric(adj, nVals);
+}
+
+/*!
+	\brief Original eigen-sum: full SVD of the adjacency matrix, including U.
+*/
+double DAG::ComputeEigenSumSVD(const Matrix& adj, int nVals)
 {
 	using namespace NEWMAT;
 
@@ -382,6 +454,64 @@ double DAG::ComputeEigenSum(const Matrix& adj, int nVals)
 	return td;
 }
 
+/*!
+	\brief Sums the nVals largest singular values of adj without computing any singular vector.
+
+	The singular values of adj are the square roots of the eigenvalues of the symmetric
+	matrix B = adj' * adj. B is assembled from the non-zero entries of adj only (about two
+	per row for the adjacency matrix of a tree), and its eigenvalues are computed by
+	Householder tridiagonalization followed by QL iterations, without accumulating the
+	transformations.
+*/
+double DAG::ComputeEigenSumSymmetric(const Matrix& adj, int nVals)
+{
+	using namespace NEWMAT;
+
+	int n = adj.Nrows(), i, j, k, a, b;
+	double td = 0.0;
+
+	// Non-zero entries of adj, row by row (CSR)
+	std::vector<int> rowStart(n + 1), cols;
+	std::vector<double> vals;
+
+	cols.reserve(2 * n);
+	vals.reserve(2 * n);
+
+	for (i = 1; i <= n; i++)
+	{
+		rowStart[i - 1] = (int)cols.size();
+
+		for (j = 1; j <= n; j++)
+		{
+			if (adj(i, j) != 0)
+			{
+				cols.push_back(j);
+				vals.push_back(adj(i, j));
+			}
+		}
+	}
+
+	rowStart[n] = (int)cols.size();
+
+	// B(a, b) = sum_k adj(k, a) * adj(k, b), over the pairs of non-zeros of each row k
+	SymmetricMatrix B(n);
+	B = 0.0;
+
+	for (k = 0; k < n; k++)
+		for (a = rowStart[k]; a < rowStart[k + 1]; a++)
+			for (b = rowStart[k]; b <= a; b++)
+				B(cols[a], cols[b]) += vals[a] * vals[b];
+
+	DiagonalMatrix D(n);
+
+	EigenValues(B, D); // sorted in ascending order
+
+	for (i = n; i > n - nVals && i >= 1; i--)
+		td += sqrt(MAX(D(i), 0.0)); // B is positive semi-definite, up to rounding
+
+	return td;
+}
+
 double DAG::ComputeLaplacian(const Matrix& adj)
 {
 	using namespace NEWMAT;
@@ -502,6 +632,340 @@ double DAG::ComputeTSVs(leda::node v, int& j, Matrix& adj, NodeIndexMap& loopyNo
 	return s;
 }
 
+/*!
+	@brief Updates the TSVs after a local edit of the graph.
+
+	Only the given nodes and their ancestors can have a different subgraph
+	below them, so only their TSVs and eigen labels are recomputed, bottom-up.
+	The eigen labels of every other node are still valid and are reused as
+	children's TSV entries.
+
+	DAG-level values (masses, transitive closure and total TSV sum) are
+	not updated, and the flat view is dropped until the next Freeze().
+*/
+void DAG::UpdateTSVs(const leda::list<leda::node>& changedNodes)
+{
+	leda::node_array<char> state(*this, 0); // 0: valid, 1: to update, 2: updated
+	std::stack<leda::node> ancestors;
+	leda::node v;
+	leda::edge e;
+
+	m_frozen.Clear();
+
+	forall(v, changedNodes)
+	{
+		if (state[v] == 0)
+		{
+			state[v] = 1;
+			ancestors.push(v);
+		}
+	}
+
+	while (!ancestors.empty())
+	{
+		v = ancestors.top();
+		ancestors.pop();
+
+		forall_in_edges(e, v)
+		{
+			if (state[source(e)] == 0)
+			{
+				state[source(e)] = 1;
+				ancestors.push(source(e));
+			}
+		}
+	}
+
+	forall_nodes(v, *this)
+		if (state[v] == 1)
+			UpdateNodeTSV(v, state);
+}
+
+/*!
+	Recomputes the TSV and eigen label of <v>, after those of its children
+	that are also marked for update. The eigen-sum is taken over the adjacency
+	matrix of the subgraph rooted at v, as ComputeTSVs(v) does.
+*/
+void DAG::UpdateNodeTSV(leda::node v, leda::node_array<char>& state)
+{
+	leda::node w;
+
+	forall_adj_nodes(w, v)
+		if (state[w] == 1)
+			UpdateNodeTSV(w, state);
+
+	TSV& tsv = GetNodeTSV(v);
+	tsv.Resize(outdeg(v), true);
+
+	forall_adj_nodes(w, v)
+		tsv.Add(GetEigenLbl(w));
+
+	NodeIndexMap visitedNodes, loopyNodeMap;
+	int j = 1, n = CountSubDAGNodes(v, visitedNodes);
+	Matrix adj(n, n);
+
+	adj = 0.0;
+	FillSubDAGAdjMatrix(v, j, adj, loopyNodeMap);
+
+	SetEigenLbl(v, ComputeEigenSum(adj, outdeg(v)));
+	tsv.Sort();
+
+	GetNode(v)->DAGNode::ComputeDerivedValues(); // TSV norm
+
+	state[v] = 2;
+}
+
+//! Number of distinct nodes in the subgraph rooted at <v>.
+int DAG::CountSubDAGNodes(leda::node v, NodeIndexMap& visited) const
+{
+	leda::node w;
+	int n = 1;
+
+	visited[v] = 1;
+
+	forall_adj_nodes(w, v)
+		if (!visited.defined(w))
+			n += CountSubDAGNodes(w, visited);
+
+	return n;
+}
+
+/*!
+	Adds the edges of the subgraph rooted at <v> to <adj>, numbering the
+	nodes in the same DFS order as ComputeTSVs(leda::node, int&, Matrix&, NodeIndexMap&).
+*/
+void DAG::FillSubDAGAdjMatrix(leda::node v, int& j, Matrix& adj, NodeIndexMap& loopyNodeMap) const
+{
+	leda::node w;
+	leda::edge e;
+	int i = j;
+
+	forall_adj_edges(e, v)
+	{
+		w = target(e);
+
+		if (indeg(w) > 1 && loopyNodeMap.defined(w))
+		{
+			AddEdge(adj, e, i, loopyNodeMap[w]);
+		}
+		else
+		{
+			AddEdge(adj, e, i, ++j);
+
+			if (indeg(w) > 1)
+				loopyNodeMap[w] = j; // loopy node visited
+
+			FillSubDAGAdjMatrix(w, j, adj, loopyNodeMap);
+		}
+	}
+}
+
+/*!
+	Eigen-sums to compute and where their results go, as planned by PlanTSVs().
+	Slot k >= 0 of a node label or TSV entry refers to the result of jobs[k],
+	and slot k < 0 to constants[-2 - k], a label that was already computed.
+*/
+struct DAG::TSVPlan
+{
+	struct EigenJob
+	{
+		const Matrix* pAdj;  //!< Adjacency matrix of the traversal that planned the job
+		int i, j;            //!< Rows and columns of the subgraph in pAdj
+		int nVals;
+		double dResult;
+	};
+
+	std::list<Matrix> matrices;                  //!< One per traversal, addresses must not change
+	std::vector<EigenJob> jobs;
+	std::vector<double> constants;
+	leda::node_array<int> labels;                //!< Slot of each node's eigen label, -1 if not planned
+	leda::node_array< std::vector<int> > tsvs;   //!< Slots of each node's TSV entries
+	leda::node_array<bool> hasTSV;
+
+	// Work distribution among the threads
+	boost::mutex mutexJobs;
+	std::vector<int> order;
+	size_t nNextJob;
+
+	double GetValue(int nSlot) const { return nSlot >= 0 ? jobs[nSlot].dResult : constants[-2 - nSlot]; }
+
+	static void RunJobs(TSVPlan* pPlan);
+};
+
+/*!
+	Thread body of ComputeTSVsParallel(). Jobs are independent: the eigen-sum of a
+	subgraph only depends on its adjacency matrix, not on the values of its children.
+*/
+void DAG::TSVPlan::RunJobs(TSVPlan* pPlan)
+{
+	for (;;)
+	{
+		EigenJob* pJob;
+		Matrix adj;
+
+		{
+			boost::mutex::scoped_lock lock(pPlan->mutexJobs);
+
+			if (pPlan->nNextJob >= pPlan->order.size())
+				return;
+
+			pJob = &pPlan->jobs[pPlan->order[pPlan->nNextJob++]];
+
+			// NEWMAT may touch the source while copying, so only copy under the lock
+			adj = pJob->pAdj->SubMatrix(pJob->i, pJob->j, pJob->i, pJob->j);
+		}
+
+		pJob->dResult = ComputeEigenSum(adj, pJob->nVals);
+	}
+}
+
+//! Orders the jobs by decreasing size, so that the largest ones don't start last.
+static bool CompareEigenJobSize(const std::pair<int, int>& a, const std::pair<int, int>& b)
+{
+	return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
+
+/*!
+	@brief Computes the TSVs of all the nodes using nThreads threads.
+
+	The DAG is first traversed exactly as ComputeTSVs() does, but each eigen-sum
+	is only recorded, with the slots where its result is used. All the eigen-sums
+	are then computed concurrently, and the labels and TSVs are finally set from
+	the recorded slots. The results are the same as those of ComputeTSVs().
+*/
+void DAG::ComputeTSVsParallel(const SmartArray<leda::node>& roots, int nThreads)
+{
+	TSVPlan plan;
+	leda::node v;
+	unsigned int k;
+	int i;
+
+	plan.labels.init(*this, -1);
+	plan.tsvs.init(*this);
+	plan.hasTSV.init(*this, false);
+
+	for (i = 0; i < roots.GetSize(); i++)
+		PlanTSVs(roots[i], plan);
+
+	std::vector< std::pair<int, int> > sizes(plan.jobs.size());
+
+	for (k = 0; k < plan.jobs.size(); k++)
+		sizes[k] = std::make_pair(plan.jobs[k].j - plan.jobs[k].i + 1, (int) k);
+
+	std::sort(sizes.begin(), sizes.end(), CompareEigenJobSize);
+
+	plan.order.resize(sizes.size());
+	plan.nNextJob = 0;
+
+	for (k = 0; k < sizes.size(); k++)
+		plan.order[k] = sizes[k].second;
+
+	boost::thread_group threads;
+
+	for (i = 0; i < nThreads; i++)
+		threads.create_thread(boost::bind(&TSVPlan::RunJobs, &plan));
+
+	threads.join_all();
+
+	forall_nodes(v, *this)
+	{
+		if (!plan.hasTSV[v])
+			continue;
+
+		const std::vector<int>& slots = plan.tsvs[v];
+		TSV& tsv = GetNodeTSV(v);
+
+		tsv.Resize((int) slots.size(), true);
+
+		for (k = 0; k < slots.size(); k++)
+			tsv.Add(plan.GetValue(slots[k]));
+
+		tsv.Sort();
+	}
+
+	forall_nodes(v, *this)
+		if (plan.labels[v] >= 0)
+			SetEigenLbl(v, plan.jobs[plan.labels[v]].dResult);
+}
+
+//! Same as ComputeTSVs(leda::node), recording the eigen-sums in <plan>.
+int DAG::PlanTSVs(leda::node root, TSVPlan& plan)
+{
+	int j = 1, n = GetNodeMass(root);
+	ASSERT(n > 0);
+
+	NodeIndexMap loopyNodeMap;
+
+	plan.matrices.push_back(Matrix(n, n));
+
+	Matrix& adj = plan.matrices.back();
+	adj = 0.0;
+
+	return PlanTSVs(root, j, adj, loopyNodeMap, plan);
+}
+
+/*!
+	Same as ComputeTSVs(leda::node, int&, Matrix&, NodeIndexMap&), but returns the
+	slot of the eigen-sum instead of its value. A subgraph's block of <adj> is final
+	when its job is recorded: later edges only add entries outside of it.
+*/
+int DAG::PlanTSVs(leda::node v, int& j, Matrix& adj, NodeIndexMap& loopyNodeMap, TSVPlan& plan)
+{
+	leda::node w;
+	leda::edge e;
+	int s, i = j;
+	bool bDefined, bHasLoopyChild = false;
+	std::vector<int> tsvSlots;
+
+	tsvSlots.reserve(outdeg(v));
+
+	forall_adj_edges(e, v)
+	{
+		w = target(e);
+		bDefined = indeg(w) > 1 ? loopyNodeMap.defined(w):false;
+
+		if (bDefined)
+		{
+			bHasLoopyChild = true;
+			AddEdge(adj, e, i, loopyNodeMap[w]);
+			s = plan.labels[w];
+
+			if (s < 0)
+			{
+				s = -2 - (int) plan.constants.size();
+				plan.constants.push_back(GetEigenLbl(w));
+			}
+		}
+		else
+		{
+			AddEdge(adj, e, i, ++j);
+
+			if (indeg(w) > 1)
+				loopyNodeMap[w] = j; // loopy node visited
+
+			s = PlanTSVs(w, j, adj, loopyNodeMap, plan);
+		}
+
+		tsvSlots.push_back(s);
+	}
+
+	if (bHasLoopyChild && i > 1)
+		s = PlanTSVs(v, plan);
+	else
+	{
+		TSVPlan::EigenJob job = { &adj, i, j, outdeg(v), 0.0 };
+
+		s = (int) plan.jobs.size();
+		plan.jobs.push_back(job);
+
+		plan.labels[v] = s;
+		plan.tsvs[v] = tsvSlots;
+		plan.hasTSV[v] = true;
+	}
+
+	return s;
+}
+
 leda::node DAG::GetNode(int nIndex)
 {
 	const leda::list<leda::node>& nodeList = all_nodes();
@@ -567,6 +1031,7 @@ DAG& DAG::operator=(const DAG& rhs)
 	Clear();
 
 	DAG_BASE_CLASS::operator=(rhs);
+	m_nEdits++;
 
 	m_nFileOffset = rhs.m_nFileOffset;
 	m_nDAGId      = rhs.m_nDAGId;
@@ -579,6 +1044,7 @@ DAG& DAG::operator=(const DAG& rhs)
 	m_nViewNumber1    = rhs.m_nViewNumber1;
 	m_strObjectName   = rhs.m_strObjectName;
 	m_transClosMat    = rhs.m_transClosMat;
+	m_ancestorMat     = rhs.m_ancestorMat;
 	m_nCumulativeMass = rhs.m_nCumulativeMass;
 	m_dDAGCost        = rhs.m_dDAGCost;
 
@@ -591,7 +1057,9 @@ DAG& DAG::operator=(const DAG& rhs)
 //! It sets to zero all the DAG's member variables
 void DAG::Clear()
 {
+	m_nEdits++;
 	DAG_BASE_CLASS::clear();
+	ReleaseArena();
 
 	m_nFileOffset = 0;
 	m_nDAGId = 0;
@@ -604,6 +1072,8 @@ void DAG::Clear()
 	m_nViewNumber1 = 0;
 	m_strObjectName.Clear();
 	m_transClosMat.Clear();
+	m_ancestorMat.Clear();
+	m_frozen.Clear();
 	m_nCumulativeMass = 0;
 
 	// Display parameters
@@ -694,6 +1164,8 @@ std::istream& DAG::Read(std::istream& is, bool bOnlyDataForMatching /*= false*/)
 
 	Clear();
 
+	MemoryArena::Scope arenaScope(GetArena());
+
 	// Save the offset where we are about to read from
 	m_nFileOffset = is.tellg();
 
@@ -735,6 +1207,7 @@ std::istream& DAG::Read(std::istream& is, bool bOnlyDataForMatching /*= false*/)
 	is.read((char*) &m_dDAGCost, sizeof(m_dDAGCost));
 
 	m_transClosMat.Read(is);
+	m_ancestorMat = m_transClosMat.Transpose();
 
 	is.read((char*) &m_nCumulativeMass, sizeof(m_nCumulativeMass));
 	ASSERT(m_nCumulativeMass >= GetNodeCount());
@@ -742,6 +1215,8 @@ std::istream& DAG::Read(std::istream& is, bool bOnlyDataForMatching /*= false*/)
 	// Read basic display parameters
 	is.read((char*) &m_dims, sizeof(m_dims));
 
+	Freeze();
+
 	return is;
 }
 
@@ -815,16 +1290,48 @@ void DAG::DelEdge(Matrix& adj, int srcNodeIdx, int tgtNodeIdx) const
 	\todo This function does not support some kinds of DAGs. More specifically,
 	DAGs with loops are not allowed. This must be fixed in the future.
 */
-void DAG::DeleteSubDAG(leda::node v)
+void DAG::DeleteSubDAG(leda::node v, bool bUpdateTSVs)
 {
 	leda::node u;
 
+	if (bUpdateTSVs)
+	{
+		leda::list<leda::node> parents;
+		leda::edge e;
+
+		forall_in_edges(e, v)
+			parents.append(source(e));
+
+		DeleteSubDAG(v, false);
+		UpdateTSVs(parents);
+		return;
+	}
+
 	forall_adj_nodes(u, v)
 		DeleteSubDAG(u);
 
 	del_node(v);
 }
 
+/*!
+	@brief Deletes the edge <e>. If bUpdateTSVs is true, the TSVs of
+	its source node and of the source's ancestors are updated.
+*/
+void DAG::DelEdge(leda::edge e, bool bUpdateTSVs)
+{
+	leda::node u = source(e);
+
+	del_edge(e);
+
+	if (bUpdateTSVs)
+	{
+		leda::list<leda::node> changedNodes;
+
+		changedNodes.append(u);
+		UpdateTSVs(changedNodes);
+	}
+}
+
 /*!
 	@brief Prints the DAG's adjacency matrix
 
@@ -913,6 +1420,16 @@ void DAG::SetObjectNameAndViewNumber(const String& path)
 	}
 }
 
+DAGMatcher* DAG::GetMatchingAlgorithm() const
+{
+	return MatchContext::Current().GetMatcher(*this);
+}
+
+void DAG::SetMatchingAlgorithm() const
+{
+	MatchContext::Current().ResetMatcher(ClassName().c_str());
+}
+
 void DAG::GetClassAndModel(char* szClassName, int* pModelId) const
 {
 	DirWalker::SplitPrefixAndNumber(GetObjName(), szClassName, pModelId);
@@ -40,8 +40,6 @@ LogFile g_dagMatchingLog("dagMatching.log", &DAG::s_bDbgMode);
 /////////////////////////////////////////////////////////////////////////////
 // DAGMatcher::MatchParams class implementation
 
-DAGMatcher::MatchParams DAGMatcher::s_matchParams;
-
 //! Initializes all matching parameter values to zero
 DAGMatcher::MatchParams::MatchParams()
 {
@@ -75,6 +73,46 @@ void DAGMatcher::MatchParams::Print(std::ostream& os) const
 /////////////////////////////////////////////////////////////////////////////
 // DAGMatcher class implementation
 
+void DAGMatcher::SetMatchParams(const MatchParams& matchParams)
+{
+	MatchContext::Current().SetParams(matchParams);
+}
+
+const DAGMatcher::MatchParams& DAGMatcher::GetMatchParams()
+{
+	return MatchContext::Current().GetParams();
+}
+
+MatchContext& DAGMatcher::Context() const
+{
+	return m_pContext ? *m_pContext : MatchContext::Current();
+}
+
+const DAGMatcher::MatchParams& DAGMatcher::Params() const
+{
+	return Context().GetParams();
+}
+
+/*!
+	The node similarities memoized by the previous match are dropped, since
+	the DAGs may have changed since then. They are all computed right away
+	if MatchParams::nNodeSimThreads asks for it, or else on demand.
+*/
+void DAGMatcher::StartMatch(const DAG* pDag1, const DAG* pDag2)
+{
+	m_pSimilarityMeasurer->ClearMemo();
+
+	InitGraphs(pDag1, pDag2);
+
+	int nThreads = Params().nNodeSimThreads;
+
+	if (nThreads < 0)
+		nThreads = (int) boost::thread::hardware_concurrency();
+
+	if (nThreads > 0)
+		m_pSimilarityMeasurer->ComputeAllNodeSimilarities(nThreads);
+}
+
 /*//! Virtual destructor
 DAGMatcher::~DAGMatcher()
 {
@@ -97,21 +135,53 @@ double DAGMatcher::NodeAttributeSimilarity(const DAG& g1, leda::node u, const DA
 	If both terms are zero, the similarity returned is 1.
 	If the numerator is grater than or equal to the numerator,
 	the TSV similarity is 0.
+
+	When both DAGs are frozen, the TSVs are read from their flat views,
+	which avoids allocating the difference vector.
 */
 double DAGMatcher::NodeTSVSimilarity(leda::node u, leda::node v) const
 {
-	const TSV& tsv1 = m_pDag1->GetNodeTSV(u);
-	const TSV& tsv2 = m_pDag2->GetNodeTSV(v);
+	double n1, n2, diffNorm;
+
+	if (m_pDag1->IsFrozen() && m_pDag2->IsFrozen())
+	{
+		const FrozenDAG& f1 = m_pDag1->GetFrozenView();
+		const FrozenDAG& f2 = m_pDag2->GetFrozenView();
+		int i = m_pDag1->GetNodeDFSIndex(u);
+		int j = m_pDag2->GetNodeDFSIndex(v);
+
+		n1 = f1.TSVNorm(i);
+		n2 = f2.TSVNorm(j);
+
+		if (n1 == 0 && n2 == 0)
+			return 1;
+
+		diffNorm = f1.TSVDiffNorm(i, f2, j);
+	}
+	else
+	{
+		n1 = m_pDag1->GetNodeTSVNorm(u);
+		n2 = m_pDag2->GetNodeTSVNorm(v);
+
+		if (n1 == 0 && n2 == 0)
+			return 1;
+
+		TSV diff = m_pDag1->GetNodeTSV(u) - m_pDag2->GetNodeTSV(v);
+		diffNorm = diff.Norm2();
+	}
 
-	double n1 = m_pDag1->GetNodeTSVNorm(u);
-	double n2 = m_pDag2->GetNodeTSVNorm(v);
+	return TSVSimilarity(diffNorm, n1, n2);
+}
 
+/*!
+	TSV similarity of two nodes whose children TSVs are diffNorm apart and
+	whose TSV norms are n1 and n2. See NodeTSVSimilarity().
+*/
+double DAGMatcher::TSVSimilarity(double diffNorm, double n1, double n2)
+{
 	if (n1 == 0 && n2 == 0)
 		return 1;
 
-	TSV diff = tsv1 - tsv2;
-	double diffNorm = diff.Norm2();
-
 	double max = MAX(n1, n2);
 
 	// max should be a normalization factor to ensure
@@ -158,8 +228,9 @@ double DAGMatcher::NodeSimilarity(leda::node u, leda::node v,
 	// Set the overall similarity value
 	if (dNodeSim > 0.0)
 	{
-		dSimilarity = s_matchParams.dTSVSimWeight * dEigenSim
-			+ (1 - s_matchParams.dTSVSimWeight) * dNodeSim;
+		const double& w = Params().dTSVSimWeight;
+
+		dSimilarity = w * dEigenSim + (1 - w) * dNodeSim;
 	}
 	else
 	{
@@ -171,7 +242,7 @@ double DAGMatcher::NodeSimilarity(leda::node u, leda::node v,
 	DBG_M_LOG_ONLY(g_dagMatchingLog.Print("Node similarity %s - %s: "
 		"node sim %f, tsv sim %f (%f), sim %f\n\n",
 		(CSTR) m_pDag1->GetNodeDFSLbl(u), (CSTR) m_pDag2->GetNodeDFSLbl(v),
-		dNodeSim, dEigenSim, s_matchParams.dTSVSimWeight, dSimilarity))
+		dNodeSim, dEigenSim, Params().dTSVSimWeight, dSimilarity))
 
 	ASSERT_VALID_NUM(dSimilarity);
 	ASSERT(dSimilarity >= 0);
@@ -180,4 +251,19 @@ double DAGMatcher::NodeSimilarity(leda::node u, leda::node v,
 		ptrMatchInfo->SetSimilarityValue(dSimilarity);
 
 	return dSimilarity;
+}
+
+/*!
+	NodeSimilarity() is zero or the weighted sum of the TSV similarity and
+	of an attribute similarity that is at most one, and zero when the types
+	differ if the measurer only compares nodes of the same type.
+*/
+double DAGMatcher::NodeSimilarityBound(double dTSVSimBound, bool bSameType) const
+{
+	if (!bSameType && m_pSimilarityMeasurer->ComparesOnlySameTypes())
+		return 0;
+
+	const double& w = Params().dTSVSimWeight;
+
+	return w * dTSVSimBound + (1 - w);
 }
\ No newline at end of file
@@ -170,7 +170,7 @@ double DAGMatcherAdaptive::Match(const DAG& g0, const DAG& g1)
 
 	// Set member variables so that the graph can be accessed from any member functions
 	// And by the similarity measurer object
-	InitGraphs(&g0, &g1);
+	StartMatch(&g0, &g1);
 
 	const int rootLevel = 1;
 
@@ -261,7 +261,7 @@ void DAGMatcherAdaptive::ComputeRootedTreeSimilarity(NodeAssignmentPtr ptrNodeAs
 
 	bestChildDist = ComputeRootedTreeSimilarity(ptrNodeAss, skipEdges, nodeSimilarity);
 
-	if (s_matchParams.nDisableNodeSkipping)
+	if (Params().nDisableNodeSkipping)
 		return; // we are done
 
 	for (int i = 0; i < 2; i++)
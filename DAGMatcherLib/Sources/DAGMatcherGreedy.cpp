@@ -64,19 +64,38 @@ double DAGMatcherGreedy::Match(const DAG& query, const DAG& model)
 	SmartMatrix<double> dbgMat;
 #endif
 
-	InitGraphs(&query, &model);
+	StartMatch(&query, &model);
 
 	simMat.Resize(n1, n2, true);
 
-	// Populate the similarity matrix
-	forall_nodes(q, query)
+	// Populate the similarity matrix. The frozen views give the nodes
+	// in DFS order, so the matrix is filled row by row.
+	if (query.IsFrozen() && model.IsFrozen())
+	{
+		const FrozenDAG& fq = query.GetFrozenView();
+		const FrozenDAG& fm = model.GetFrozenView();
+
+		for (i = 0; i < fq.Size(); i++)
+		{
+			if ((q = fq.Node(i)) == nil)
+				continue;
+
+			for (j = 0; j < fm.Size(); j++)
+				if ((m = fm.Node(j)) != nil)
+					simMat[i][j] = query.NodeSimilarity(q, model, m);
+		}
+	}
+	else
 	{
-		forall_nodes(m, model)
+		forall_nodes(q, query)
 		{
-			i = query.GetNodeDFSIndex(q);
-			j = model.GetNodeDFSIndex(m);
+			forall_nodes(m, model)
+			{
+				i = query.GetNodeDFSIndex(q);
+				j = model.GetNodeDFSIndex(m);
 
-			simMat[i][j] = query.NodeSimilarity(q, model, m);
+				simMat[i][j] = query.NodeSimilarity(q, model, m);
+			}
 		}
 	}
 
@@ -88,7 +107,7 @@ double DAGMatcherGreedy::Match(const DAG& query, const DAG& model)
 
 		simMat.Print(g_dagMatchingLog, 6, 3, true);
 		g_dagMatchingLog.Print("\n\n");
-		s_matchParams.Print(g_dagMatchingLog);
+		Params().Print(g_dagMatchingLog);
 		dbgMat = simMat;
 	}
 #endif
@@ -184,15 +203,16 @@ double DAGMatcherGreedy::Match(DAG& g1, DAG& g2, SimMatrix& simMat,
 
 	// Take the endpoints of the max weight edge
 	leda::node maxG1Node, maxG2Node;
-	leda::node_array<leda::node>& nodes = G.node_data();
+	const leda::node_array<leda::node>& nodes = G.node_data();
 
 	maxG1Node = nodes[G.source(max_edge)];
 	maxG2Node = nodes[G.target(max_edge)];
 
 	// Append the found nodes to the matching dict.
-	// mark one with another's global number.
-	DAGNodePtr maxG1NodePtr = g1.GetNode(maxG1Node);
-	DAGNodePtr maxG2NodePtr = g2.GetNode(maxG2Node);
+	// mark one with another's global number. Read through
+	// the const accessors, which don't count as edits.
+	DAGNodePtr maxG1NodePtr = ((const DAG&) g1).GetNode(maxG1Node);
+	DAGNodePtr maxG2NodePtr = ((const DAG&) g2).GetNode(maxG2Node);
 
 	m_nodeMap1[maxG1NodePtr] = maxG2NodePtr;
 	m_nodeMap2[maxG2NodePtr] = maxG1NodePtr;
@@ -231,7 +251,7 @@ double DAGMatcherGreedy::Match(DAG& g1, DAG& g2, SimMatrix& simMat,
 	if (g1.GetNodeCount() > 0 && g2.GetNodeCount() > 0)
 	{
 		// ...update sim matrix to avoid breaking hierarchical constraints...
-		pMatchedPair->UpdateSimMat(simMat, s_matchParams.dBreakSiblingRelPen);
+		pMatchedPair->UpdateSimMat(simMat, Params().dBreakSiblingRelPen);
 
 		// ...and then recurse on the complement graph
 		max_weight += Match(g1, g2, simMat, pMatchedPair);
@@ -274,7 +294,7 @@ leda::edge DAGMatcherGreedy::ComputeBipartiteGraph(LEDA_GRAPH<leda::node, double
 		if (pMatchedPair->GetModelNode() != g2.GetNodeDFSIndex(u))
 			B.push(G.new_node(u));
 
-	leda::node_array<leda::node>& nodes = G.node_data();
+	const leda::node_array<leda::node>& nodes = G.node_data();
 
 	// Create a bipartite graph between A and B nodes.
 	// do not establish edges between nodes that have been matched.
@@ -313,7 +333,7 @@ leda::edge DAGMatcherGreedy::ComputeBipartiteGraph(LEDA_GRAPH<leda::node, double
 	leda::edge e;
 	int i, j;
 
-	ASSERT_UNIT_INTERVAL(s_matchParams.dBreakSiblingRelPen);
+	ASSERT_UNIT_INTERVAL(Params().dBreakSiblingRelPen);
 
 	forall_edges(e, G)
 	{
@@ -323,7 +343,7 @@ leda::edge DAGMatcherGreedy::ComputeBipartiteGraph(LEDA_GRAPH<leda::node, double
 		i = g1.GetNodeDFSIndex(g1Node);
 		j = g2.GetNodeDFSIndex(g2Node);
 
-		if (GetMatchParams().nPreserveAncestorRel)
+		if (Params().nPreserveAncestorRel)
 		{
 			if (!pMatchedPair->IsEmpty() && !pMatchedPair->AncestorRelPreserved(i, j))
 				simMat[i][j] = 0;
@@ -363,7 +383,7 @@ leda::edge DAGMatcherGreedy::ComputeBipartiteGraph(LEDA_GRAPH<leda::node, double
 	int m1, m2;
 	// end debug
 
-	const double& smw = s_matchParams.dSimilMassWeight;
+	const double& smw = Params().dSimilMassWeight;
 	ASSERT_UNIT_INTERVAL(smw);
 
 	/*
@@ -19,7 +19,7 @@
 
 #include "stdafx.h"
 
-void dml::DAGMatcherLib::InitDAGMatcherLib() {
+void dml::DAGMatcherLib::InitDAGMatcherLib() throw(StandardExcept) {
 	graphDBLib::GraphDB::CommonInterface::getGraphClass("BoneGraph", true, true);
 	graphDBLib::GraphDB::CommonInterface::getGraphClass("GestureGraph", true, true);
 	graphDBLib::GraphDB::CommonInterface::getGraphClass("ShockGraph", true, true);
@@ -31,14 +31,14 @@
 
 #include "stdafx.h"
 
+#include <map>
+
 using namespace dml;
 
 #ifdef _DEBUG
 extern LogFile g_dagMatchingLog;
 #endif
 
-int g_counter;
-
 /*!
 	@brief
 
@@ -48,20 +48,20 @@ double DAGMatcherOptimal::Match(const DAG& g1, const DAG& g2)
 {
 	SolutionQueue sq;
 
-	g_counter = 0;
+	Context().nExpandedSolSets = 0;
 
 	m_bIsSolSetFull = false;
 
 	//g_dagMatchingLog.precision(50);
 	DBG_M_LOG("Matching " << g1.GetDAGLbl() << " against " << g2.GetDAGLbl())
-	DBG_M_LOG_ONLY(DAGMatcher::GetMatchParams().Print(g_dagMatchingLog))
+	DBG_M_LOG_ONLY(Params().Print(g_dagMatchingLog))
 
 	// Set the type of sorting that we used for the node assignments
 	//m_sortType = BipartiteNodeGraph::SORT_BY_SIMILARITY;
 	//m_sortType = BipartiteNodeGraph::SORT_BY_CERTAINTY_AND_SIMILARITY;
 	//m_sortType = nNodeAssignSortType
 
-	InitGraphs(&g1, &g2);
+	StartMatch(&g1, &g2);
 
 	// Start by setting the best set as the empty set
 	m_ptrBestSet = new SolutionSet(g1, g2, false /*ie, don't include root nodes*/);
@@ -79,8 +79,7 @@ double DAGMatcherOptimal::Match(const DAG& g1, const DAG& g2)
 	m_ptrBestSet->AssignOneToOneCorrespondences(GetSortType());
 
 	// Insert the set to the queue so that it can be retrieved later
-	//sq.insert(m_ptrBestSet->TotalSimilarityEstimate(), m_ptrBestSet);
-	sq.append(m_ptrBestSet);
+	sq.insert(-m_ptrBestSet->TotalSimilarityEstimate(), m_ptrBestSet);
 
 	// Update m_ptrBestSet with the true best set
 	FindBestNodeAssigment(sq);
@@ -89,7 +88,7 @@ double DAGMatcherOptimal::Match(const DAG& g1, const DAG& g2)
 	DBG_M_LOG_ONLY(m_ptrBestSet->Print(g_dagMatchingLog))
 
 	//m_ptrBestSet->Print(std::cout);
-	//std::cout << " iter count " << g_counter << std::flush;
+	//std::cout << " iter count " << Context().nExpandedSolSets << std::flush;
 
 	//const double maxSimVal = MAX(N0,N1);
 
@@ -102,19 +101,55 @@ double DAGMatcherOptimal::Match(const DAG& g1, const DAG& g2)
 	return graphSim;
 }
 
+//! Sets of node pairs seen, with the highest partial similarity they were reached with
+typedef std::map<SolutionSet::CommittedPairs, double> SeenSetMap;
+
+/*!
+	True if the node pairs of the set were reached before (in another order)
+	with at least the same partial similarity. The remaining bipartite graph
+	is the same, so the set can't lead to a better solution. Otherwise, the
+	set is recorded as the best way of reaching its node pairs.
+*/
+static bool IsDominated(const SolutionSetPtr& ptrSet, SeenSetMap& seenSets,
+	SolutionSet::CommittedPairs& pairs)
+{
+	ptrSet->GetCommittedPairs(&pairs);
+
+	SeenSetMap::iterator it = seenSets.find(pairs);
+
+	if (it != seenSets.end() && it->second >= ptrSet->PartialSimilarity())
+		return true;
+
+	seenSets[pairs] = ptrSet->PartialSimilarity();
+
+	return false;
+}
+
 /*!
 	@brief Performs an A* search for the best one-to-one node assigment between
 	the the two graphs associated with the solution sets in the queue.
 
-	The algorithm starts by retrieving the solution set with highest
-	"total similarity estimate" from the queue andprocessing it if such similarity
-	value is higher than the partial similarity of the best set seen.
+	The solution set with the highest "total similarity estimate" is retrieved
+	from the queue and expanded, by creating a new set for each of its
+	uncommitted correspondences. The estimate is an upper bound of the
+	similarity that can be reached from the set, since the similarity of the
+	nodes not in the set is the value of a relaxed assignment (the maximum
+	weight assignment or, without the MWBM heuristic, the best value of each
+	node) that can only decrease as correspondences are committed.
 
 	Note: the "best set" is the solution set that has the highest "partial
 	similarity" value among all solution sets seen. Since such similarity is not
 	an estimate, it represents a conservative value of the final similarity,
 	while the total similarity estimate is an optimistic similarity.
 
+	Hence, the search stops as soon as the best estimate in the queue can't
+	beat the best set, and new sets are only queued if they could. Sets that
+	commit the same node pairs as a set seen before, with a lower similarity,
+	are dropped.
+
+	The search is also stopped by the limits in the match params, which makes
+	the best set seen so far the result (see IsOptimal()).
+
 	@param sq queue of solution sets to process order by prority
 	@param m_ptrBestSet shared pointer to the known set with highest partial similarity
 
@@ -122,65 +157,93 @@ double DAGMatcherOptimal::Match(const DAG& g1, const DAG& g2)
 */
 void DAGMatcherOptimal::FindBestNodeAssigment(SolutionQueue& sq)
 {
-	if (sq.empty())
-		return;
-
-	DBG_M_LOG("Begin processing a solution set\n")
-
-	g_counter++;
-
-	SolutionSetPtr ptrSet = sq.pop();
-
-	const SolutionSet::NodeAssignments& nodeAssigList = ptrSet->GetNodeAssignments();
-	SolutionSet::NodeAssignment nodeAssig;
-	SolutionSetPtr ptrNewSet;
-	int localBranching = 0;
-
+	const int nMaxExpandedSolSets = Params().nMaxExpandedSolSets;
+	long& nExpandedSolSets = Context().nExpandedSolSets;
+	SeenSetMap seenSets;
+	SolutionSet::CommittedPairs pairs;
+	SolutionSetPtr ptrSet, ptrNewSet;
+	leda::list_item it;
 	double weight;
 
-	//DBG_M_LOG_ONLY(ptrSet->PrintAssignments(g_dagMatchingLog))
+	m_bIsOptimal = true;
 
-	// Iterate through all uncommitted correspondences in the set (there may be none)
-	// The correspondences are sorted by decreasing similarity value
-	forall(nodeAssig, nodeAssigList)
+	while (!sq.empty())
 	{
-		nodeAssig.second()->GetPenalizedSimilarityValue(&weight);
+		SolutionQueueItem top = sq.find_min();
+
+		ptrSet = sq.inf(top);
+		sq.del_item(top);
 
-		if (weight == 0)
+		// The sets are sorted by estimate, so none of the rest can do better
+		if (ptrSet->TotalSimilarityEstimate() <= m_ptrBestSet->PartialSimilarity())
 			break;
 
-		// Create a new solution set with the current node correspondece in it
-		ptrNewSet = new SolutionSet(ptrSet, nodeAssig.second());
+		if (nMaxExpandedSolSets > 0 && nExpandedSolSets >= nMaxExpandedSolSets)
+		{
+			m_bIsOptimal = false;
+			break;
+		}
 
-		// Reassign the node correspondences by accounting for the
-		// constraints imposed by the commited correspondece
-		if (DAGMatcher::GetMatchParams().nUseMWBMHeuristic)
-			ptrNewSet->AssignOneToOneCorrespondences(GetSortType());
-		else
-			ptrNewSet->AssignNonZeroCorrespondences(GetSortType());
+		DBG_M_LOG("Begin processing a solution set\n")
 
-		// If the new set has a higher partial similarity,
-		// it becomes the new "gold standard" used to prune the search
-		if (ptrNewSet->PartialSimilarity() >= m_ptrBestSet->PartialSimilarity())
-			m_ptrBestSet = ptrNewSet;
+		nExpandedSolSets++;
 
-		sq.append(ptrNewSet);
+		const SolutionSet::NodeAssignments& nodeAssigList = ptrSet->GetNodeAssignments();
+		int localBranching = 0;
 
-		localBranching++;
+		//DBG_M_LOG_ONLY(ptrSet->PrintAssignments(g_dagMatchingLog))
 
-		if (sq.size() >= GetMatchParams().nMaxNumSolSets)
+		// Iterate through all uncommitted correspondences in the set (there may be none)
+		// The correspondences are sorted by decreasing similarity value
+		forall_items(it, nodeAssigList)
 		{
-			m_bIsSolSetFull = true;
-			break;
+			const SolutionSet::NodeAssignment& nodeAssig = nodeAssigList[it];
+
+			nodeAssig.second()->GetPenalizedSimilarityValue(&weight);
+
+			if (weight == 0)
+				break;
+
+			// Create a new solution set with the current node correspondece in it
+			ptrNewSet = new SolutionSet(ptrSet, nodeAssig.second());
+
+			// Reassign the node correspondences by accounting for the
+			// constraints imposed by the commited correspondece
+			if (Params().nUseMWBMHeuristic)
+				ptrNewSet->AssignOneToOneCorrespondences(GetSortType());
+			else
+				ptrNewSet->AssignNonZeroCorrespondences(GetSortType());
+
+			// If the new set has a higher partial similarity,
+			// it becomes the new "gold standard" used to prune the search
+			if (ptrNewSet->PartialSimilarity() >= m_ptrBestSet->PartialSimilarity())
+				m_ptrBestSet = ptrNewSet;
+
+			localBranching++;
+
+			// Only queue the sets that may beat the best set
+			if (ptrNewSet->TotalSimilarityEstimate() > m_ptrBestSet->PartialSimilarity() &&
+				!IsDominated(ptrNewSet, seenSets, pairs))
+			{
+				sq.insert(-ptrNewSet->TotalSimilarityEstimate(), ptrNewSet);
+
+				if (sq.size() >= Params().nMaxNumSolSets)
+				{
+					m_bIsSolSetFull = true;
+					m_bIsOptimal = false;
+					break;
+				}
+			}
+
+			if (localBranching >= Params().nMaxSolSetsPerIter)
+			{
+				if (nodeAssigList.succ(it) != nil)
+					m_bIsOptimal = false;
+
+				break;
+			}
 		}
-
-		if (localBranching >= GetMatchParams().nMaxSolSetsPerIter)
-			break;
 	}
-
-	// Process the local queue first (ie, do a depth search) in order
-	// to improve the best partial similarity known
-	FindBestNodeAssigment(sq);
 }
 
 double GetBGNodeSaliency(leda::node v, const DAG& g, const double& maxLength)
@@ -214,7 +277,7 @@ double TotalSaliency(const DAG& g, const double& maxLength)
 
 double DAGMatcherOptimal::ComputeNormalizationFactor(const DAG& g1, const DAG& g2)
 {
-	const double maxLength = s_matchParams.dSaliencyParam;
+	const double maxLength = Params().dSaliencyParam;
 
 	double totSal1 = TotalSaliency(g1, maxLength);
 	double totSal2 = TotalSaliency(g2, maxLength);
@@ -230,6 +293,9 @@ double DAGMatcherOptimal::ComputeNormalizationFactor(const DAG& g1, const DAG& g
 
 	leda::node v;
 
+	// matSal1 and matSal2 are assigned, not summed, so they end up with the
+	// saliencies of the last matched pair only. SimilarityBound() relies on
+	// it: it must be revised if they ever become sums.
 	forall_nodes(v, g1)
 	{
 		if (!nodeMap[v].IsEmpty())
@@ -243,4 +309,48 @@ double DAGMatcherOptimal::ComputeNormalizationFactor(const DAG& g1, const DAG& g
 	double unmatchedSal = totSal1 + totSal2 - matSal1 - matSal2;
 
 	return n + unmatchedSal;
+}
+
+//! Largest saliency of the nodes of g
+static double MaxSaliency(const DAG& g, const double& maxLength)
+{
+	leda::node v;
+	double maxSal = 0;
+
+	forall_nodes(v, g)
+	{
+		maxSal = MAX(maxSal, GetBGNodeSaliency(v, g, maxLength));
+	}
+
+	return maxSal;
+}
+
+/*!
+	Match() divides the similarity sum S by n + U, where n is the number of
+	node pairs, each with a similarity of at most one, and U is the
+	saliency left unmatched. ComputeNormalizationFactor() only subtracts the
+	saliencies of one pair (the last matched) from the total saliency, so U
+	is at least the total saliency minus the largest saliency of each graph,
+	and the similarity is at most S / (S + U). If it subtracted the
+	saliencies of every matched pair, this would no longer be a bound.
+
+	Only bone graph nodes have a saliency. Otherwise, U is zero and the
+	bound is one unless S is.
+*/
+double DAGMatcherOptimal::SimilarityBound(const DAG& g1, const DAG& g2, double dNodeSimSum) const
+{
+	if (dNodeSimSum <= 0)
+		return 0;
+
+	double minUnmatchedSal = 0;
+
+	if (dynamic_cast<const BoneGraph*>(&g1) && dynamic_cast<const BoneGraph*>(&g2))
+	{
+		const double maxLength = Params().dSaliencyParam;
+
+		minUnmatchedSal = TotalSaliency(g1, maxLength) + TotalSaliency(g2, maxLength)
+			- MaxSaliency(g1, maxLength) - MaxSaliency(g2, maxLength);
+	}
+
+	return dNodeSimSum / (dNodeSimSum + MAX(minUnmatchedSal, 0));
 }
\ No newline at end of file
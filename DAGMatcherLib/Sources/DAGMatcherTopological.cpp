@@ -109,7 +109,7 @@ double DAGMatcherTopological::Match(const DAG& g0, const DAG& g1)
 
 	// Set member variables so that the graph can be accessed from any member functions
 	// And by the similarity measurer object
-	InitGraphs(&g0, &g1);
+	StartMatch(&g0, &g1);
 
 	// Create a graph with n1 + n2 nodes and save the nodes
 	// associated with the g1 and g2 in different sets
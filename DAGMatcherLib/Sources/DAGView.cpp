@@ -33,6 +33,8 @@
 
 #include "stdafx.h"
 
+#ifndef DML_NO_LEDA // The views need the LEDA windows
+
 // DAGView window params
 #define SW_LEFT_MARGIN    50
 #define SW_RIGHT_MARGIN   50
@@ -896,4 +898,6 @@ void DAGView::DrawTable()
 
 		m_pWnd->draw_segment(xmin + dx, ymin, xmin + dx, ymax, leda::black);
 	}
-}
\ No newline at end of file
+}
+
+#endif // DML_NO_LEDA
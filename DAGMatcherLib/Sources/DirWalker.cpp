@@ -38,7 +38,13 @@
  *-----------------------------------------------------------------------*/
 //#include <iostream>
 #include "stdafx.h"
+
+#ifdef WIN32
 # include <windows.h>
+#else
+# include <errno.h>
+# define INVALID_HANDLE_VALUE NULL
+#endif
 
 DirWalker::DirWalker()
 {
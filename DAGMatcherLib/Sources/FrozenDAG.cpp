@@ -0,0 +1,162 @@
+/* ************* Begin file FrozenDAG.cpp ***************************************/
+/*
+** 2015 October 07
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file FrozenDAG.cpp
+*	\brief FrozenDAG source file.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+
+using namespace dml;
+
+void FrozenDAG::Clear()
+{
+	m_pDag = NULL;
+	m_nEdits = 0;
+
+	m_nodes.clear();
+	m_childOffsets.assign(1, 0);
+	m_children.clear();
+	m_parentOffsets.assign(1, 0);
+	m_parents.clear();
+
+	m_types.clear();
+	m_masses.clear();
+	m_levels.clear();
+	m_tsvNorms.clear();
+	m_childTSVNorms.clear();
+	m_subtreeCosts.clear();
+
+	m_tsvOffsets.assign(1, 0);
+	m_tsvValues.clear();
+}
+
+bool FrozenDAG::IsBuiltFrom(const DAG& dag) const
+{
+	return m_pDag == &dag && m_nEdits == dag.GetEditCount();
+}
+
+/*!
+	Copies the structure and the node attributes of the DAG. The DFS
+	indices, masses, levels and TSVs must have been computed, ie,
+	DAG::ComputeDerivedValues() or DAG::Read() must have been called.
+*/
+void FrozenDAG::Build(const DAG& dag)
+{
+	leda::node v;
+	leda::edge e;
+	int i, n = 0, nTSVValues = 0;
+
+	Clear();
+
+	forall_nodes(v, dag)
+	{
+		ASSERT(dag.GetNodeDFSIndex(v) >= 0);
+
+		n = MAX(n, dag.GetNodeDFSIndex(v) + 1);
+		nTSVValues += dag.GetNodeTSV(v).GetSize();
+	}
+
+	m_nodes.assign(n, nil);
+	m_types.assign(n, 0);
+	m_masses.assign(n, 0);
+	m_levels.assign(n, 0);
+	m_tsvNorms.assign(n, 0);
+	m_childTSVNorms.assign(n, 0);
+	m_subtreeCosts.assign(n, 0);
+
+	m_childOffsets.assign(n + 1, 0);
+	m_parentOffsets.assign(n + 1, 0);
+	m_tsvOffsets.assign(n + 1, 0);
+
+	forall_nodes(v, dag)
+	{
+		i = dag.GetNodeDFSIndex(v);
+
+		m_nodes[i]        = v;
+		m_types[i]        = dag.NodeType(v);
+		m_masses[i]       = dag.GetNodeMass(v);
+		m_levels[i]       = dag.GetNodeLevel(v);
+		m_tsvNorms[i]     = dag.GetNodeTSVNorm(v);
+		m_childTSVNorms[i] = dag.GetNodeTSV(v).Norm2();
+		m_subtreeCosts[i] = dag.GetSubtreeCost(v);
+
+		// Counts first, turned into offsets below
+		m_childOffsets[i + 1]  = dag.outdeg(v);
+		m_parentOffsets[i + 1] = dag.indeg(v);
+		m_tsvOffsets[i + 1]    = dag.GetNodeTSV(v).GetSize();
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		m_childOffsets[i + 1]  += m_childOffsets[i];
+		m_parentOffsets[i + 1] += m_parentOffsets[i];
+		m_tsvOffsets[i + 1]    += m_tsvOffsets[i];
+	}
+
+	m_children.resize(m_childOffsets[n]);
+	m_parents.resize(m_parentOffsets[n]);
+	m_tsvValues.resize(nTSVValues);
+
+	for (i = 0; i < n; i++)
+	{
+		if ((v = m_nodes[i]) == nil)
+			continue;
+
+		int k = m_childOffsets[i];
+
+		forall_out_edges(e, v)
+			m_children[k++] = dag.GetNodeDFSIndex(dag.target(e));
+
+		k = m_parentOffsets[i];
+
+		forall_in_edges(e, v)
+			m_parents[k++] = dag.GetNodeDFSIndex(dag.source(e));
+
+		const TSV& tsv = dag.GetNodeTSV(v);
+
+		k = m_tsvOffsets[i];
+
+		for (int d = 0; d < tsv.GetSize(); d++)
+			m_tsvValues[k++] = tsv[d];
+	}
+
+	m_pDag = &dag;
+	m_nEdits = dag.GetEditCount();
+}
+
+double FrozenDAG::TSVDiffNorm(int i, const FrozenDAG& g, int j) const
+{
+	const double* a = TSVData(i);
+	const double* b = g.TSVData(j);
+	const int na = TSVSize(i);
+	const int nb = g.TSVSize(j);
+	double d, sum = 0;
+	int k;
+
+	for (k = 0; k < na && k < nb; k++)
+	{
+		d = a[k] - b[k];
+		sum += d * d;
+	}
+
+	for (; k < na; k++)
+		sum += a[k] * a[k];
+
+	for (; k < nb; k++)
+		sum += b[k] * b[k];
+
+	return sqrt(sum);
+}
@@ -33,7 +33,7 @@
 
 #include "stdafx.h"
 
-#ifdef _DEBUG
+#if defined(_DEBUG) && !defined(DML_NO_LEDA)
 #define GSG_ENABLE_GRAPH_WIN
 #endif
 
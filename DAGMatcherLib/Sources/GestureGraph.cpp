@@ -61,10 +61,6 @@ void SkipComments(ifstream& is)
 	is.seekg(-1, ios::cur);
 }
 
-/////////////////////////////////////////////////////////////////////////////////
-// Init static variables
-DAGMatcher* GestureGraph::s_pDAGMatcher = NULL;
-
 /////////////////////////////////////////////////////////////////////////////
 // GestureGraph class implementation
 
@@ -106,6 +102,8 @@ bool GestureGraph::Read(String strFileName)
 
 	SkipComments(is);
 
+	MemoryArena::Scope arenaScope(GetArena());
+
 	for(n = 0; n < nVertices; n++)
 	{
 		p = new GGNode;
@@ -373,7 +371,8 @@ double GestureGraph::NodeAttributeDistance(leda_node u, const DAG& from, leda_no
  return (hist_distance + hist_scale) / 2.0;
 }*/
 
-void GestureGraph::SetMatchingAlgorithm()
+DAGMatcher* GestureGraph::CreateMatchingAlgorithm(const DAGMatcher::MatchParams& params) const
 {
 	//TODO: fill in code here
+	return NULL;
 }
\ No newline at end of file
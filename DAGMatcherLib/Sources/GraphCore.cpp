@@ -0,0 +1,510 @@
+/* ************* Begin file GraphCore.cpp ***************************************/
+/*
+** 2015 October 08
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file GraphCore.cpp
+*	\brief GraphCore source file. Only compiled in when DML_NO_LEDA is defined.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+
+#ifdef DML_NO_LEDA
+
+#include <limits>
+
+using namespace dml::gc;
+
+/* *******************************************************************
+*                               Graphs                               *
+ ********************************************************************/
+
+void graph::init()
+{
+	m_firstNode = m_lastNode = nil;
+	m_firstEdge = m_lastEdge = nil;
+	m_nNodes = m_nEdges = 0;
+	m_nNextNodeId = m_nNextEdgeId = 0;
+}
+
+void graph::link_out(edge e)
+{
+	node v = e->s;
+
+	e->outNext = nil;
+	e->outPrev = v->lastOut;
+	(v->lastOut ? v->lastOut->outNext : v->firstOut) = e;
+	v->lastOut = e;
+	v->outdeg++;
+}
+
+void graph::link_in(edge e)
+{
+	node w = e->t;
+
+	e->inNext = nil;
+	e->inPrev = w->lastIn;
+	(w->lastIn ? w->lastIn->inNext : w->firstIn) = e;
+	w->lastIn = e;
+	w->indeg++;
+}
+
+void graph::unlink_out(edge e)
+{
+	node v = e->s;
+
+	(e->outPrev ? e->outPrev->outNext : v->firstOut) = e->outNext;
+	(e->outNext ? e->outNext->outPrev : v->lastOut) = e->outPrev;
+	v->outdeg--;
+}
+
+void graph::unlink_in(edge e)
+{
+	node w = e->t;
+
+	(e->inPrev ? e->inPrev->inNext : w->firstIn) = e->inNext;
+	(e->inNext ? e->inNext->inPrev : w->lastIn) = e->inPrev;
+	w->indeg--;
+}
+
+node graph::new_node()
+{
+	node v = new node_struct;
+
+	v->id = m_nNextNodeId++;
+	v->owner = this;
+	v->firstOut = v->lastOut = nil;
+	v->firstIn = v->lastIn = nil;
+	v->outdeg = v->indeg = 0;
+
+	v->next = nil;
+	v->prev = m_lastNode;
+	(m_lastNode ? m_lastNode->next : m_firstNode) = v;
+	m_lastNode = v;
+	m_nNodes++;
+
+	return v;
+}
+
+edge graph::new_edge(node v, node w)
+{
+	if (v->owner != this || w->owner != this)
+		error_handler(1, "graph::new_edge: node from another graph");
+
+	edge e = new edge_struct;
+
+	e->id = m_nNextEdgeId++;
+	e->s = v;
+	e->t = w;
+
+	e->next = nil;
+	e->prev = m_lastEdge;
+	(m_lastEdge ? m_lastEdge->next : m_firstEdge) = e;
+	m_lastEdge = e;
+	m_nEdges++;
+
+	link_out(e);
+	link_in(e);
+
+	return e;
+}
+
+void graph::del_edge(edge e)
+{
+	release_inf(e);
+
+	unlink_out(e);
+	unlink_in(e);
+
+	(e->prev ? e->prev->next : m_firstEdge) = e->next;
+	(e->next ? e->next->prev : m_lastEdge) = e->prev;
+	m_nEdges--;
+
+	delete e;
+}
+
+void graph::del_node(node v)
+{
+	while (v->firstOut)
+		del_edge(v->firstOut);
+
+	while (v->firstIn)
+		del_edge(v->firstIn);
+
+	release_inf(v);
+
+	(v->prev ? v->prev->next : m_firstNode) = v->next;
+	(v->next ? v->next->prev : m_lastNode) = v->prev;
+	m_nNodes--;
+
+	delete v;
+}
+
+void graph::del_all_edges()
+{
+	while (m_firstEdge)
+		del_edge(m_firstEdge);
+}
+
+void graph::del_nodes(const list<node>& L)
+{
+	for (list_item it = L.first(); it != nil; it = L.succ(it))
+		del_node(L[it]);
+}
+
+void graph::del_edges(const list<edge>& L)
+{
+	for (list_item it = L.first(); it != nil; it = L.succ(it))
+		del_edge(L[it]);
+}
+
+void graph::clear()
+{
+	edge e, ne;
+	node v, nv;
+
+	for (e = m_firstEdge; e; e = ne)
+	{
+		ne = e->next;
+		delete e;
+	}
+
+	for (v = m_firstNode; v; v = nv)
+	{
+		nv = v->next;
+		delete v;
+	}
+
+	init();
+	reset_infs();
+}
+
+void graph::move_edge(edge e, node v, node w)
+{
+	unlink_out(e);
+	unlink_in(e);
+
+	e->s = v;
+	e->t = w;
+
+	link_out(e);
+	link_in(e);
+}
+
+void graph::copy_structure(const graph& G, std::vector<node>& nodes, std::vector<edge>& edges)
+{
+	std::vector<node> nodeMap(G.max_node_index() + 1, (node) nil);
+	node v;
+	edge e;
+
+	clear();
+
+	nodes.clear();
+	edges.clear();
+	nodes.reserve(G.number_of_nodes());
+	edges.reserve(G.number_of_edges());
+
+	for (v = G.first_node(); v; v = G.succ_node(v))
+	{
+		nodes.push_back(new_node());
+		nodeMap[v->id] = nodes.back();
+	}
+
+	for (e = G.first_edge(); e; e = G.succ_edge(e))
+		edges.push_back(new_edge(nodeMap[e->s->id], nodeMap[e->t->id]));
+
+	// Keep the order of the adjacency lists of G
+	for (v = G.first_node(); v; v = G.succ_node(v))
+	{
+		node u = nodeMap[v->id];
+
+		u->firstOut = u->lastOut = nil;
+		u->firstIn = u->lastIn = nil;
+		u->outdeg = u->indeg = 0;
+	}
+
+	std::vector<edge> edgeMap(G.max_edge_index() + 1, (edge) nil);
+	size_t k = 0;
+
+	for (e = G.first_edge(); e; e = G.succ_edge(e))
+		edgeMap[e->id] = edges[k++];
+
+	for (v = G.first_node(); v; v = G.succ_node(v))
+	{
+		for (e = v->firstOut; e; e = e->outNext)
+			link_out(edgeMap[e->id]);
+
+		for (e = v->firstIn; e; e = e->inNext)
+			link_in(edgeMap[e->id]);
+	}
+}
+
+graph& graph::operator=(const graph& G)
+{
+	if (this != &G)
+	{
+		std::vector<node> nodes;
+		std::vector<edge> edges;
+
+		copy_structure(G, nodes, edges);
+	}
+
+	return *this;
+}
+
+dml::gc::list<node> graph::all_nodes() const
+{
+	list<node> L;
+
+	for (node v = m_firstNode; v; v = v->next)
+		L.append(v);
+
+	return L;
+}
+
+dml::gc::list<edge> graph::all_edges() const
+{
+	list<edge> L;
+
+	for (edge e = m_firstEdge; e; e = e->next)
+		L.append(e);
+
+	return L;
+}
+
+/* *******************************************************************
+*                             Algorithms                             *
+ ********************************************************************/
+
+bool dml::gc::TOPSORT(const graph& G, node_array<int>& ord)
+{
+	node_array<int> indegs(G, 0);
+	std::vector<node> ready;
+	node v;
+	edge e;
+	int n = 0;
+
+	ord.init(G, 0);
+
+	for (v = G.first_node(); v; v = G.succ_node(v))
+		if ((indegs[v] = G.indeg(v)) == 0)
+			ready.push_back(v);
+
+	while (!ready.empty())
+	{
+		v = ready.back();
+		ready.pop_back();
+		ord[v] = ++n;
+
+		for (e = G.first_adj_edge(v); e; e = G.adj_succ(e))
+			if (--indegs[G.target(e)] == 0)
+				ready.push_back(G.target(e));
+	}
+
+	return n == G.number_of_nodes();
+}
+
+bool dml::gc::TOPSORT(const graph& G, list<node>& L)
+{
+	node_array<int> ord;
+	std::vector<node> nodes(G.number_of_nodes());
+	node v;
+
+	L.clear();
+
+	if (!TOPSORT(G, ord))
+		return false;
+
+	for (v = G.first_node(); v; v = G.succ_node(v))
+		nodes[ord[v] - 1] = v;
+
+	for (size_t i = 0; i < nodes.size(); i++)
+		L.append(nodes[i]);
+
+	return true;
+}
+
+int dml::gc::COMPONENTS(const graph& G, node_array<int>& compnum)
+{
+	std::vector<node> stack;
+	node v, u;
+	edge e;
+	int c = 0;
+
+	compnum.init(G, -1);
+
+	for (v = G.first_node(); v; v = G.succ_node(v))
+	{
+		if (compnum[v] != -1)
+			continue;
+
+		compnum[v] = c;
+		stack.push_back(v);
+
+		while (!stack.empty())
+		{
+			u = stack.back();
+			stack.pop_back();
+
+			for (e = u->firstOut; e; e = e->outNext)
+				if (compnum[e->t] == -1)
+				{
+					compnum[e->t] = c;
+					stack.push_back(e->t);
+				}
+
+			for (e = u->firstIn; e; e = e->inNext)
+				if (compnum[e->s] == -1)
+				{
+					compnum[e->s] = c;
+					stack.push_back(e->s);
+				}
+		}
+
+		c++;
+	}
+
+	return c;
+}
+
+/*!
+	The nodes with out edges form one side and the nodes with in edges
+	the other. The assignment problem on the dense |A| x |B| profit matrix
+	is solved with the Hungarian method (shortest augmenting paths with
+	potentials, O(n^3)). Missing and non-positive edges have a profit of zero
+	and are left out of the result.
+*/
+dml::gc::list<edge> dml::gc::MAX_WEIGHT_BIPARTITE_MATCHING(const graph& G, const edge_array<double>& c)
+{
+	node_array<int> side(G, -1);
+	std::vector<node> A, B;
+	list<edge> result;
+	node v;
+	edge e;
+
+	for (v = G.first_node(); v; v = G.succ_node(v))
+	{
+		if (G.outdeg(v) > 0 && G.indeg(v) > 0)
+			error_handler(1, "MAX_WEIGHT_BIPARTITE_MATCHING: edges must go from one side to the other");
+
+		if (G.outdeg(v) > 0)
+		{
+			side[v] = (int) A.size();
+			A.push_back(v);
+		}
+		else if (G.indeg(v) > 0)
+		{
+			side[v] = (int) B.size();
+			B.push_back(v);
+		}
+	}
+
+	const int n = (int) std::max(A.size(), B.size());
+
+	if (n == 0)
+		return result;
+
+	// Best edge of each pair. Rows are A, columns are B, padded to a square.
+	std::vector<double> profit(n * n, 0.0);
+	std::vector<edge> best(n * n, (edge) nil);
+	double maxProfit = 0;
+
+	for (e = G.first_edge(); e; e = G.succ_edge(e))
+	{
+		int k = side[G.source(e)] * n + side[G.target(e)];
+
+		if (c[e] > 0 && c[e] > profit[k])
+		{
+			profit[k] = c[e];
+			best[k] = e;
+			maxProfit = std::max(maxProfit, c[e]);
+		}
+	}
+
+	// Minimize cost = maxProfit - profit. Rows and columns are 1-based, 0 is a sentinel.
+	const double inf = std::numeric_limits<double>::max();
+	std::vector<double> u(n + 1, 0.0), p(n + 1, 0.0), minv(n + 1);
+	std::vector<int> match(n + 1, 0), way(n + 1, 0);
+	std::vector<char> used(n + 1);
+	int i, j, i0, j0, j1;
+
+	for (i = 1; i <= n; i++)
+	{
+		match[0] = i;
+		j0 = 0;
+		std::fill(minv.begin(), minv.end(), inf);
+		std::fill(used.begin(), used.end(), 0);
+
+		do
+		{
+			used[j0] = 1;
+			i0 = match[j0];
+			double delta = inf;
+			j1 = 0;
+
+			for (j = 1; j <= n; j++)
+			{
+				if (used[j])
+					continue;
+
+				double cur = (maxProfit - profit[(i0 - 1) * n + (j - 1)]) - u[i0] - p[j];
+
+				if (cur < minv[j])
+				{
+					minv[j] = cur;
+					way[j] = j0;
+				}
+
+				if (minv[j] < delta)
+				{
+					delta = minv[j];
+					j1 = j;
+				}
+			}
+
+			for (j = 0; j <= n; j++)
+			{
+				if (used[j])
+				{
+					u[match[j]] += delta;
+					p[j] -= delta;
+				}
+				else
+					minv[j] -= delta;
+			}
+
+			j0 = j1;
+		}
+		while (match[j0] != 0);
+
+		do
+		{
+			j1 = way[j0];
+			match[j0] = match[j1];
+			j0 = j1;
+		}
+		while (j0 != 0);
+	}
+
+	for (j = 1; j <= n; j++)
+	{
+		edge m = best[(match[j] - 1) * n + (j - 1)];
+
+		if (m != nil)
+			result.append(m);
+	}
+
+	return result;
+}
+
+#endif // DML_NO_LEDA
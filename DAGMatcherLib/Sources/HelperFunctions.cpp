@@ -39,7 +39,9 @@
 
 #include "stdafx.h"
 
+#ifdef WIN32
 #define vsnprintf _vsnprintf
+#endif
 
 #define SMALL_NUM  0.00000001 // anything that avoids division overflow
 
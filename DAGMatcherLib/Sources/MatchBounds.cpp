@@ -0,0 +1,216 @@
+/* ************* Begin file MatchBounds.cpp ***************************************/
+/*
+** 2015 October 16
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file MatchBounds.cpp
+*	\brief MatchBounds source file.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+
+using namespace dml;
+
+typedef MatchBoundCascade MBC;
+
+//! Reads the profile from the flat view of the DAG when it is frozen
+void MBC::Profile::Read(const DAG& dag)
+{
+	types.clear();
+	tsvNorms.clear();
+	childTSVNorms.clear();
+
+	if (dag.IsFrozen())
+	{
+		const FrozenDAG& fd = dag.GetFrozenView();
+
+		for (int i = 0; i < fd.Size(); i++)
+		{
+			if (fd.Node(i) != nil)
+			{
+				types.push_back(fd.NodeType(i));
+				tsvNorms.push_back(fd.TSVNorm(i));
+				childTSVNorms.push_back(fd.ChildTSVNorm(i));
+			}
+		}
+	}
+	else
+	{
+		leda::node v;
+
+		forall_nodes(v, dag)
+		{
+			types.push_back(dag.NodeType(v));
+			tsvNorms.push_back(dag.GetNodeTSVNorm(v));
+			childTSVNorms.push_back(dag.GetNodeTSV(v).Norm2());
+		}
+	}
+
+	sortedTypes = types;
+	std::sort(sortedTypes.begin(), sortedTypes.end());
+}
+
+void MBC::Init(const DAG& query)
+{
+	m_pQuery = &query;
+	m_pMatcher = MatchContext::Current().GetMatcher(query);
+
+	m_query.Read(query);
+}
+
+//! Number of pairs of nodes of the same type, merging the sorted types
+double MBC::ComputeLabelBound() const
+{
+	const std::vector<int>& t1 = m_query.sortedTypes;
+	const std::vector<int>& t2 = m_model.sortedTypes;
+	size_t i = 0, j = 0;
+	int n = 0;
+
+	while (i < t1.size() && j < t2.size())
+	{
+		if (t1[i] < t2[j])
+			i++;
+		else if (t2[j] < t1[i])
+			j++;
+		else
+		{
+			n++;
+			i++;
+			j++;
+		}
+	}
+
+	return n;
+}
+
+/*!
+	The TSV similarity is 1 - |c1 - c2| / MAX(n1, n2), where c1 and c2 are
+	the children TSVs and n1 and n2 the norms of the whole TSVs, which also
+	count the eigen labels (see DAGMatcher::NodeTSVSimilarity()). Since
+	|c1 - c2| >= ||c1| - |c2||, it's at most 1 - ||c1| - |c2|| / MAX(n1, n2).
+*/
+double MBC::TSVSimilarityBound(double c1, double n1, double c2, double n2)
+{
+	return DAGMatcher::TSVSimilarity(fabs(c1 - c2), n1, n2);
+}
+
+//! Fills m_pairBounds, which the assignment bound reuses.
+double MBC::ComputeTSVBound()
+{
+	const int n1 = (int) m_query.types.size();
+	const int n2 = (int) m_model.types.size();
+	double rowSum = 0, colSum = 0;
+	double tsvBound, u, rowMax;
+	int i, j;
+
+	m_pairBounds.resize(n1 * n2);
+	m_colMax.assign(n2, 0);
+
+	for (i = 0; i < n1; i++)
+	{
+		double* row = &m_pairBounds[i * n2];
+
+		rowMax = 0;
+
+		for (j = 0; j < n2; j++)
+		{
+			tsvBound = TSVSimilarityBound(m_query.childTSVNorms[i], m_query.tsvNorms[i],
+				m_model.childTSVNorms[j], m_model.tsvNorms[j]);
+
+			u = m_pMatcher->NodeSimilarityBound(tsvBound, m_query.types[i] == m_model.types[j]);
+
+			row[j] = u;
+			rowMax = MAX(rowMax, u);
+			m_colMax[j] = MAX(m_colMax[j], u);
+		}
+
+		rowSum += rowMax;
+	}
+
+	for (j = 0; j < n2; j++)
+		colSum += m_colMax[j];
+
+	return MIN(rowSum, colSum);
+}
+
+//! Best assignment of the pair bounds left by ComputeTSVBound()
+double MBC::ComputeAssignmentBound() const
+{
+	const int n1 = (int) m_query.types.size();
+	const int n2 = (int) m_model.types.size();
+	AssignmentSolver& solver = AssignmentSolver::Scratch();
+
+	solver.Init(n1, n2);
+
+	for (int i = 0; i < n1; i++)
+		for (int j = 0; j < n2; j++)
+			if (m_pairBounds[i * n2 + j] > 0)
+				solver.SetProfit(i, j, m_pairBounds[i * n2 + j]);
+
+	// The problem has no labels, so there is nothing to warm start from
+	return solver.Solve(false);
+}
+
+MBC::STAGE MBC::ComputeBound(const DAG& model, double dThreshold, double* pBound)
+{
+	ASSERT(m_pQuery && m_pMatcher);
+
+	*pBound = 1;
+
+	if (!m_pMatcher->BoundsSimilarity() || m_pQuery->IsEmpty() || model.IsEmpty())
+		return NO_BOUND_STAGE;
+
+	const DAG& query = *m_pQuery;
+	double simSum;
+	int stage;
+
+	// Each stage bounds the node similarity sum. The bounds of the later
+	// stages aren't always below those of the earlier ones, so the smallest is kept.
+	simSum = MIN(query.GetNodeCount(), model.GetNodeCount());
+
+	for (stage = NODE_COUNT_BOUND; ; stage++)
+	{
+		if (stage == LABEL_BOUND)
+		{
+			m_model.Read(model);
+
+			if (m_pMatcher->GetSimilarityMeasurer().ComparesOnlySameTypes())
+				simSum = MIN(simSum, ComputeLabelBound());
+		}
+		else if (stage == TSV_BOUND)
+		{
+			simSum = MIN(simSum, ComputeTSVBound());
+		}
+		else if (stage == ASSIGNMENT_BOUND)
+		{
+			simSum = MIN(simSum, ComputeAssignmentBound());
+		}
+
+		*pBound = MIN(1, m_pMatcher->SimilarityBound(query, model, simSum));
+
+		if (*pBound < dThreshold || stage == ASSIGNMENT_BOUND)
+			return (STAGE) stage;
+	}
+}
+
+const char* MBC::GetStageName(STAGE stage)
+{
+	switch (stage)
+	{
+		case NODE_COUNT_BOUND: return "node count";
+		case LABEL_BOUND: return "label";
+		case TSV_BOUND: return "TSV";
+		case ASSIGNMENT_BOUND: return "assignment";
+		default: return "none";
+	}
+}
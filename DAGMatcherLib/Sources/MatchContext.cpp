@@ -0,0 +1,118 @@
+/* ************* Begin file MatchContext.cpp ***************************************/
+/*
+** 2015 October 11
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file MatchContext.cpp
+*	\brief MatchContext source file.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+
+#define MAX_MODEL_NODE_COUNT 1024
+
+using namespace dml;
+
+//! The context made current by the innermost Scope of the calling thread
+static DML_THREAD_LOCAL MatchContext* s_pCurrentContext = NULL;
+
+MatchContext::MatchContext() : modelNodeMap(MAX_MODEL_NODE_COUNT)
+{
+	nExpandedSolSets = 0;
+}
+
+MatchContext::MatchContext(const DAGMatcher::MatchParams& params)
+	: m_params(params), modelNodeMap(MAX_MODEL_NODE_COUNT)
+{
+	nExpandedSolSets = 0;
+}
+
+MatchContext::~MatchContext()
+{
+	ResetMatchers();
+}
+
+void MatchContext::SetParams(const DAGMatcher::MatchParams& params)
+{
+	m_params = params;
+
+	ResetMatchers();
+}
+
+DAGMatcher* MatchContext::GetMatcher(const DAG& dag)
+{
+	const std::string strClassName = dag.ClassName().c_str();
+	boost::mutex::scoped_lock lock(m_matchersMutex);
+	MatcherMap::iterator it = m_matchers.find(strClassName);
+
+	if (it != m_matchers.end())
+		return it->second;
+
+	DAGMatcher* pMatcher = dag.CreateMatchingAlgorithm(m_params);
+
+	if (pMatcher)
+		pMatcher->SetContext(this);
+
+	m_matchers[strClassName] = pMatcher;
+
+	return pMatcher;
+}
+
+void MatchContext::ResetMatcher(const std::string& strClassName)
+{
+	boost::mutex::scoped_lock lock(m_matchersMutex);
+	MatcherMap::iterator it = m_matchers.find(strClassName);
+
+	if (it != m_matchers.end())
+	{
+		delete it->second;
+		m_matchers.erase(it);
+	}
+}
+
+void MatchContext::ResetMatchers()
+{
+	boost::mutex::scoped_lock lock(m_matchersMutex);
+
+	for (MatcherMap::iterator it = m_matchers.begin(); it != m_matchers.end(); ++it)
+		delete it->second;
+
+	m_matchers.clear();
+}
+
+/*!
+	The default context is built on first use, which must happen before
+	any other thread is started (eg, by DAGMatcher::SetMatchParams()).
+*/
+MatchContext& MatchContext::Default()
+{
+	static MatchContext s_defaultContext;
+
+	return s_defaultContext;
+}
+
+MatchContext& MatchContext::Current()
+{
+	return s_pCurrentContext ? *s_pCurrentContext : Default();
+}
+
+MatchContext::Scope::Scope(MatchContext& context)
+{
+	m_pPrevious = s_pCurrentContext;
+	s_pCurrentContext = &context;
+}
+
+MatchContext::Scope::~Scope()
+{
+	s_pCurrentContext = m_pPrevious;
+}
@@ -0,0 +1,326 @@
+/* ************* Begin file MatchEngine.cpp ***************************************/
+/*
+** 2015 October 15
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file MatchEngine.cpp
+*	\brief MatchEngine source file.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+#include <exception>
+
+using namespace dml;
+
+const double MatchEngine::NO_BOUND = DBL_MAX;
+
+//! Order of the results: decreasing similarity, then increasing candidate index
+static bool IsBetterResult(double sim1, int idx1, double sim2, int idx2)
+{
+	return sim1 > sim2 || (sim1 == sim2 && idx1 < idx2);
+}
+
+static bool CompareResults(const MatchResult& a, const MatchResult& b)
+{
+	return IsBetterResult(a.dSimilarity, a.nCandidate, b.dSimilarity, b.nCandidate);
+}
+
+struct MatchEngine::RunPlan
+{
+	const MatchEngine* pEngine;
+	const DAG* pQuery;
+	int nThreads;
+	std::vector<int> order;          //!< Candidates by decreasing upper bound
+
+	// Work distribution among the threads
+	boost::mutex mutexWork;
+	size_t nNext;
+	std::vector<MatchResult> best;   //!< Results so far, best first. At most k of them if k > 0
+	MatchEngine::Stats stats;
+	bool bFailed;
+	std::exception_ptr error;        //!< First exception thrown by a thread, of any type
+
+	/*!
+		Keeps the exception being handled, if it's the first one, and makes
+		the other threads stop. Run() rethrows it once they have. Must be
+		called from a catch block.
+	*/
+	void Fail()
+	{
+		boost::mutex::scoped_lock lock(mutexWork);
+
+		if (!bFailed)
+		{
+			bFailed = true;
+			error = std::current_exception();
+		}
+
+		// Let the other threads finish
+		nNext = order.size();
+	}
+
+	//! True if the k best have been found, so that the next ones must beat the last. Must be called under the lock.
+	bool IsFull() const
+	{
+		return pEngine->m_nTopK > 0 && (int) best.size() >= pEngine->m_nTopK;
+	}
+
+	//! True if candidate i, with the given bound, may still enter the k best. Must be called under the lock.
+	bool CanEnter(int i, double dUpperBound) const
+	{
+		if (!IsFull())
+			return true;
+
+		return IsBetterResult(dUpperBound, i, best.back().dSimilarity, best.back().nCandidate);
+	}
+
+	bool CanEnter(int i) const
+	{
+		return CanEnter(i, pEngine->m_candidates[i].dUpperBound);
+	}
+
+	//! Keeps the result if it's one of the k best. Must be called under the lock.
+	void Insert(const MatchResult& r)
+	{
+		best.insert(std::upper_bound(best.begin(), best.end(), r, CompareResults), r);
+
+		if (pEngine->m_nTopK > 0 && (int) best.size() > pEngine->m_nTopK)
+			best.pop_back();
+	}
+};
+
+MatchEngine::MatchEngine()
+	: m_params(MatchContext::Current().GetParams())
+{
+	m_nThreads = -1;
+	m_nTopK = 0;
+	m_bNodeMaps = false;
+	m_bBoundCascade = true;
+}
+
+MatchEngine::MatchEngine(const DAGMatcher::MatchParams& params)
+	: m_params(params)
+{
+	m_nThreads = -1;
+	m_nTopK = 0;
+	m_bNodeMaps = false;
+	m_bBoundCascade = true;
+}
+
+void MatchEngine::AddCandidate(DAGPtr ptrModel, double dUpperBound /*= NO_BOUND*/)
+{
+	Candidate c;
+
+	ASSERT(!ptrModel.IsNull());
+
+	c.ptrModel = ptrModel;
+	c.dUpperBound = dUpperBound;
+
+	m_candidates.push_back(c);
+}
+
+/*!
+	Thread body of Run(). Each thread takes the next candidate that may still
+	enter the k best, bounds it with its cascade if the k best have been
+	found, and matches it within its own context if the bound lets it in.
+*/
+void MatchEngine::MatchCandidates(RunPlan* pPlan)
+{
+	const MatchEngine& engine = *pPlan->pEngine;
+	DAGMatcher::MatchParams params = engine.m_params;
+
+	// The matches already keep all the cores busy
+	if (pPlan->nThreads > 1 && params.nNodeSimThreads != 0)
+		params.nNodeSimThreads = 1;
+
+	MatchContext context(params);
+	MatchContext::Scope scope(context);
+
+	// The matchers attach node arrays to the query, so each thread needs its own copy
+	DAGPtr ptrQueryCopy;
+	const DAG* pQuery = pPlan->pQuery;
+
+	if (pPlan->nThreads > 1)
+	{
+		try
+		{
+			DAG* pCopy = pQuery->CreateObject();
+
+			ptrQueryCopy = pCopy;
+			*pCopy = *pQuery;
+
+			if (pQuery->IsFrozen())
+				pCopy->Freeze();
+
+			pQuery = pCopy;
+		}
+		catch (...)
+		{
+			pPlan->Fail();
+			return;
+		}
+	}
+
+	MatchBoundCascade cascade;
+	bool bCascadeReady = false;
+
+	for (;;)
+	{
+		double dThreshold = 0;
+		bool bBound = false;
+		int i;
+
+		{
+			boost::mutex::scoped_lock lock(pPlan->mutexWork);
+
+			while (pPlan->nNext < pPlan->order.size() && !pPlan->CanEnter(pPlan->order[pPlan->nNext]))
+			{
+				pPlan->stats.nSkipped++;
+				pPlan->nNext++;
+			}
+
+			if (pPlan->nNext >= pPlan->order.size())
+				return;
+
+			i = pPlan->order[pPlan->nNext++];
+
+			// Until the k best are found, every candidate must be matched
+			if (engine.m_bBoundCascade && pPlan->IsFull())
+			{
+				bBound = true;
+				dThreshold = pPlan->best.back().dSimilarity;
+			}
+		}
+
+		// Read the model through a const reference, so that it isn't copied
+		const DAGPtr& ptrModel = engine.m_candidates[i].ptrModel;
+		const DAG& model = *ptrModel;
+		MatchResult r;
+
+		try
+		{
+			if (bBound)
+			{
+				if (!bCascadeReady)
+				{
+					cascade.Init(*pQuery);
+					bCascadeReady = true;
+				}
+
+				double dBound;
+				MatchBoundCascade::STAGE stage = cascade.ComputeBound(model, dThreshold, &dBound);
+
+				boost::mutex::scoped_lock lock(pPlan->mutexWork);
+
+				if (stage != MatchBoundCascade::NO_BOUND_STAGE)
+				{
+					pPlan->stats.nBounded++;
+
+					// The k-th best may have improved while the bound was computed
+					if (!pPlan->CanEnter(i, dBound))
+					{
+						pPlan->stats.nPruned++;
+						pPlan->stats.nPrunedAt[stage]++;
+						continue;
+					}
+				}
+			}
+
+			r.nCandidate = i;
+			r.dSimilarity = pQuery->Similarity(model);
+
+			if (engine.m_bNodeMaps)
+				r.nodeMatches = pQuery->GetNodeMapString();
+		}
+		catch (...)
+		{
+			// Not only ExceptionInfo: anything escaping the thread would terminate the program
+			pPlan->Fail();
+			return;
+		}
+
+		ASSERT(r.dSimilarity <= engine.m_candidates[i].dUpperBound);
+
+		{
+			boost::mutex::scoped_lock lock(pPlan->mutexWork);
+
+			pPlan->Insert(r);
+			pPlan->stats.nMatched++;
+		}
+	}
+}
+
+//! Orders the candidates by decreasing upper bound, and then by index
+static bool CompareBounds(const std::pair<double, int>& a, const std::pair<double, int>& b)
+{
+	return IsBetterResult(a.first, a.second, b.first, b.second);
+}
+
+/*!
+	The result is the same as matching the query with each candidate, in
+	turn, and keeping the k best: a candidate is only skipped when its
+	bound, given or computed, is below the k-th best similarity, which
+	never decreases.
+*/
+int MatchEngine::Run(const DAG& query, std::vector<MatchResult>* pResults)
+{
+	const int nCandidates = (int) m_candidates.size();
+	std::vector< std::pair<double, int> > bounds(nCandidates);
+	RunPlan plan;
+	int i;
+
+	for (i = 0; i < nCandidates; i++)
+		bounds[i] = std::make_pair(m_candidates[i].dUpperBound, i);
+
+	std::sort(bounds.begin(), bounds.end(), CompareBounds);
+
+	plan.pEngine = this;
+	plan.pQuery = &query;
+	plan.order.resize(nCandidates);
+	plan.nNext = 0;
+	plan.bFailed = false;
+
+	for (i = 0; i < nCandidates; i++)
+		plan.order[i] = bounds[i].second;
+
+	plan.nThreads = (m_nThreads < 0) ? (int) boost::thread::hardware_concurrency() : m_nThreads;
+	plan.nThreads = MIN(plan.nThreads, nCandidates);
+
+	// The log written in debug mode isn't shared safely by the threads
+	if (DAG::IsDbgMode())
+		plan.nThreads = 1;
+
+	if (plan.nThreads <= 1)
+	{
+		MatchCandidates(&plan);
+	}
+	else
+	{
+		boost::thread_group threads;
+
+		for (i = 0; i < plan.nThreads; i++)
+			threads.create_thread(boost::bind(&MatchEngine::MatchCandidates, &plan));
+
+		threads.join_all();
+	}
+
+	m_stats = plan.stats;
+	m_stats.nCandidates = nCandidates;
+
+	if (plan.bFailed)
+		std::rethrow_exception(plan.error);
+
+	pResults->swap(plan.best);
+
+	return (int) pResults->size();
+}
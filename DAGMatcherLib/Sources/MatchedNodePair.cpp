@@ -41,13 +41,15 @@ using namespace dml;
  	Needs to save the parents before the DAGs are splitted and
  	the links on loopy nodes are lost.
  */
-void MatchedNodePair::SetParents(const DAG& g, NodeIdxMatrix& parents)
+void MatchedNodePair::SetParents(const DAG& g, NodeIdxMatrix& parents,
+								 NodeMaskArray& parentMasks)
 {
  	leda::node v;
  	leda::edge e;
  	int i, j;
 
  	parents.Resize(g.GetNodeCount());
+ 	parentMasks.assign(g.GetNodeCount(), g.GetTransClosMat().NewMask());
 
  	forall_nodes(v, g)
  	{
@@ -57,52 +59,54 @@ void MatchedNodePair::SetParents(const DAG& g, NodeIdxMatrix& parents)
 
  		j = 0;
  		forall_in_edges(e, v)
- 			parents[i][j++] = g.GetNodeDFSIndex(g.source(e));
+ 		{
+ 			parents[i][j] = g.GetNodeDFSIndex(g.source(e));
+ 			BitMatrix::SetMaskBit(parentMasks[i], parents[i][j++]);
+ 		}
  	}
 }
 
 /*static*/
-NodeIdxArray MatchedNodePair::GetSiblingsVector(int node, const SmartMatrix<int>& tcm,
+NodeIdxArray MatchedNodePair::GetSiblingsVector(int node, const BitMatrix& tcm,
 												const NodeIdxMatrix& parents)
 {
 	const NodeIdxArray& vpar = parents[node];
 	NodeIdxArray sibs;
-	int parent;
+	int parent, j, nSibs = 0;
+
+	// Nodes without parents have no siblings
+	if (vpar.GetSize() == 0)
+		return sibs;
 
 	// Look for all the nodes that can be reached from the parents
 	// of the given 'node'. i.e., the node's siblings and their descendents
+	BitMatrix::Mask reached = tcm.NewMask();
 
-	// For every parent of 'node'
+	// For every parent of 'node', do reached |= descendants of parent
 	for (int i = 0; i < vpar.GetSize(); i++)
 	{
 		parent = vpar[i];
 
-		// If it is the first parent with children, then we just
-		// copy the vector of nodes that it reaches
-		if (sibs.GetSize() == 0)
-			sibs = tcm[parent];
-		else // this isn't the first parent. Add its children too
-		{
-			const NodeIdxArray& halfSibs = tcm[parent];
-			ASSERT(sibs.GetSize() == halfSibs.GetSize());
-
-			// Do sibs |= halfSibs;
-			for (int j = 0; j < halfSibs.GetSize(); j++)
-				if (halfSibs[j] == 1 && sibs[j] != 1) // only modifies sibs if necessary
-					sibs[j] = 1;
-		}
+		tcm.OrRowInto(parent, reached);
 
 		// we consider that a node is a sibling of itself, but the node's
 		// parent isn't its sibling (obviously), so we need to correct this...
-		sibs[parent] = 0;
+		BitMatrix::ResetMaskBit(reached, parent);
 	}
 
-	// If the only siblinf of 'node' is itself, then is better to return
-	// an empty array. Since there are only zeros and ones, we cun sum
-	// all values. Is the sum is smaller or equal to 1, the only sibling
-	// of 'none' is itself, and we can proceed to empty the array.
-	if (sibs.Sum() <= 1)
-		sibs.Clear();
+	for (j = 0; j < (int) reached.size(); j++)
+		nSibs += BitMatrix::PopCount(reached[j]);
+
+	// If the only sibling of 'node' is itself, then is better to return
+	// an empty array.
+	if (nSibs <= 1)
+		return sibs;
+
+	sibs.Resize(tcm.NCols(), true);
+
+	for (j = 0; j < tcm.NCols(); j++)
+		if (BitMatrix::TestMaskBit(reached, j))
+			sibs[j] = 1;
 
 	return sibs;
 }
@@ -137,8 +141,8 @@ void MatchedNodePair::UpdateSimMat(SimMatrix& simMat, const double& alpha) const
 	SmartArray<int> sq, sm;
 	int i, j;
 
-	sq = GetSiblingsVector(q, *pQueryTCM, qparents);
-	sm = GetSiblingsVector(m, *pModelTCM, mparents);
+	sq = GetSiblingsVector(q, pQuery->GetTransClosMat(), qparents);
+	sm = GetSiblingsVector(m, pModel->GetTransClosMat(), mparents);
 
 	rows = sq.GetSize();
 	cols = sm.GetSize();
@@ -0,0 +1,130 @@
+/* ************* Begin file MemoryArena.cpp ***************************************/
+/*
+** 2015 October 09
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file MemoryArena.cpp
+*	\brief MemoryArena source file.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+
+using namespace dml;
+
+//! The arena used by the operators new of the calling thread
+static DML_THREAD_LOCAL MemoryArena* s_pCurrentArena = NULL;
+
+MemoryArena::MemoryArena(size_t nBlockSize) : m_nRefs(1)
+{
+	m_pTop = m_pEnd = NULL;
+	m_nBlockSize = nBlockSize;
+	m_nUsedBytes = 0;
+	m_nReservedBytes = 0;
+}
+
+MemoryArena::~MemoryArena()
+{
+	for (size_t i = 0; i < m_blocks.size(); i++)
+		delete[] m_blocks[i];
+}
+
+void* MemoryArena::Allocate(size_t nBytes)
+{
+	// Keep every object aligned as its header
+	nBytes = (nBytes + sizeof(Header) - 1) / sizeof(Header) * sizeof(Header);
+
+	if (nBytes > (size_t)(m_pEnd - m_pTop))
+	{
+		// Big objects get a block of their own, so the current block isn't wasted
+		if (nBytes > m_nBlockSize / 4)
+		{
+			char* pBlock = new char[nBytes];
+
+			m_blocks.push_back(pBlock);
+			m_nReservedBytes += nBytes;
+			m_nUsedBytes += nBytes;
+
+			return pBlock;
+		}
+
+		m_pTop = new char[m_nBlockSize];
+		m_pEnd = m_pTop + m_nBlockSize;
+
+		m_blocks.push_back(m_pTop);
+		m_nReservedBytes += m_nBlockSize;
+	}
+
+	void* p = m_pTop;
+
+	m_pTop += nBytes;
+	m_nUsedBytes += nBytes;
+
+	return p;
+}
+
+MemoryArena* MemoryArena::GetCurrent()
+{
+	return s_pCurrentArena;
+}
+
+void* MemoryArena::New(size_t nBytes)
+{
+	MemoryArena* pArena = s_pCurrentArena;
+	Header* pHeader;
+
+	if (pArena)
+	{
+		pHeader = (Header*) pArena->Allocate(sizeof(Header) + nBytes);
+		pArena->AddRef();
+	}
+	else
+	{
+		pHeader = (Header*) ::operator new(sizeof(Header) + nBytes);
+	}
+
+	pHeader->pArena = pArena;
+
+	return pHeader + 1;
+}
+
+void MemoryArena::Delete(void* p)
+{
+	if (!p)
+		return;
+
+	Header* pHeader = (Header*) p - 1;
+
+	if (pHeader->pArena)
+		pHeader->pArena->Release();
+	else
+		::operator delete(pHeader);
+}
+
+MemoryArena::Scope::Scope(MemoryArena* pArena)
+{
+	m_pArena = pArena;
+	m_pPrevious = s_pCurrentArena;
+
+	if (m_pArena)
+		m_pArena->AddRef();
+
+	s_pCurrentArena = m_pArena;
+}
+
+MemoryArena::Scope::~Scope()
+{
+	s_pCurrentArena = m_pPrevious;
+
+	if (m_pArena)
+		m_pArena->Release();
+}
@@ -36,28 +36,107 @@
 
 using namespace dml;
 
+void ModelFitDescriptor::Set(const dml::POINTS& forwardPts, const dml::POINTS& reversePts,
+							 const LineSegmentArray& segs)
+{
+	SetPoints(0, forwardPts);
+	SetPoints(1, reversePts);
+	SetModel(segs);
+}
+
+void ModelFitDescriptor::SetPoints(int k, const dml::POINTS& pts)
+{
+	const int n = pts.GetSize();
+
+	points[k] = pts;
+	arcLens[k].resize(n);
+	radii[k].resize(n);
+	dataLens[k] = SmartArray<double>(n);
+
+	if (n == 0)
+		return;
+
+	for (int i = 0; i < n; i++)
+	{
+		arcLens[k][i] = pts[i].x;
+		radii[k][i] = pts[i].y;
+	}
+
+	simd::PolylineLengths(&arcLens[k][0], &radii[k][0], n, &dataLens[k][0]);
+}
+
+void ModelFitDescriptor::SetModel(const LineSegmentArray& segs)
+{
+	segments = segs;
+	lineLens = ModelFit::CumulativeLengths(segs);
+}
+
+SmartArray<double> ModelFit::CumulativeLengths(const dml::POINTS& vertices)
+{
+	SmartArray<double> lens(vertices.GetSize());
+
+	if (lens.GetSize() > 0)
+		lens[0] = 0;
+
+	for (int i = 1; i < lens.GetSize(); i++)
+		lens[i] = lens[i - 1] + vertices[i].L2(vertices[i - 1]);
+
+	return lens;
+}
+
+SmartArray<double> ModelFit::CumulativeLengths(const LineSegmentArray& segs)
+{
+	SmartArray<double> lens(segs.GetSize());
+
+	for (int i = 0; i < lens.GetSize(); i++)
+		lens[i] = (i > 0 ? lens[i - 1] : 0) + segs[i].GetLen();
+
+	return lens;
+}
+
 double ModelFit::Fit(const dml::POINTS& vertices, const LineSegmentArray& segs)
 {
-	ASSERT(segs.GetSize() >= 1);
-	ASSERT(vertices.GetSize() > 1);
+	return Fit(vertices, CumulativeLengths(vertices), segs, CumulativeLengths(segs));
+}
 
-	int i;
-	m_minLineLen.Resize(segs.GetSize());
-	m_minDataLen.Resize(vertices.GetSize());
+double ModelFit::Fit(const dml::POINTS& vertices, const SmartArray<double>& dataLens,
+					 const LineSegmentArray& segs, const SmartArray<double>& lineLens)
+{
+	const int n = vertices.GetSize();
 
-	// See if the data can possibly be fit with the model given the constraints (m_minLenCoeff)
-	m_minDataLen[0] = 0;
+	m_xBuf.resize(MAX(n, 1));
+	m_yBuf.resize(MAX(n, 1));
 
-	for (i = 1; i < m_minDataLen.GetSize(); i++)
-		m_minDataLen[i] = m_minDataLen[i - 1] + vertices[i].L2(vertices[i - 1]);
+	for (int i = 0; i < n; i++)
+	{
+		m_xBuf[i] = vertices[i].x;
+		m_yBuf[i] = vertices[i].y;
+	}
+
+	return Fit(vertices, &m_xBuf[0], &m_yBuf[0], dataLens, segs, lineLens);
+}
 
-	m_minLineLen[0] = segs[0].GetLen() / m_minLenCoeff;
+/*!
+	The arrays are only shared with the caller, never modified, so the
+	ones of a ModelFitDescriptor can be given by any number of threads.
+	The coordinates xs and ys are those of the vertices.
+*/
+double ModelFit::Fit(const dml::POINTS& vertices, const double* xs, const double* ys,
+					 const SmartArray<double>& dataLens, const LineSegmentArray& segs,
+					 const SmartArray<double>& lineLens)
+{
+	ASSERT(segs.GetSize() >= 1);
+	ASSERT(vertices.GetSize() > 1);
+	ASSERT(dataLens.GetSize() == vertices.GetSize() && lineLens.GetSize() == segs.GetSize());
 
-	for (i = 1; i < m_minLineLen.GetSize(); i++)
-		m_minLineLen[i] = m_minLineLen[i - 1] + (segs[i].GetLen() / m_minLenCoeff);
+	m_xs = xs;
+	m_ys = ys;
+	m_minDataLen = dataLens;
+	m_lineLen = lineLens;
 
+	// See if the data can possibly be fit with the model given the constraints (m_minLenCoeff)
 	m_totalDataLen = m_minDataLen.GetTail();
-	m_totalMinLineLen = m_minLineLen.GetTail();
+	m_totalMinLineLen = m_lineLen.GetTail() / m_minLenCoeff;
 	m_totalMaxLineLen = m_totalMinLineLen * m_minLenCoeff * m_minLenCoeff;
 
 	if (m_totalDataLen < m_totalMinLineLen || m_totalDataLen > m_totalMaxLineLen)
@@ -72,6 +151,9 @@ double ModelFit::Fit(const dml::POINTS& vertices, const LineSegmentArray& segs)
 	m_segments = segs;
 	m_minerrors.Resize(dim, dim);
 
+	if (m_bUsePrefixSums)
+		ComputeErrorSums();
+
 	MEMDATA d = Min(0, segs.GetSize(), 0, m_points.GetSize() - 1);
 
 	// Modify segments
@@ -84,8 +166,11 @@ void ModelFit::UpdateSegments(int ls, int le, int ps, int pe)
 {
 	if (le - ls == 1)
 	{
-		m_segments[ls].p0 = m_points[ps];
-		m_segments[ls].p1 = m_points[pe];
+		// Read the points through a const reference, so that they aren't copied
+		const dml::POINTS& points = m_points;
+
+		m_segments[ls].p0 = points[ps];
+		m_segments[ls].p1 = points[pe];
 	}
 	else
 	{
@@ -126,16 +211,16 @@ MINMAX ModelFit::GetMinMaxLen(int ls, int li, int le, int ps, int pe) const
 	}*/
 	ASSERT(li > ls && li < le);
 
-	d = (ls == 0) ? 0:m_minLineLen[ls - 1];
-	minSegLen = m_minLineLen[li - 1] - d;
+	d = (ls == 0) ? 0:m_lineLen[ls - 1];
+	minSegLen = (m_lineLen[li - 1] - d) / m_minLenCoeff;
 
 	for (i = ps + 1; i < pe && (m_minDataLen[i] - m_minDataLen[ps]) < minSegLen; i++);
 
 	if(i == pe)
 		i--;
 
-	d = (li == 0) ? 0:m_minLineLen[li - 1];
-	minSegLen = m_minLineLen[le - 1] - d;
+	d = (li == 0) ? 0:m_lineLen[li - 1];
+	minSegLen = (m_lineLen[le - 1] - d) / m_minLenCoeff;
 
 	for (j = pe - 1; j > ps && j > i && (m_minDataLen[pe] - m_minDataLen[j]) < minSegLen; j--);
 
@@ -191,8 +276,44 @@ MEMDATA ModelFit::Min(int ls, int le, int ps, int pe)
 	return d;
 }
 
+/*!
+	The error of a run of points wrt a segment of the model is a difference
+	of two of these sums. There are only a few segments, so this is much less
+	work than summing the errors of each run that the dynamic program tries.
+
+	The sums are computed by a vectorized kernel over the SoA coordinates.
+*/
+void ModelFit::ComputeErrorSums()
+{
+	const int nPts = m_points.GetSize();
+	const LineSegmentArray& segs = m_segments;
+
+	m_errorSums.resize(segs.GetSize() * (nPts + 1));
+
+	for (int ls = 0; ls < segs.GetSize(); ls++)
+	{
+		const LineSegment& s = segs[ls];
+
+		simd::AbsResidualPrefixSums(m_xs, m_ys, nPts, s.m, s.b, &m_errorSums[ls * (nPts + 1)]);
+	}
+}
+
+/*!
+	Sum of the absolute errors of the points ps to pe wrt the line of segment ls.
+
+	Note that it's the L1 error of a fixed line, not a least squares fit, so
+	it's read from the per segment sums of ComputeErrorSums() rather than
+	from sums of the coordinates.
+*/
 double ModelFit::CompLSError(int ls, int ps, int pe) const
 {
+	if (m_bUsePrefixSums)
+	{
+		const double* sums = &m_errorSums[ls * (m_points.GetSize() + 1)];
+
+		return sums[pe + 1] - sums[ps];
+	}
+
 	const LineSegment& s = m_segments[ls];
 	double e = 0;
 
@@ -209,8 +330,8 @@ void ModelFit::GetSegmentError(int s, double* error, double* scaleFactor) const
 
 	*error = d.GetMinError();
 
-	double oldLen = (s == 0) ? m_minLineLen[s]:m_minLineLen[s] - m_minLineLen[s - 1];
-	*scaleFactor = m_segments[s].GetLen() / (oldLen * m_minLenCoeff);*/
+	double oldLen = (s == 0) ? m_lineLen[s]:m_lineLen[s] - m_lineLen[s - 1];
+	*scaleFactor = m_segments[s].GetLen() / oldLen;*/
 }
 
 void ModelFit::Plot(std::ostream& os, const dml::POINTS& points2, const LineSegmentArray& segments2) const
@@ -265,4 +386,4 @@ void ModelFit::Plot(std::ostream& os, const dml::POINTS& points2, const LineSegm
 	os << ", data len: " << m_totalDataLen	<< ", error: " << minerror << ",  min len coeff: " << m_minLenCoeff << "');\n";
 	os << "hold off;\npause;\n\n";
 	os << "% End fitting...\n";
-}
\ No newline at end of file
+}
@@ -33,6 +33,8 @@
 
 #include "stdafx.h"
 
+#ifndef DML_NO_LEDA // The views need the LEDA windows
+
 
 using namespace dml;
 
@@ -113,4 +115,6 @@ void PlotView::OnDraw()
 			draw_segment(pt0, pt1, m_colors[i]);
 		}
 	}
-}
\ No newline at end of file
+}
+
+#endif // DML_NO_LEDA
@@ -85,6 +85,30 @@ double PolyLineApprox::LeastSquares(const dml::POINT* vertices, int n, LineSegme
 	return sume2;
 }
 
+/*!
+	@brief Same fit as LeastSquares(), but in O(1) from the prefix sums
+	of the points, which the dynamic program calls for every pair of points.
+*/
+double PolyLineApprox::FitSegment(int s, int e, LineSegment& seg)
+{
+	if (!m_bUsePrefixSums)
+		return PiecewiseApprox<LineSegment>::FitSegment(s, e, seg);
+
+	ASSERT(e > s);
+
+	// The points are shared with the caller, so they must be read as const
+	const dml::POINTS& pts = m_points;
+	double sume2 = m_sums.FitLine(s, e, &seg.m, &seg.b);
+
+	seg.p0 = pts[s];
+	seg.p1 = pts[e];
+
+	ASSERT_VALID_NUM(seg.m);
+	ASSERT_VALID_NUM(seg.b);
+
+	return sume2;
+}
+
 /*!
 	@brief Computes a relative measure of the line slope and compares
 	it to the m_dMinSlope value.
@@ -103,7 +103,7 @@ void SGRSM::LogResults(leda::node v1, leda::node v2,
 double SGRSM::ComputeNodeDistance(leda::node v1, leda::node v2, const ParamIndices& parInds,
 								  double* pSimilarity /*= NULL*/) const
 {
-	if (!DAGMatcher::GetMatchParams().nCompareNodes)
+	if (!Context().GetParams().nCompareNodes)
 	{
 		return 0;
 	}
@@ -113,53 +113,95 @@ double SGRSM::ComputeNodeDistance(leda::node v1, leda::node v2, const ParamIndic
 	{
 		cout << "\n" << pNode1->GetNodeLbl() << "\n" << pNode2->GetNodeLbl() << "\n";
 	}*/
-	const SGNode* pNode1 = m_pG1->GetSGNode(v1);
-	const SGNode* pNode2 = m_pG2->GetSGNode(v2);
 
-	int n1Type = m_pG1->NodeType(v1);
-	int n2Type = m_pG2->NodeType(v2);
+	// The types of the nodes and of their first parents are read
+	// from the flat views when they are available
+	const bool bFrozen = m_pG1->IsFrozen() && m_pG2->IsFrozen();
+	const int i1 = bFrozen ? m_pG1->GetNodeDFSIndex(v1) : -1;
+	const int i2 = bFrozen ? m_pG2->GetNodeDFSIndex(v2) : -1;
+
+	int n1Type = bFrozen ? m_pG1->GetFrozenView().NodeType(i1) : m_pG1->NodeType(v1);
+	int n2Type = bFrozen ? m_pG2->GetFrozenView().NodeType(i2) : m_pG2->NodeType(v2);
 
 	// If label is different, do not compare nodes
 	if (n1Type != n2Type)
 		return MAXDIST;
 	else if (n1Type == ROOT || n2Type == ROOT)
 		return n1Type == n2Type ? MINDIST:MAXDIST;
-	else if (pNode1->m_shocks.GetSize() == 1 && pNode2->m_shocks.GetSize() == 1)
+
+	// The radii, lengths and points of the frozen nodes are computed once
+	if (bFrozen)
 	{
-		double r1 = pNode1->m_shocks.GetHead().radius;
-		double r2 = pNode2->m_shocks.GetHead().radius;
+		return ComputeDescriptorDistance(v1, v2, i1, i2,
+			m_pG1->GetFitDescriptor(i1), m_pG2->GetFitDescriptor(i2));
+	}
+
+	ModelFitDescriptor fd1, fd2;
+
+	m_pG1->ComputeFitDescriptor(v1, &fd1);
+	m_pG2->ComputeFitDescriptor(v2, &fd2);
+
+	return ComputeDescriptorDistance(v1, v2, -1, -1, fd1, fd2);
+}
+
+/*!
+	Compares the radial properties of the nodes and, if they have enough
+	shock points, fits the model of each one to the points of the other.
+*/
+double SGRSM::ComputeDescriptorDistance(leda::node v1, leda::node v2, int i1, int i2,
+	const ModelFitDescriptor& desc1, const ModelFitDescriptor& desc2) const
+{
+	const bool bFrozen = (i1 >= 0 && i2 >= 0);
 
-		return 1 - (MIN(r1, r2) / MAX(r1, r2));
+	if (desc1.nShocks == 1 && desc2.nShocks == 1)
+	{
+		return simd::RatioDistance(desc1.firstRadius, desc2.firstRadius);
 	}
-	else if (pNode1->m_shocks.GetSize() == 1 || pNode2->m_shocks.GetSize() == 1)
+	else if (desc1.nShocks == 1 || desc2.nShocks == 1)
 	{
-		if (pNode1->m_shocks.GetSize() > 4 || pNode2->m_shocks.GetSize() > 4)
+		if (desc1.nShocks > 4 || desc2.nShocks > 4)
 			return MAXDIST; // if it is too long, it's unlikely that they are the same
 
-		double r1 = pNode1->m_shocks.AvgRadius();
-		double r2 = pNode2->m_shocks.AvgRadius();
-		double l1 = pNode1->m_shocks.Length();
-		double l2 = pNode2->m_shocks.Length();
+		// The radius and length differences, computed together
+		const double a[2] = { desc1.avgRadius, desc1.length };
+		const double b[2] = { desc2.avgRadius, desc2.length };
+		double diffs[2];
 
-		double rdiff = 1 - (MIN(r1, r2) / MAX(r1, r2));
-		double lendiff = 1 - (MIN(l1, l2) / MAX(l1, l2));
+		simd::RatioDistances(a, b, 2, diffs);
 
-		double dist = 0.85 * rdiff + 0.15 * lendiff;
+		double dist = 0.85 * diffs[0] + 0.15 * diffs[1];
 
 		ASSERT_UNIT_INTERVAL(dist);
 
 		return dist;
 	}
 
+	const SGNode* pNode1 = m_pG1->GetSGNode(v1);
+	const SGNode* pNode2 = m_pG2->GetSGNode(v2);
+
 	ASSERT(pNode1->GetSegments().GetSize() > 0 && pNode2->GetSegments().GetSize() > 0);
 
 	// We are dealing with same label, non-root nodes, with more that 1 shock point
 	// so...
 	leda_node par1 = m_pG1->GetFirstParent(v1);
 	leda_node par2 = m_pG2->GetFirstParent(v2);
-	int n1Dir, n2Dir;
+	int n1Dir, n2Dir, par1Type, par2Type;
+
+	if (bFrozen)
+	{
+		const FrozenDAG& f1 = m_pG1->GetFrozenView();
+		const FrozenDAG& f2 = m_pG2->GetFrozenView();
 
-	if (m_pG1->NodeType(par1) != ROOT && m_pG2->NodeType(par2) != ROOT)
+		par1Type = f1.NodeType(f1.Parent(f1.ParentBegin(i1)));
+		par2Type = f2.NodeType(f2.Parent(f2.ParentBegin(i2)));
+	}
+	else
+	{
+		par1Type = m_pG1->NodeType(par1);
+		par2Type = m_pG2->NodeType(par2);
+	}
+
+	if (par1Type != ROOT && par2Type != ROOT)
 	{
 		n1Dir = m_pG1->GetBranchDir(v1, par1);
 		n2Dir = m_pG2->GetBranchDir(v2, par2);
@@ -179,9 +221,9 @@ double SGRSM::ComputeNodeDistance(leda::node v1, leda::node v2, const ParamIndic
 	// what if dir == 0 but there is a slope? We should still reverse it.
 	// THIS IS A TO DO
 
-	int d0, dN;
-	POINTS g1Pts = pNode1->GetVelocityRadiusArray(d0, dN, bReverseOrder);
-	POINTS g2Pts = pNode2->GetVelocityRadiusArray(d0, dN, bReverseOrder);
+	const int k = bReverseOrder ? 1 : 0;
+	const POINTS& g1Pts = desc1.points[k];
+	const POINTS& g2Pts = desc2.points[k];
 
 // 	if(!( pNode2->GetSegments().GetTail().p1.y == (bReverseOrder ? g2Pts.GetHead().y:g2Pts.GetTail().y) ))
 // 	{
@@ -217,12 +259,12 @@ double SGRSM::ComputeNodeDistance(leda::node v1, leda::node v2, const ParamIndic
 	// Let's fit the model of node one to the data of node 2 and viceversa
 	ModelFit m1(2), m2(2); // 2 is max diff in lenght
 
-	double e1 = m1.Fit(g1Pts, pNode2->GetSegments());
+	double e1 = m1.Fit(desc1, bReverseOrder, desc2);
 
 	if (e1 >= INFINITY)
 		return MAXDIST;
 
-	double e2 = m2.Fit(g2Pts, pNode1->GetSegments());
+	double e2 = m2.Fit(desc2, bReverseOrder, desc1);
 
 	if (e2 >= INFINITY)
 		return MAXDIST;
@@ -240,17 +282,14 @@ double SGRSM::ComputeNodeDistance(leda::node v1, leda::node v2, const ParamIndic
 	}*/
 
 	// We have non-infinite errors, so we must normalize them
-	double avge1 = (e1 / g1Pts.GetSize()) / pNode1->m_shocks.AvgRadius();
-	double avge2 = (e2 / g2Pts.GetSize()) / pNode2->m_shocks.AvgRadius();
+	double avge1 = (e1 / g1Pts.GetSize()) / desc1.avgRadius;
+	double avge2 = (e2 / g2Pts.GetSize()) / desc2.avgRadius;
 	double error = (avge1 + avge2) / 2.0;
 
 	if (error >= MAXDIST)
 		return MAXDIST;
 
-	double minL = MIN(pNode1->m_shocks.Length(), pNode2->m_shocks.Length());
-	double maxL = MAX(pNode1->m_shocks.Length(), pNode2->m_shocks.Length());
-
-	double dist = 0.85 * error + 0.15 * (1 - minL / maxL);
+	double dist = 0.85 * error + 0.15 * simd::RatioDistance(desc1.length, desc2.length);
 
 	ASSERT_UNIT_INTERVAL(dist);
 
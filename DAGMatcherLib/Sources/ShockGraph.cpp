@@ -69,10 +69,6 @@ struct ER // Pair of edge and radius values
    }
 };
 
-/////////////////////////////////////////////////////////////////////////////////
-// Init static variables
-DAGMatcher* ShockGraph::s_pDAGMatcher = NULL;
-
 /////////////////////////////////////////////////////////////////////////////////
 // class member functions
 
@@ -88,17 +84,13 @@ ShockGraph::ShockGraph()
 {
    m_nLastIndexUsed = 0;
    m_pSkeleton = NULL;
-
-   // Init the matching algorithm for shock graphs
-   if (s_pDAGMatcher == NULL)
-      SetMatchingAlgorithm();
 }
 
-//! Sets the matching algorithm from the values in the match params
-void ShockGraph::SetMatchingAlgorithm()
+//! Creates the matching algorithm selected by the values in the match params
+DAGMatcher* ShockGraph::CreateMatchingAlgorithm(const DAGMatcher::MatchParams& params) const
 {
-   int matchAlgo = DAGMatcher::GetMatchParams().nMatchingAlgorithm;
-   int nodeSimFunc = DAGMatcher::GetMatchParams().nNodeSimilarityFunction;
+   int matchAlgo = params.nMatchingAlgorithm;
+   int nodeSimFunc = params.nNodeSimilarityFunction;
    SimilarityMeasurer* pNDM;
 
    if (nodeSimFunc == 0) // default is zero
@@ -111,17 +103,14 @@ void ShockGraph::SetMatchingAlgorithm()
       throw;
    }
 
-   // Delete any existing algorithm before creating a new one
-   delete s_pDAGMatcher;
-
    if (matchAlgo == 0)
-      s_pDAGMatcher = new DAGMatcherGreedy(pNDM);
+      return new DAGMatcherGreedy(pNDM);
    else if (matchAlgo == 1)
-      s_pDAGMatcher = new DAGMatcherOptimal(pNDM);
+      return new DAGMatcherOptimal(pNDM);
    else if (matchAlgo == 2)
-      s_pDAGMatcher = new DAGMatcherTopological(pNDM);
+      return new DAGMatcherTopological(pNDM);
    else if (matchAlgo == 3)
-      s_pDAGMatcher = new DAGMatcherAdaptive(pNDM);
+      return new DAGMatcherAdaptive(pNDM);
    else
    {
       ShowError("Unknown matching algorithm ID");
@@ -142,6 +131,60 @@ void ShockGraph::Clear()
 
    delete m_pSkeleton;
    m_pSkeleton = NULL;
+
+   m_fitDescriptors.clear();
+}
+
+/*!
+   Extends the behaviour of the same function in the base class.
+
+   The data that SGRadialSimilarityMeasurer reads from each node is
+   computed here, once, rather than for every pair of nodes compared. Only
+   non-root nodes get it.
+*/
+void ShockGraph::Freeze()
+{
+   DAG::Freeze();
+
+   const FrozenDAG& frozen = GetFrozenView();
+
+   m_fitDescriptors.assign(frozen.Size(), ModelFitDescriptor());
+
+   for (int i = 0; i < frozen.Size(); i++)
+   {
+      leda_node v = frozen.Node(i);
+
+      if (v != nil && NodeType(v) != ROOT)
+         ComputeFitDescriptor(v, &m_fitDescriptors[i]);
+   }
+}
+
+/*!
+   The radial properties of the node are copied out of its shock branch,
+   and the points to fit are laid out in SoA arrays. Only the nodes with
+   more than one shock point are ever fitted, so the others get no points.
+*/
+void ShockGraph::ComputeFitDescriptor(leda_node v, ModelFitDescriptor* pDesc) const
+{
+   const SGNode* pNode = GetSGNode(v);
+   const ShockBranch& shocks = pNode->m_shocks;
+
+   ASSERT(NodeType(v) != ROOT);
+
+   if (shocks.GetSize() == 0)
+      return;
+
+   pDesc->SetShape(shocks.GetSize(), shocks.GetHead().radius,
+      shocks.AvgRadius(), shocks.Length());
+
+   if (shocks.GetSize() > 1)
+   {
+      int d0, dN;
+
+      pDesc->SetPoints(0, pNode->GetVelocityRadiusArray(d0, dN, false));
+      pDesc->SetPoints(1, pNode->GetVelocityRadiusArray(d0, dN, true));
+      pDesc->SetModel(pNode->GetSegments());
+   }
 }
 
 //! Extends the behaviour of the same function in the base class.
@@ -875,7 +918,7 @@ bool ShockGraph::ComputeSGFromDDSGraph(sg::DDSGraph* sk)
 
    ComputeDerivedValues();
 
-   Logger::Log ( "Computation for (" + std::string(GetObjName().c_str()) + " ,  " + to_string((_Longlong) GetViewNumber()) + ") is over!", constants::LogCore);
+   Logger::Log ( "Computation for (" + std::string(GetObjName().c_str()) + " ,  " + to_string((long long) GetViewNumber()) + ") is over!", constants::LogCore);
 
    return true;
 }
@@ -889,6 +932,8 @@ bool ShockGraph::Create(const ImageInfo& imgInfo, const ShockGraphParams& sgpara
 {
    Clear(); //make sure the current shock graph is empty
 
+   MemoryArena::Scope arenaScope(GetArena());
+
    m_compParams = sgparams;
 
    SetDAGLbl(imgInfo.strFileName);
@@ -912,6 +957,8 @@ bool ShockGraph::Create(SkeletalGraph* pSkeleton, const ShapeDims& dims,
 {
    DAG::Clear();
 
+   MemoryArena::Scope arenaScope(GetArena());
+
    m_nLastIndexUsed = 0;
 
    m_compParams = sgparams;
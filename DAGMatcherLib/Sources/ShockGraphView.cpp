@@ -33,6 +33,8 @@
 
 #include "stdafx.h"
 
+#ifndef DML_NO_LEDA // The views need the LEDA windows
+
 // matching window parms
 #define Y_OFFSET 10
 
@@ -255,4 +257,6 @@ double ShockGraphView::FindClosestSkeletonPoint(const double& x, const double& y
 	}
 
 	return (dMinDist >= 0) ? sqrt(dMinDist):-dMinDist;
-}
\ No newline at end of file
+}
+
+#endif // DML_NO_LEDA
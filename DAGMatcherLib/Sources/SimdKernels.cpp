@@ -0,0 +1,344 @@
+/* ************* Begin file SimdKernels.cpp ***************************************/
+/*
+** 2015 October 14
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file SimdKernels.cpp
+*	\brief SimdKernels source file.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+
+#if !defined(DML_NO_SIMD) && (defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__))
+#define DML_SIMD_X86
+#endif
+
+#ifdef DML_SIMD_X86
+#include <emmintrin.h>
+#ifndef DML_NO_AVX
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// gcc only emits the AVX instructions in the functions marked for it
+#if defined(__GNUC__) && !defined(__AVX__)
+#define DML_TARGET_AVX __attribute__((target("avx")))
+#else
+#define DML_TARGET_AVX
+#endif
+
+using namespace dml;
+using namespace dml::simd;
+
+/////////////////////////////////////////////////////////////////////////////
+// Instruction set selection
+
+//! The best instruction set supported by both the build and the CPU
+static ISA DetectISA()
+{
+#ifdef DML_SIMD_X86
+	unsigned int regs[4] = { 0, 0, 0, 0 }; // eax, ebx, ecx, edx
+
+#ifdef _MSC_VER
+	__cpuid((int*) regs, 1);
+#else
+	__get_cpuid(1, &regs[0], &regs[1], &regs[2], &regs[3]);
+#endif
+
+	if (!(regs[3] & (1 << 26)))
+		return SCALAR;
+
+#ifndef DML_NO_AVX
+	// The OS must also save the AVX registers on context switches (OSXSAVE and XCR0)
+	if ((regs[2] & (1 << 27)) && (regs[2] & (1 << 28)))
+	{
+#ifdef _MSC_VER
+		unsigned long long xcr0 = _xgetbv(0);
+#else
+		unsigned int lo, hi;
+		__asm__ __volatile__ ("xgetbv" : "=a" (lo), "=d" (hi) : "c" (0));
+		unsigned long long xcr0 = ((unsigned long long) hi << 32) | lo;
+#endif
+		if ((xcr0 & 6) == 6)
+			return AVX;
+	}
+#endif //DML_NO_AVX
+
+	return SSE2;
+#else
+	return SCALAR;
+#endif //DML_SIMD_X86
+}
+
+// Detected before main(), so no thread can see it change
+static const ISA s_bestISA = DetectISA();
+static ISA s_isa = s_bestISA;
+
+ISA simd::GetISA()
+{
+	return s_isa;
+}
+
+ISA simd::SetISA(ISA isa)
+{
+	s_isa = MIN(isa, s_bestISA);
+
+	return s_isa;
+}
+
+const char* simd::GetISAName(ISA isa)
+{
+	switch (isa)
+	{
+		case SSE2: return "SSE2";
+		case AVX: return "AVX";
+		default: return "scalar";
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Scalar kernels. They also finish the elements left by the vectorized ones.
+
+static void AbsResidualPrefixSumsScalar(const double* x, const double* y, int i, int n,
+	double m, double b, double* sums)
+{
+	for (; i < n; i++)
+		sums[i + 1] = sums[i] + fabs(y[i] - (m * x[i] + b));
+}
+
+static void PolylineLengthsScalar(const double* x, const double* y, int i, int n, double* lens)
+{
+	double dx, dy;
+
+	for (; i < n; i++)
+	{
+		dx = x[i] - x[i - 1];
+		dy = y[i] - y[i - 1];
+		lens[i] = lens[i - 1] + sqrt(dx * dx + dy * dy);
+	}
+}
+
+static void RatioDistancesScalar(const double* a, const double* b, int i, int n, double* d)
+{
+	for (; i < n; i++)
+		d[i] = RatioDistance(a[i], b[i]);
+}
+
+#ifdef DML_SIMD_X86
+
+/////////////////////////////////////////////////////////////////////////////
+// SSE2 kernels
+
+/*!
+	Inclusive prefix sum of the two lanes of v, plus the running total in
+	both lanes of carry, which is updated to the last sum.
+*/
+static inline __m128d PrefixSumSSE2(__m128d v, __m128d& carry)
+{
+	v = _mm_add_pd(v, _mm_unpacklo_pd(_mm_setzero_pd(), v)); // [a, a + b]
+	v = _mm_add_pd(v, carry);
+	carry = _mm_unpackhi_pd(v, v);
+
+	return v;
+}
+
+static void AbsResidualPrefixSumsSSE2(const double* x, const double* y, int n,
+	double m, double b, double* sums)
+{
+	const __m128d signMask = _mm_set1_pd(-0.0);
+	const __m128d vm = _mm_set1_pd(m), vb = _mm_set1_pd(b);
+	__m128d carry = _mm_setzero_pd();
+	int i;
+
+	sums[0] = 0;
+
+	for (i = 0; i + 2 <= n; i += 2)
+	{
+		__m128d r = _mm_sub_pd(_mm_loadu_pd(y + i), _mm_add_pd(_mm_mul_pd(vm, _mm_loadu_pd(x + i)), vb));
+
+		_mm_storeu_pd(sums + i + 1, PrefixSumSSE2(_mm_andnot_pd(signMask, r), carry));
+	}
+
+	AbsResidualPrefixSumsScalar(x, y, i, n, m, b, sums);
+}
+
+static void PolylineLengthsSSE2(const double* x, const double* y, int n, double* lens)
+{
+	__m128d carry = _mm_setzero_pd();
+	int i;
+
+	for (i = 1; i + 2 <= n; i += 2)
+	{
+		__m128d dx = _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(x + i - 1));
+		__m128d dy = _mm_sub_pd(_mm_loadu_pd(y + i), _mm_loadu_pd(y + i - 1));
+		__m128d l = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+
+		_mm_storeu_pd(lens + i, PrefixSumSSE2(l, carry));
+	}
+
+	PolylineLengthsScalar(x, y, i, n, lens);
+}
+
+static void RatioDistancesSSE2(const double* a, const double* b, int n, double* d)
+{
+	const __m128d one = _mm_set1_pd(1.0);
+	int i;
+
+	for (i = 0; i + 2 <= n; i += 2)
+	{
+		__m128d va = _mm_loadu_pd(a + i), vb = _mm_loadu_pd(b + i);
+
+		_mm_storeu_pd(d + i, _mm_sub_pd(one, _mm_div_pd(_mm_min_pd(va, vb), _mm_max_pd(va, vb))));
+	}
+
+	RatioDistancesScalar(a, b, i, n, d);
+}
+
+#ifndef DML_NO_AVX
+
+/////////////////////////////////////////////////////////////////////////////
+// AVX kernels. They call _mm256_zeroupper() before returning, to avoid
+// the penalty of mixing them with SSE code.
+
+//! Same as PrefixSumSSE2(), over four lanes
+DML_TARGET_AVX static inline __m256d PrefixSumAVX(__m256d v, __m256d& carry)
+{
+	// [0, a, b, c], by shifting in the low lane of [0, 0, a, b]
+	__m256d t = _mm256_permute2f128_pd(v, v, 0x08);
+
+	v = _mm256_add_pd(v, _mm256_shuffle_pd(t, v, 0x5));  // [a, a + b, b + c, c + d]
+	v = _mm256_add_pd(v, _mm256_permute2f128_pd(v, v, 0x08));
+	v = _mm256_add_pd(v, carry);
+	carry = _mm256_permute_pd(_mm256_permute2f128_pd(v, v, 0x11), 0xF);
+
+	return v;
+}
+
+DML_TARGET_AVX static void AbsResidualPrefixSumsAVX(const double* x, const double* y, int n,
+	double m, double b, double* sums)
+{
+	const __m256d signMask = _mm256_set1_pd(-0.0);
+	const __m256d vm = _mm256_set1_pd(m), vb = _mm256_set1_pd(b);
+	__m256d carry = _mm256_setzero_pd();
+	int i;
+
+	sums[0] = 0;
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		__m256d r = _mm256_sub_pd(_mm256_loadu_pd(y + i),
+			_mm256_add_pd(_mm256_mul_pd(vm, _mm256_loadu_pd(x + i)), vb));
+
+		_mm256_storeu_pd(sums + i + 1, PrefixSumAVX(_mm256_andnot_pd(signMask, r), carry));
+	}
+
+	_mm256_zeroupper();
+
+	AbsResidualPrefixSumsScalar(x, y, i, n, m, b, sums);
+}
+
+DML_TARGET_AVX static void PolylineLengthsAVX(const double* x, const double* y, int n, double* lens)
+{
+	__m256d carry = _mm256_setzero_pd();
+	int i;
+
+	for (i = 1; i + 4 <= n; i += 4)
+	{
+		__m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(x + i - 1));
+		__m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i), _mm256_loadu_pd(y + i - 1));
+		__m256d l = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+
+		_mm256_storeu_pd(lens + i, PrefixSumAVX(l, carry));
+	}
+
+	_mm256_zeroupper();
+
+	PolylineLengthsScalar(x, y, i, n, lens);
+}
+
+DML_TARGET_AVX static void RatioDistancesAVX(const double* a, const double* b, int n, double* d)
+{
+	const __m256d one = _mm256_set1_pd(1.0);
+	int i;
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		__m256d va = _mm256_loadu_pd(a + i), vb = _mm256_loadu_pd(b + i);
+
+		_mm256_storeu_pd(d + i, _mm256_sub_pd(one,
+			_mm256_div_pd(_mm256_min_pd(va, vb), _mm256_max_pd(va, vb))));
+	}
+
+	_mm256_zeroupper();
+
+	// The pairs left may still fill an SSE2 register
+	RatioDistancesSSE2(a + i, b + i, n - i, d + i);
+}
+
+#endif //DML_NO_AVX
+#endif //DML_SIMD_X86
+
+/////////////////////////////////////////////////////////////////////////////
+// Dispatch
+
+void simd::AbsResidualPrefixSums(const double* x, const double* y, int n,
+	double m, double b, double* sums)
+{
+#ifdef DML_SIMD_X86
+#ifndef DML_NO_AVX
+	if (s_isa == AVX)
+		return AbsResidualPrefixSumsAVX(x, y, n, m, b, sums);
+#endif
+	if (s_isa == SSE2)
+		return AbsResidualPrefixSumsSSE2(x, y, n, m, b, sums);
+#endif
+	sums[0] = 0;
+
+	AbsResidualPrefixSumsScalar(x, y, 0, n, m, b, sums);
+}
+
+void simd::PolylineLengths(const double* x, const double* y, int n, double* lens)
+{
+	if (n <= 0)
+		return;
+
+	lens[0] = 0;
+
+#ifdef DML_SIMD_X86
+#ifndef DML_NO_AVX
+	if (s_isa == AVX)
+		return PolylineLengthsAVX(x, y, n, lens);
+#endif
+	if (s_isa == SSE2)
+		return PolylineLengthsSSE2(x, y, n, lens);
+#endif
+	PolylineLengthsScalar(x, y, 1, n, lens);
+}
+
+void simd::RatioDistances(const double* a, const double* b, int n, double* d)
+{
+#ifdef DML_SIMD_X86
+#ifndef DML_NO_AVX
+	if (s_isa == AVX)
+		return RatioDistancesAVX(a, b, n, d);
+#endif
+	if (s_isa == SSE2)
+		return RatioDistancesSSE2(a, b, n, d);
+#endif
+	RatioDistancesScalar(a, b, 0, n, d);
+}
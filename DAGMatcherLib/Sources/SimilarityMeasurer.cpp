@@ -0,0 +1,220 @@
+/* ************* Begin file SimilarityMeasurer.cpp ***************************************/
+/*
+** 2015 October 13
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file SimilarityMeasurer.cpp
+*	\brief SimilarityMeasurer and NodeSimilarityMemo source file.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+
+using namespace dml;
+
+/////////////////////////////////////////////////////////////////////////////
+// NodeSimilarityMemo class implementation
+
+void NodeSimilarityMemo::Clear()
+{
+	m_pDag1 = NULL;
+	m_pDag2 = NULL;
+	m_nRows = 0;
+	m_nCols = 0;
+	m_values.clear();
+
+	nHits = 0;
+	nMisses = 0;
+}
+
+//! Number of rows or columns needed by the DFS indices of a DAG, as in FrozenDAG::Build()
+static int GetDFSIndexCount(const DAG& dag)
+{
+	leda::node v;
+	int n = 0;
+
+	forall_nodes(v, dag)
+		n = MAX(n, dag.GetNodeDFSIndex(v) + 1);
+
+	return n;
+}
+
+void NodeSimilarityMemo::Reset(const DAG* pDag1, const DAG* pDag2)
+{
+	if (pDag1 == m_pDag1 && pDag2 == m_pDag2)
+		return;
+
+	m_pDag1 = pDag1;
+	m_pDag2 = pDag2;
+	m_nRows = GetDFSIndexCount(*pDag1);
+	m_nCols = GetDFSIndexCount(*pDag2);
+
+	// The buffer keeps its capacity, so the next matches don't allocate
+	m_values.assign(m_nRows * m_nCols, -1);
+}
+
+double* NodeSimilarityMemo::Find(leda::node v1, leda::node v2)
+{
+	if (!m_pDag1)
+		return NULL;
+
+	return Find(m_pDag1->GetNodeDFSIndex(v1), m_pDag2->GetNodeDFSIndex(v2));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SimilarityMeasurer class implementation
+
+const MatchContext& SimilarityMeasurer::Context() const
+{
+	return m_pContext ? *m_pContext : MatchContext::Current();
+}
+
+double SimilarityMeasurer::MemoizedNodeSimilarity(leda::node v1, leda::node v2) const
+{
+	double* pSim = MemoizesNodeSimilarities() ? m_memo.Find(v1, v2) : NULL;
+
+	// Nodes out of the memo, eg, added after the last DFS, are simply not memoized
+	if (!pSim)
+		return ComputeNodePairSimilarity(v1, v2);
+
+	if (*pSim >= 0)
+	{
+		m_memo.nHits++;
+	}
+	else
+	{
+		*pSim = ComputeNodePairSimilarity(v1, v2);
+		m_memo.nMisses++;
+
+		ASSERT(*pSim >= 0);
+	}
+
+	return *pSim;
+}
+
+struct SimilarityMeasurer::MemoPlan
+{
+	const SimilarityMeasurer* pMeasurer;
+	std::vector<leda::node> rowNodes;  //!< Node of the first DAG with each DFS index. nil if none
+	std::vector<leda::node> colNodes;  //!< Node of the second DAG with each DFS index. nil if none
+
+	// Work distribution among the threads
+	boost::mutex mutexRows;
+	int nNextRow;
+	long nComputed;
+};
+
+/*!
+	Thread body of ComputeAllNodeSimilarities(). Each thread takes the next
+	row of the memo and computes its missing cells, so no two threads
+	write the same cell.
+*/
+void SimilarityMeasurer::FillMemoRows(MemoPlan* pPlan)
+{
+	const SimilarityMeasurer* pMeasurer = pPlan->pMeasurer;
+	NodeSimilarityMemo& memo = pMeasurer->m_memo;
+	const int nCols = (int) pPlan->colNodes.size();
+	long nComputed = 0;
+	double* pSim;
+	int i, j;
+
+	for (;;)
+	{
+		{
+			boost::mutex::scoped_lock lock(pPlan->mutexRows);
+
+			if (pPlan->nNextRow >= (int) pPlan->rowNodes.size())
+			{
+				pPlan->nComputed += nComputed;
+				return;
+			}
+
+			i = pPlan->nNextRow++;
+		}
+
+		leda::node v1 = pPlan->rowNodes[i];
+
+		if (v1 == nil)
+			continue;
+
+		for (j = 0; j < nCols; j++)
+		{
+			leda::node v2 = pPlan->colNodes[j];
+
+			if (v2 != nil && (pSim = memo.Find(i, j)) != NULL && *pSim < 0)
+			{
+				*pSim = pMeasurer->ComputeNodePairSimilarity(v1, v2);
+				nComputed++;
+			}
+		}
+	}
+}
+
+/*!
+	@brief Computes the similarities of all the pairs of nodes of the DAGs
+	given to the last Init(), so that the match only reads them.
+
+	It only pays off when most pairs are compared by the match, as with
+	the optimal matcher, and when the node similarity is expensive, as
+	with the ModelFit of the shock graph nodes. The memoized values are
+	the same as those computed on demand.
+*/
+void SimilarityMeasurer::ComputeAllNodeSimilarities(int nThreads)
+{
+	if (!MemoizesNodeSimilarities() || m_memo.GetRowCount() == 0)
+		return;
+
+	const DAG* pDag1 = m_memo.GetDAG1();
+	const DAG* pDag2 = m_memo.GetDAG2();
+	MemoPlan plan;
+	leda::node v;
+
+	plan.pMeasurer = this;
+	plan.rowNodes.assign(m_memo.GetRowCount(), nil);
+	plan.colNodes.assign(m_memo.GetColCount(), nil);
+	plan.nNextRow = 0;
+	plan.nComputed = 0;
+
+	forall_nodes(v, *pDag1)
+		if (pDag1->GetNodeDFSIndex(v) >= 0)
+			plan.rowNodes[pDag1->GetNodeDFSIndex(v)] = v;
+
+	forall_nodes(v, *pDag2)
+		if (pDag2->GetNodeDFSIndex(v) >= 0)
+			plan.colNodes[pDag2->GetNodeDFSIndex(v)] = v;
+
+	// The log written in debug mode isn't shared safely by the threads
+	if (DAG::IsDbgMode())
+		nThreads = 1;
+
+	if (nThreads <= 1)
+	{
+		FillMemoRows(&plan);
+	}
+	else
+	{
+		// The threads have no current context, so they must use the one of the caller
+		const MatchContext* pPrevContext = m_pContext;
+		boost::thread_group threads;
+
+		m_pContext = &Context();
+
+		for (int i = 0; i < nThreads; i++)
+			threads.create_thread(boost::bind(&SimilarityMeasurer::FillMemoRows, &plan));
+
+		threads.join_all();
+
+		m_pContext = pPrevContext;
+	}
+
+	m_memo.nMisses += plan.nComputed;
+}
@@ -34,7 +34,7 @@
 #include "stdafx.h"
 
 
-#include "AFMMSkeleton\include\skeleton.h"
+#include "AFMMSkeleton/include/skeleton.h"
 
 // VC++6 -> Include CImg before DAG.h
 #include "CImg/CImg.h"
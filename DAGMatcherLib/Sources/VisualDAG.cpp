@@ -33,6 +33,8 @@
 
 #include "stdafx.h"
 
+#ifndef DML_NO_LEDA // The views need the LEDA windows
+
 // Graph window params
 #define GW_LEFT_MARGIN    50
 #define GW_RIGHT_MARGIN   50
@@ -477,4 +479,6 @@ void VisualDAG::ShowGraphs(DAG& g1, DAG& g2, const NodeMatchMap& matchMap,
 		gw.edit();
 	else
 		gw.wait();
-}
\ No newline at end of file
+}
+
+#endif // DML_NO_LEDA
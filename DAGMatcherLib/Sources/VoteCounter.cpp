@@ -33,12 +33,15 @@
 
 #include "stdafx.h"
 
+#ifndef DML_NO_LEDA
 #include <LEDA/core/tuple.h>
 #include <LEDA/graph/graph_alg.h>
 #include <LEDA/graph/node_array.h>
+#endif
 
 #include "VoteCounter.h"
 
+#ifndef DML_NO_LEDA
 #ifdef USE_TEMPLATE_BASED_MWBM_FUNCTION
 #include <LEDA/graph/templates/mwb_matching.h>
 using namespace std; // Fixes an error in the next LEDA header scale_weights.h line 35
@@ -46,20 +49,17 @@ using namespace std; // Fixes an error in the next LEDA header scale_weights.h l
 #else
 #include <LEDA/graph/mwb_matching.h>
 #endif
+#endif //DML_NO_LEDA
 
 //#include "ShockGraph.h" // needed for ShowGraph()
 //#include "VisualDAG.h"  // needed for ShowGraph()
 
 //#include <LEDA/templates/mwb_matching.t>
 
-#define MAX_MODEL_NODE_COUNT 1024
-
 using namespace dml;
 using namespace MOOVC;
 using namespace leda;
 
-SmartArray<leda_node> PartitionBins::modelNodeMap(MAX_MODEL_NODE_COUNT);
-
 /*!
 	@brief Symmetric function that determines whether the range queries
 	centered at pt1 and pt2 overlap.
@@ -92,6 +92,11 @@ void PartitionBins::CreateVoteGraph(LEDA_GRAPH<int, double>& g) const
 
 	ASSERT(g.empty());
 
+	// Ideally, the number of nodes in the model would be know.
+	// This should be save in the NN info. Temporarely we use a fixed-size map,
+	// which belongs to the match context so that concurrent queries don't share it.
+	SmartArray<leda_node>& modelNodeMap = MatchContext::Current().modelNodeMap;
+
 	// Init the map of model nodes
 	modelNodeMap.Set(nil);
 
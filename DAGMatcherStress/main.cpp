@@ -0,0 +1,171 @@
+/* ************* Begin file main.cpp ***************************************/
+/*
+** 2015 October 10
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file main.cpp
+*	\brief Multithreaded stress test of the reference counts of SmartArray and SmartPtr.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*
+*	Usage: DAGMatcherStress [threads] [iterations]
+*
+*	Every thread copies one shared array and one shared pointer, writes into
+*	its copies (which must unlink them from the shared data) and releases
+*	them, all at the same time. The shared data must be left untouched, and
+*	every element created must be destroyed exactly once. The program returns
+*	a non-zero value if either check fails.
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/smart_ptr/detail/atomic_count.hpp>
+#include "SmartArray.h"
+#include "SmartPtr.h"
+
+using namespace std;
+
+//! Element that counts its live instances, to find leaks and double deletes
+struct Tracked
+{
+	static boost::detail::atomic_count s_nLive;
+	int value;
+
+	Tracked() : value(0)                 { ++s_nLive; }
+	Tracked(const Tracked& x) : value(x.value) { ++s_nLive; }
+	~Tracked()                           { --s_nLive; }
+
+	Tracked& operator=(const Tracked& x) { value = x.value; return *this; }
+
+	//! Needed by the copy-on-write of SmartPtr
+	Tracked* CreateObject() const        { return new Tracked; }
+
+	friend std::ostream& operator<<(std::ostream& os, const Tracked& x) { return os << x.value; }
+	friend std::istream& operator>>(std::istream& is, Tracked& x) { return is >> x.value; }
+};
+
+boost::detail::atomic_count Tracked::s_nLive(0);
+
+typedef SmartArray<Tracked> TrackedArray;
+typedef SmartPtr<Tracked> TrackedPtr;
+
+const int ARRAY_SIZE = 64;
+const int PTR_VALUE = 42;
+
+//! Copies, modifies and releases the shared objects 'nIters' times
+void Worker(int id, int nIters, const TrackedArray& sharedArr, const TrackedPtr& sharedPtr,
+	boost::barrier& start, boost::detail::atomic_count& nErrors)
+{
+	Tracked item;
+
+	item.value = -1;
+
+	start.wait();
+
+	for (int it = 0; it < nIters; it++)
+	{
+		const int k = (id + it) % ARRAY_SIZE;
+
+		// Copy-on-write of an array shared with all the other threads
+		TrackedArray a(sharedArr), b;
+		const TrackedArray& ca = a;
+
+		b = a;
+		b[k].value = -id - 1;
+
+		if (ca[k].value != k || ((const TrackedArray&)b)[k].value != -id - 1)
+			++nErrors;
+
+		// Growth of a copy, which must leave the shared block alone
+		a.AddTail(item);
+
+		if (ca.GetSize() != ARRAY_SIZE + 1 || sharedArr.GetSize() != ARRAY_SIZE)
+			++nErrors;
+
+		// Move assignment swaps the blocks, which are released with a and b
+		b = std::move(a);
+
+		// Copy-on-write of a pointer shared with all the other threads
+		TrackedPtr p(sharedPtr), q;
+
+		q = p;
+		q->value = id + 1;
+
+		if (((const TrackedPtr&)p)->value != PTR_VALUE || ((const TrackedPtr&)q)->value != id + 1)
+			++nErrors;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int nThreads = (argc > 1) ? atoi(argv[1]) : (int) boost::thread::hardware_concurrency();
+	int nIters = (argc > 2) ? atoi(argv[2]) : 100000;
+	boost::detail::atomic_count nErrors(0);
+
+	nThreads = MAX(nThreads, 2);
+
+	cout << "Stress test of SmartArray and SmartPtr with " << nThreads
+		<< " threads and " << nIters << " iterations" << endl;
+
+	{
+		TrackedArray sharedArr;
+		TrackedPtr sharedPtr(new Tracked);
+		boost::barrier start(nThreads);
+		boost::thread_group threads;
+		int i;
+
+		// Filled with AddTail(), as the shock branches are, so that the copies can grow
+		for (i = 0; i < ARRAY_SIZE; i++)
+		{
+			Tracked x;
+
+			x.value = i;
+			sharedArr.AddTail(x);
+		}
+
+		sharedPtr->value = PTR_VALUE;
+
+		for (i = 0; i < nThreads; i++)
+			threads.create_thread(boost::bind(&Worker, i, nIters, boost::cref(sharedArr),
+				boost::cref(sharedPtr), boost::ref(start), boost::ref(nErrors)));
+
+		threads.join_all();
+
+		// The shared objects must be intact and referenced only once
+		for (i = 0; i < ARRAY_SIZE; i++)
+			if (((const TrackedArray&)sharedArr)[i].value != i)
+				++nErrors;
+
+		if (((const TrackedPtr&)sharedPtr)->value != PTR_VALUE || sharedPtr.Links() != 1)
+			++nErrors;
+
+		if (Tracked::s_nLive != sharedArr.GetCapacity() + 1)
+		{
+			cout << "Live elements after join: " << (long) Tracked::s_nLive
+				<< " (expected " << sharedArr.GetCapacity() + 1 << ")" << endl;
+			++nErrors;
+		}
+	}
+
+	if (Tracked::s_nLive != 0)
+	{
+		cout << "Leaked elements: " << (long) Tracked::s_nLive << endl;
+		++nErrors;
+	}
+
+	cout << ((nErrors == 0) ? "OK" : "FAILED") << " (" << (long) nErrors << " errors)" << endl;
+
+	return (nErrors == 0) ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+/* ************* Begin file AllPairsMatcher.h ***************************************/
+/*
+** 2015 October 17
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file AllPairsMatcher.h
+*	\brief Computes the similarity matrix of a set of models, tile by tile.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _ALL_PAIRS_MATCHER_H_
+#define _ALL_PAIRS_MATCHER_H_
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include "BasicTypedefs.h"
+#include "DAGMatcher.h"
+#include "SmartMatrix.h"
+
+namespace dml {
+
+//! A block of the similarity matrix: the rows nRow0... and the columns nCol0...
+struct MatrixTile
+{
+	int nTile;                   //!< Index of the tile in the order of AllPairsMatcher
+	int nRow0, nCol0;
+	int nRows, nCols;
+	std::vector<double> values;  //!< Similarity of row query to column model, row after row
+	bool bResumed;               //!< Read from the checkpoint file instead of computed
+
+	double At(int i, int j) const { return values[(i - nRow0) * nCols + (j - nCol0)]; }
+};
+
+/*!
+	\brief Receives the tiles of an AllPairsMatcher as they are finished,
+	so that the matrix doesn't have to fit in memory.
+
+	WriteTile() is called by one thread at a time, in no particular order.
+*/
+class MatrixTileSink
+{
+public:
+	virtual ~MatrixTileSink() { }
+	virtual void WriteTile(const MatrixTile& tile, bool bSymmetric) = 0;
+};
+
+/*!
+	\brief Writes the tiles as MATLAB assignments to a matrix variable, so
+	that running the file gives the matrix however the tiles were ordered.
+*/
+class MatlabTileWriter : public MatrixTileSink
+{
+	std::ostream& m_os;
+	std::string m_strVarName;
+
+public:
+	MatlabTileWriter(std::ostream& os, const std::string& strVarName = "S")
+		: m_os(os), m_strVarName(strVarName)
+	{
+	}
+
+	virtual void WriteTile(const MatrixTile& tile, bool bSymmetric);
+};
+
+/*!
+	\brief Computes the similarity of every pair of N models with a pool of
+	threads.
+
+	The N x N matrix is split into square tiles. If the similarity is taken
+	as symmetric, only the tiles on and above the diagonal are computed, and
+	each of them also stands for its transpose. The tiles can be split among
+	several processes: shard s of S computes the tiles whose index is s
+	modulo S, where the tiles are indexed row after row.
+
+	Each thread matches the models of its tile within its own MatchContext,
+	and on its own copies of them, since the matchers attach node arrays to
+	the graphs they match.
+
+	When a checkpoint file is given, each finished tile is appended to it,
+	and the tiles already in it are not computed again, so that an
+	interrupted run can be resumed. A run over a complete checkpoint only
+	reads it, which is also how the tiles of several shards are gathered:
+	one run per shard, with its checkpoint, into the same matrix.
+	A checkpoint is only resumed by a run over the same models, with the
+	same matching parameters, tile size and shard.
+*/
+class AllPairsMatcher
+{
+public:
+	struct Stats
+	{
+		int nTiles;          //!< Tiles of the shard
+		int nTilesComputed;  //!< Tiles computed by the last run
+		int nTilesResumed;   //!< Tiles read from the checkpoint file
+		long nMatches;       //!< Matches done by the last run
+
+		Stats() { nTiles = nTilesComputed = nTilesResumed = 0; nMatches = 0; }
+	};
+
+private:
+	struct RunPlan;
+
+	DAGMatcher::MatchParams m_params;
+	std::vector<DAGPtr> m_models;
+	int m_nThreads;
+	int m_nTileSize;
+	int m_nShard, m_nShardCount;
+	bool m_bSymmetric;
+	std::string m_strCheckpointFile;
+	MatrixTileSink* m_pSink;
+	Stats m_stats;
+
+	//! The tiles of the shard, without their values
+	void GetShardTiles(std::vector<MatrixTile>* pTiles) const;
+
+	//! Hash of the matching parameters, to tell whether a checkpoint was computed with them
+	unsigned int GetParamsFingerprint() const;
+
+	//! Hash of the database keys and the node and edge attributes of the models
+	unsigned int GetModelsFingerprint() const;
+
+	void WriteCheckpointHeader(std::ostream& os) const;
+	void ReadCheckpoint(std::fstream& fs, RunPlan* pPlan) const;
+
+	static void ComputeTiles(RunPlan* pPlan);
+	static void StoreTile(RunPlan* pPlan, const MatrixTile& tile);
+
+public:
+	//! Uses the parameters of the current MatchContext
+	AllPairsMatcher();
+
+	explicit AllPairsMatcher(const DAGMatcher::MatchParams& params);
+
+	void SetParams(const DAGMatcher::MatchParams& params) { m_params = params; }
+
+	//! Number of threads used by Run(). -1 (the default) means one per core.
+	void SetThreadCount(int nThreads) { m_nThreads = nThreads; }
+
+	//! Side of the tiles. 32 by default.
+	void SetTileSize(int nTileSize) { m_nTileSize = MAX(1, nTileSize); }
+
+	//! Makes Run() compute only the tiles of shard nShard out of nShardCount
+	void SetShard(int nShard, int nShardCount);
+
+	/*!
+		If true (the default), the similarity of model j as query to model i
+		is taken to be that of model i to model j, for i < j, which halves
+		the number of matches.
+	*/
+	void SetSymmetric(bool bSymmetric) { m_bSymmetric = bSymmetric; }
+
+	//! File where the finished tiles are saved. None by default.
+	void SetCheckpointFile(const std::string& strFileName) { m_strCheckpointFile = strFileName; }
+
+	//! Receives each tile of the shard when it's finished, including those read from the checkpoint
+	void SetSink(MatrixTileSink* pSink) { m_pSink = pSink; }
+
+	void ClearModels() { m_models.clear(); }
+	void AddModel(DAGPtr ptrModel);
+	int GetModelCount() const { return (int) m_models.size(); }
+
+	/*!
+		Computes the tiles of the shard.
+
+		@param pMatrix if not NULL, it's filled with the tiles of the shard.
+		       If it isn't N x N, it's first resized to N x N and zeroed,
+		       otherwise its other cells are left untouched.
+		@return the number of tiles of the shard
+	*/
+	int Run(SmartMatrix<double>* pMatrix = NULL);
+
+	//! Counters of the last Run()
+	const Stats& GetStats() const { return m_stats; }
+};
+
+} //namespace dml
+
+#endif //_ALL_PAIRS_MATCHER_H_
@@ -0,0 +1,161 @@
+/* ************* Begin file BeliefPropMWBGM.h ***************************************/
+/*
+** 2015 October 18
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file BeliefPropMWBGM.h
+*	\brief Approximate maximum weight bipartite matching by belief propagation.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _BELIEF_PROP_MWBGM_H_
+#define _BELIEF_PROP_MWBGM_H_
+
+#include <vector>
+#include <LEDA/graph/graph.h>
+#include "BasicUtils.h"
+
+namespace dml {
+
+/*!
+	\brief Solves the maximum weight assignment between the rows and the
+	columns of a dense profit matrix by max-product belief propagation,
+	after Bert Huang's b-matching code (with b = 1).
+
+	It has the interface of AssignmentSolver, but each iteration costs
+	O(n^2) and can be split among threads, so it's a fast alternative for
+	large problems. The result is optimal when the optimum is unique and
+	the messages converge. The profits are perturbed by a tiny amount to
+	make the optimum unique, so ties are broken arbitrarily. If the
+	messages don't converge within the maximum number of iterations, the
+	beliefs are turned greedily into a one-to-one assignment, which may not
+	be optimal.
+
+	The messages are kept in log space, in two flat n x n matrices indexed
+	by receiver, so each node reads its incoming messages contiguously. As
+	with AssignmentSolver, the matrix is padded to a square, cells with a
+	non-positive profit are never part of the result, and every buffer only
+	grows.
+*/
+class BeliefPropSolver
+{
+	int m_nRows, m_nCols;
+	int m_nSize;                       //!< Side of the padded square matrix
+
+	// Settings
+	int m_nMaxIters;
+	int m_nStableIters;
+	int m_nThreads;
+
+	std::vector<double> m_profit;      //!< Profit of each cell, row after row. Zero if not positive
+	std::vector<leda::edge> m_edges;   //!< Edge with the best profit of each cell. nil if none
+	std::vector<int> m_nodeSlots;      //!< Graph node index -> row or column
+
+	// Weights and messages of the last solve
+	std::vector<double> m_rowWeights;  //!< Perturbed profits, row after row
+	std::vector<double> m_colWeights;  //!< The same, column after column
+	std::vector<double> m_toRow;       //!< Message from column j to row i at [i * n + j]
+	std::vector<double> m_toCol;       //!< Message from row i to column j at [j * n + i]
+
+	// Beliefs and result
+	std::vector<int> m_belief;         //!< Best column of each row given its messages
+	std::vector<int> m_lastBelief;
+	std::vector<int> m_colCount;       //!< Rows whose belief is each column
+	std::vector<int> m_rowToCol, m_colToRow;
+	int m_nIters, m_nStable;
+	bool m_bConverged;
+
+	struct SolvePlan;
+
+	void PrepareWeights();
+	bool EndIteration();
+	void Decode();
+
+	static int UpdateMessages(const double* weights, const double* in, double* out, int n, int k);
+	static void Iterate(SolvePlan* pPlan, int nThread);
+
+public:
+	BeliefPropSolver();
+
+	//! Starts a new problem with all the profits at zero
+	void Init(int nRows, int nCols);
+
+	/*!
+		Starts a new problem with the edges of G, which must go from the nodes
+		in A (rows) to the nodes in B (columns). The profit of each pair of
+		nodes is the best value of the edges between them.
+	*/
+	void Init(const leda::graph& G, const leda::list<leda::node>& A,
+		const leda::list<leda::node>& B, const leda::edge_array<double>& profits);
+
+	int GetRowCount() const { return m_nRows; }
+	int GetColCount() const { return m_nCols; }
+
+	//! Gives a profit to a cell. The best profit given to the cell is kept.
+	void SetProfit(int i, int j, double profit, leda::edge e = nil)
+	{
+		ASSERT(i >= 0 && i < m_nRows && j >= 0 && j < m_nCols);
+
+		double& p = m_profit[i * m_nSize + j];
+
+		if (profit > p)
+		{
+			p = profit;
+			m_edges[i * m_nSize + j] = e;
+		}
+	}
+
+	double GetProfit(int i, int j) const { return m_profit[i * m_nSize + j]; }
+
+	//! Iterations after which the beliefs are used as they are. 200 by default.
+	void SetMaxIterations(int nMaxIters) { m_nMaxIters = MAX(1, nMaxIters); }
+
+	//! Iterations that the beliefs must stay the same, one-to-one assignment to stop. 5 by default.
+	void SetStableIterations(int nStableIters) { m_nStableIters = MAX(1, nStableIters); }
+
+	/*!
+		Threads that update the messages. -1 means one per core, and 1 (the
+		default) none besides the caller. Small problems use fewer threads.
+	*/
+	void SetThreadCount(int nThreads) { m_nThreads = nThreads; }
+
+	/*!
+		Solves the problem.
+
+		@return the sum of the profits of the assigned cells
+	*/
+	double Solve();
+
+	//! Column assigned to row i, or -1 if none (or only one with no profit)
+	int GetAssignedCol(int i) const
+	{
+		int j = m_rowToCol[i];
+
+		return (j >= 0 && j < m_nCols && m_profit[i * m_nSize + j] > 0) ? j : -1;
+	}
+
+	//! Edges of the assigned cells, if the problem came from a graph
+	void GetMatching(leda::list<leda::edge>* pMatching) const;
+
+	//! Iterations run by the last Solve()
+	int GetIterationCount() const { return m_nIters; }
+
+	//! True if the beliefs of the last Solve() settled before the maximum number of iterations
+	bool HasConverged() const { return m_bConverged; }
+
+	//! The solver of the current MatchContext
+	static BeliefPropSolver& Scratch();
+};
+
+} //namespace dml
+
+#endif //_BELIEF_PROP_MWBGM_H_
@@ -36,6 +36,8 @@
 
 #include <LEDA/graph/graph.h>
 #include "BasicUtils.h"
+#include "AssignmentSolver.h"
+#include "BeliefPropMWBGM.h"
 
 namespace dml {
 typedef leda::list<leda::edge> NodeAssigmentList;
@@ -113,14 +115,49 @@ public:
 		return this->number_of_edges();
 	}
 
+	/*!
+		Label that identifies node v across the bipartite graphs solved one
+		after the other, so that the assignment solver can start from the
+		previous solution. -1 if there is none.
+	*/
+	virtual int GetNodeLabel(leda::node v) const
+	{
+		return -1;
+	}
+
 	//! Computes a one-to-one assigment between nodes in sets A and B
 	void SolveMaxWeightAssignment(const EdgeValueArray& edgeValues,
 		                          NodeAssigmentList* pNodeAssigments)
 	{
+#ifdef USE_LEDA_MWBM_ASSIGNMENT
 		// Compute maximum weight assignment
 		//MWBM_SCALE_WEIGHTS(*this, edgeValues);
 
 		*pNodeAssigments = MAX_WEIGHT_BIPARTITE_MATCHING(*this, edgeValues);
+#elif defined(USE_BELIEF_PROP_ASSIGNMENT)
+		// Approximate the assignment by belief propagation. It ignores the node labels.
+		BeliefPropSolver& solver = BeliefPropSolver::Scratch();
+
+		solver.Init(*this, m_setA, m_setB, edgeValues);
+		solver.Solve();
+		solver.GetMatching(pNodeAssigments);
+#else
+		// Solve the dense assignment problem with the solver of the current context
+		AssignmentSolver& solver = AssignmentSolver::Scratch();
+		NodeSetIterator it;
+		int i;
+
+		solver.Init(*this, m_setA, m_setB, edgeValues);
+
+		for (it = m_setA.first(), i = 0; it != nil; it = m_setA.succ(it), i++)
+			solver.SetRowLabel(i, GetNodeLabel(m_setA[it]));
+
+		for (it = m_setB.first(), i = 0; it != nil; it = m_setB.succ(it), i++)
+			solver.SetColLabel(i, GetNodeLabel(m_setB[it]));
+
+		solver.Solve();
+		solver.GetMatching(pNodeAssigments);
+#endif
 	}
 
 	//! Sums the values associated with each assignment
@@ -184,7 +221,7 @@ public:
 	//! Adds a node to the set 0 or the set 1
 	void AddNode(const T& a, int i)
 	{
-		GetSet(i).push(new_node(a));
+		GetSet(i).push(this->new_node(a));
 	}
 
 	//! Gets the number of nodes in set 0 or set 1
@@ -195,7 +232,7 @@ public:
 
 	void AddEdge(NodeSetIterator itA, NodeSetIterator itB, const U& a)
 	{
-		new_edge(m_setA.inf(itA), m_setB.inf(itB), a);
+		this->new_edge(m_setA.inf(itA), m_setB.inf(itB), a);
 	}
 
 	NodeSetIterator FirstNode(int i)
@@ -251,7 +288,7 @@ public:
 
 		forall_out_edges(e, v0)
 		{
-			if (inf(target(e)) != a1)
+			if (this->inf(target(e)) != a1)
 				(*pEdgeValidity)[e] = false;
 
 			DBG_ONLY(else validEdgeCount++)
@@ -273,7 +310,7 @@ public:
 			u = m_setA[itA];
 
 			forall_items(itB, m_setB)
-				new_edge(u, m_setB[itB], 1.0);
+				this->new_edge(u, m_setB[itB], 1.0);
 		}
 	}
 
@@ -282,7 +319,7 @@ public:
 	{
 		ASSERT(i == 0 || i == 1);
 
-		return (i == 0) ? inf(source(e)) : inf(target(e));
+		return (i == 0) ? this->inf(source(e)) : this->inf(target(e));
 	}
 
 	//! Copies the graph and both sets of nodes
@@ -51,8 +51,6 @@ class BoneGraph : public DAG
 protected:
 	SkeletalGraph* m_pSkeleton;
 
-	static DAGMatcher* s_pDAGMatcher; //!< Matching algorithm for bone graphs
-
 public:
 	// Member variables for displaying and debugging the representation
 	BezierSegmentArray m_skeletalGaps;
@@ -83,9 +81,7 @@ public:
 	virtual double ComputeTSVs(leda::node root);
 
 	// DAG pure virtual functions
-	virtual DAGMatcher* GetMatchingAlgorithm() const { return s_pDAGMatcher; }
-
-	virtual void SetMatchingAlgorithm();
+	virtual DAGMatcher* CreateMatchingAlgorithm(const DAGMatcher::MatchParams& params) const;
 	virtual bool AreNodesRelated(leda_node g1Node, const DAG& g2, leda_node g2Node) const;
 	virtual DAG* CreateObject() const;
 	virtual DAGNodePtr CreateNodeObject(NODE_LABEL lbl) const;
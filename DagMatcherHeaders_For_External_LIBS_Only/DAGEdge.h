@@ -34,6 +34,7 @@
 
 #include "SmartPtr.h"
 #include "DMLString.h"
+#include "MemoryArena.h"
 
 #define DEFAULT_DAG_EDGE_WEIGHT 1.0
 
@@ -54,6 +55,7 @@ protected:
 	double weight;
 
 public:
+	DECLARE_ARENA_ALLOCATION()
 
 	DAGEdge(const double& w = DEFAULT_DAG_EDGE_WEIGHT)
 	{
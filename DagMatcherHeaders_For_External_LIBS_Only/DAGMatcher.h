@@ -37,6 +37,8 @@
 #include "SimilarityMeasurer.h"
 
 namespace dml {
+class MatchContext; // Forward Declaration of the class contained in MatchContext.h
+
 //! The codomain of a NodeMatchMap. It's a node and a similarity value.
 struct NodeMatchCodomain
 {
@@ -102,6 +104,8 @@ public:
 
 		int nMaxNumSolSets;          //!< Maximum number of solutions sets
 		int nMaxSolSetsPerIter;      //!< Maximum number of new solutions sets per iteration
+		int nMaxExpandedSolSets;     //!< Maximum number of solution sets expanded per match (0 = no limit)
+		int nNodeSimThreads;         //!< Threads computing all node similarities when a match starts (0 = on demand, -1 = one per core)
 
 		double dBGWrongSidePen;      //!< Wrong side penalty for bone graphs
 		double dBGPositionSigma;     //!< Wrong side penalty for bone graphs
@@ -120,13 +124,22 @@ public:
 	};
 
 protected:
-	static MatchParams s_matchParams;
+	MatchContext* m_pContext;  //!< Parameters, scratch buffers and counters of the query
 
 	const DAG* m_pDag1;
 	const DAG* m_pDag2;
 
 	SimilarityMeasurer* m_pSimilarityMeasurer;
 
+	//! The context that owns the matcher, or the current one if there is none
+	MatchContext& Context() const;
+
+	//! The parameters of the context of the matcher
+	const MatchParams& Params() const;
+
+	//! Sets the graphs of a new match, whose node similarities are computed anew
+	void StartMatch(const DAG* pDag1, const DAG* pDag2);
+
 public:
 	const DAG& G1() const { return *m_pDag1; }
 	const DAG& G2() const { return *m_pDag2; }
@@ -134,9 +147,17 @@ public:
 public:
 	DAGMatcher(SimilarityMeasurer* pNodeDistMeasurer)
 	{
+		m_pContext = NULL;
 		m_pSimilarityMeasurer = pNodeDistMeasurer;
 	}
 
+	//! Called by the context that owns the matcher
+	void SetContext(MatchContext* pContext)
+	{
+		m_pContext = pContext;
+		m_pSimilarityMeasurer->SetContext(pContext);
+	}
+
 	//! This virtual destructor must be called from all derived classes
 	virtual ~DAGMatcher()
 	{
@@ -151,6 +172,9 @@ public:
 		m_pSimilarityMeasurer->Init(pDag1, pDag2);
 	}
 
+	//! The measurer of the node similarities, with the memo of the last match
+	const SimilarityMeasurer& GetSimilarityMeasurer() const { return *m_pSimilarityMeasurer; }
+
 	virtual void Clear()
 	{
 		m_pDag1 = NULL;
@@ -170,19 +194,33 @@ public:
 	}
 
 	double NodeTSVSimilarity(leda::node u, leda::node v) const;
+	static double TSVSimilarity(double diffNorm, double n1, double n2);
 
 	double NodeSimilarity(leda::node u, leda::node v,
 		NodeMatchInfoPtr ptrMatchInfo) const;
 
-	static void SetMatchParams(const MatchParams& matchParams)
-	{
-		s_matchParams = matchParams;
-	}
+	/*!
+		Upper bound of NodeSimilarity() for two nodes whose TSV similarity is
+		at most dTSVSimBound, assuming that dTSVSimWeight is in [0, 1].
+	*/
+	double NodeSimilarityBound(double dTSVSimBound, bool bSameType) const;
 
-	static const MatchParams& GetMatchParams()
-	{
-		return s_matchParams;
-	}
+	//! True if SimilarityBound() bounds the result of Match()
+	virtual bool BoundsSimilarity() const { return false; }
+
+	/*!
+		Upper bound of Match(g1, g2) for a match whose node similarities
+		add up to at most dNodeSimSum. The node pairs of the match must be
+		one-to-one and their similarities at most NodeSimilarityBound().
+		See MatchBoundCascade.
+	*/
+	virtual double SimilarityBound(const DAG& g1, const DAG& g2, double dNodeSimSum) const { return 1; }
+
+	//! Sets the parameters of the current MatchContext
+	static void SetMatchParams(const MatchParams& matchParams);
+
+	//! Gets the parameters of the current MatchContext
+	static const MatchParams& GetMatchParams();
 };
 } //namespace dml
 
@@ -66,13 +66,19 @@ public:
 
 	virtual ~DAGMatcherGreedy()
 	{
-		// Must call the destructor of the base class
-		//DAGMatcher::~DAGMatcher();
-		delete m_pSimilarityMeasurer;
+		// The similarity measurer is deleted by ~DAGMatcher()
 	}
 
 	virtual double Match(const DAG& g1, const DAG& g2);
 
+	virtual bool BoundsSimilarity() const { return true; }
+
+	//! Match() averages the similarity sum over the node counts of both DAGs
+	virtual double SimilarityBound(const DAG& g1, const DAG& g2, double dNodeSimSum) const
+	{
+		return (dNodeSimSum / g1.GetNodeCount() + dNodeSimSum / g2.GetNodeCount()) / 2.0;
+	}
+
 	//! Gets a one-to-one map from g1 nodes to g2 nodes
 	virtual void GetNodeMap(NodeMatchMap& nodeMap) const
 	{
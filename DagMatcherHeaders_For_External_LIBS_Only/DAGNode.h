@@ -50,6 +50,7 @@
 #include "SmartMatrix.h"
 #include "SmartPtr.h"
 #include "TSV.h"
+#include "MemoryArena.h"
 #include "DMLString.h"
 #include "BasicTypes.h"
 
@@ -99,6 +100,8 @@ class DAGNode
 public:
 	typedef int label_type;
 
+	DECLARE_ARENA_ALLOCATION()
+
 	DAGNode(NODE_LABEL lbl = NODE_LBL_DEFAULT_VAL);
 
 	DAGNode(const DAGNode& rhs) { DAGNode::operator=(rhs); }
@@ -0,0 +1,157 @@
+/* ************* Begin file MatchEngine.h ***************************************/
+/*
+** 2015 October 15
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file MatchEngine.h
+*	\brief Matches one query against many candidate models with a pool of threads.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _MATCH_ENGINE_H_
+#define _MATCH_ENGINE_H_
+
+#include <vector>
+#include <string>
+#include "BasicTypedefs.h"
+#include "DAGMatcher.h"
+#include "MatchBounds.h"
+
+namespace dml {
+
+//! Similarity between the query and one of the candidate models of a MatchEngine
+struct MatchResult
+{
+	int nCandidate;           //!< Index of the model in the candidate list
+	double dSimilarity;
+	std::string nodeMatches;  //!< Node correspondences, as given by DAG::GetNodeMapString(), if asked for
+
+	MatchResult() { nCandidate = -1; dSimilarity = 0; }
+};
+
+/*!
+	\brief Computes the similarity between one query and N candidate models,
+	using several threads.
+
+	Each thread runs its matches within its own MatchContext, so it has its
+	own matchers and similarity measurers, and works on its own copy of the
+	query. Each model is matched by one thread only. The models must be
+	distinct objects and must not be modified while Run() is going on.
+
+	If only the k most similar models are wanted, the candidates can be
+	given an upper bound of their similarity. They are matched by decreasing
+	bound, and those whose bound can't beat the k-th best similarity found
+	so far are skipped. Once the k best are settled, the remaining
+	candidates are skipped without matching them. Besides, each candidate
+	is bounded by a MatchBoundCascade before it is matched, which prunes
+	the hopeless ones with a fraction of the work of a match.
+
+	The results are sorted by decreasing similarity, with ties broken by
+	candidate index, so they don't depend on the number of threads or on
+	the order in which the matches finish.
+*/
+class MatchEngine
+{
+public:
+	static const double NO_BOUND; //!< Upper bound of the candidates whose similarity isn't bounded
+
+	struct Stats
+	{
+		int nCandidates;
+		int nMatched;  //!< Candidates fully matched
+		int nSkipped;  //!< Candidates whose given upper bound couldn't enter the k best
+		int nBounded;  //!< Candidates bounded by the cascade
+		int nPruned;   //!< Candidates whose cascade bound couldn't enter the k best
+		int nPrunedAt[MatchBoundCascade::NUM_BOUND_STAGES]; //!< Candidates pruned by each stage of the cascade
+
+		Stats()
+		{
+			nCandidates = nMatched = nSkipped = nBounded = nPruned = 0;
+
+			for (int i = 0; i < MatchBoundCascade::NUM_BOUND_STAGES; i++)
+				nPrunedAt[i] = 0;
+		}
+
+		//! Full matches that were avoided
+		int AvoidedMatchCount() const { return nSkipped + nPruned; }
+	};
+
+private:
+	struct Candidate
+	{
+		DAGPtr ptrModel;
+		double dUpperBound;
+	};
+
+	struct RunPlan;
+
+	DAGMatcher::MatchParams m_params;
+	std::vector<Candidate> m_candidates;
+	int m_nThreads;
+	int m_nTopK;
+	bool m_bNodeMaps;
+	bool m_bBoundCascade;
+	Stats m_stats;
+
+	static void MatchCandidates(RunPlan* pPlan);
+
+public:
+	//! Uses the parameters of the current MatchContext
+	MatchEngine();
+
+	explicit MatchEngine(const DAGMatcher::MatchParams& params);
+
+	const DAGMatcher::MatchParams& GetParams() const { return m_params; }
+	void SetParams(const DAGMatcher::MatchParams& params) { m_params = params; }
+
+	//! Number of threads used by Run(). -1 (the default) means one per core.
+	void SetThreadCount(int nThreads) { m_nThreads = nThreads; }
+
+	//! Only the k most similar models are returned. 0 (the default) returns all of them.
+	void SetTopK(int k) { m_nTopK = k; }
+
+	//! Gets the node correspondences of each match too. Off by default.
+	void ComputeNodeMaps(bool bOn) { m_bNodeMaps = bOn; }
+
+	/*!
+		Bounds each candidate with a MatchBoundCascade before matching it,
+		once k results have been found, and skips it if it can't enter the
+		k best. The results are the same either way. On by default.
+	*/
+	void UseBoundCascade(bool bOn) { m_bBoundCascade = bOn; }
+
+	void ClearCandidates() { m_candidates.clear(); }
+
+	/*!
+		Adds a model to match. If dUpperBound is given, the similarity of the
+		model to the query must not be greater than it.
+	*/
+	void AddCandidate(DAGPtr ptrModel, double dUpperBound = NO_BOUND);
+
+	int GetCandidateCount() const { return (int) m_candidates.size(); }
+	const DAGPtr& GetCandidate(int i) const { return m_candidates[i].ptrModel; }
+
+	/*!
+		Matches the query with the candidates and returns the results,
+		best first.
+
+		@return the number of results
+	*/
+	int Run(const DAG& query, std::vector<MatchResult>* pResults);
+
+	//! Counters of the last Run()
+	const Stats& GetStats() const { return m_stats; }
+};
+
+} //namespace dml
+
+#endif //_MATCH_ENGINE_H_
@@ -38,6 +38,7 @@ namespace dml {
 typedef SmartMatrix<double> SimMatrix;
 typedef SmartArray<int> NodeIdxArray;
 typedef SmartArray<NodeIdxArray> NodeIdxMatrix;
+typedef std::vector<BitMatrix::Mask> NodeMaskArray;
 
 /*!
 	Represents a node correspondance between a node in a query
@@ -55,41 +56,38 @@ class MatchedNodePair
 	int q;                               //!< DFS index of query node
 	int m;                               //!< DFS index of model node
 
-	const SmartMatrix<int>* pQueryTCM;   //!< Query's transitive closure matrix
-	const SmartMatrix<int>* pModelTCM;   //!< Models's transitive closure matrix
+	const DAG* pQuery;                   //!< Query graph, for its closure matrices
+	const DAG* pModel;                   //!< Model graph, for its closure matrices
 
 	NodeIdxMatrix qparents;              //!< Adjacency matrix for query graph
 	NodeIdxMatrix mparents;              //!< Adjacency matrix for model graph
 
+	NodeMaskArray qparentMasks;          //!< Parents of each query node as a mask of DFS indices
+	NodeMaskArray mparentMasks;          //!< Parents of each model node as a mask of DFS indices
+
 private:
-	static bool IsAncestor(int u, int v, const SmartMatrix<int>& tcm)
+	static bool IsAncestor(int u, int v, const BitMatrix& tcm)
 	{
-		return tcm[u][v] != 0;
+		return tcm.Test(u, v);
 	}
 
-	static bool IsSibling(int u, int v, const SmartMatrix<int>& tcm,
-		const NodeIdxMatrix& parents)
+	//! True if 'u' descends from a parent of 'v', ie, if one of its ancestors is in the parents mask of 'v'
+	static bool IsSibling(int u, int v, const DAG& g, const NodeMaskArray& parentMasks)
 	{
-		const NodeIdxArray& vpar = parents[v];
-
-		for (int i = 0; i < vpar.GetSize(); i++)
-			if (IsAncestor(vpar[i], u, tcm))
-				return true;
-
-		return false;
+		return g.HasAncestorIn(u, parentMasks[v]);
 	}
 
-	static NodeIdxArray GetSiblingsVector(int v, const SmartMatrix<int>& tcm,
+	static NodeIdxArray GetSiblingsVector(int v, const BitMatrix& tcm,
 		const NodeIdxMatrix& parents);
 
 public:
 	MatchedNodePair(const DAG& query, const DAG& model)
 	{
-		pQueryTCM = &query.GetTransClosMat();
-		pModelTCM = &model.GetTransClosMat();
+		pQuery = &query;
+		pModel = &model;
 
-		SetParents(query, qparents);
-		SetParents(model, mparents);
+		SetParents(query, qparents, qparentMasks);
+		SetParents(model, mparents, mparentMasks);
 
 		SetEmpty();
 	}
@@ -104,21 +102,23 @@ public:
 		m = v2;
 	}
 
-	void SetParents(const DAG& g, NodeIdxMatrix& parents);
+	void SetParents(const DAG& g, NodeIdxMatrix& parents, NodeMaskArray& parentMasks);
 
 	int GetQueryNode() const { return q; }
 	int GetModelNode() const { return m; }
 
 	bool AncestorRelPreserved(int qq, int mm) const
 	{
-		bool aq = IsAncestor(qq, q, *pQueryTCM), am = IsAncestor(mm, m, *pModelTCM);
+		bool aq = IsAncestor(qq, q, pQuery->GetTransClosMat());
+		bool am = IsAncestor(mm, m, pModel->GetTransClosMat());
+
 		return (aq && am) || (!aq && !am);
 	}
 
 	bool SiblingRelPreserved(int qq, int mm) const
 	{
-		bool sq = IsSibling(qq, q, *pQueryTCM, qparents);
-		bool sm = IsSibling(mm, m, *pModelTCM, mparents);
+		bool sq = IsSibling(qq, q, *pQuery, qparentMasks);
+		bool sm = IsSibling(mm, m, *pModel, mparentMasks);
 
 		return (sq && sm) || (!sq && !sm);
 	}
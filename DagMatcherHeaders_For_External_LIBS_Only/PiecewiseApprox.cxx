@@ -95,6 +95,7 @@ void PiecewiseApprox<SEGMENT>::Fit(const POINTS pts)
 	ASSERT(n > 1);
 
 	m_points = pts;
+	m_sums.Init(pts);
 	m_segments.Resize(n, n);
 	m_minerrors.Resize(n);
 	m_knots.Clear();
@@ -138,7 +139,7 @@ MEMDATA PiecewiseApprox<SEGMENT>::Min(int seg_num, int s, int e)
 
 		if (seg_num == 1)
 		{
-			minerror = LeastSquares(m_points, s, e, m_segments[s][e]);
+			minerror = FitSegment(s, e, m_segments[s][e]);
 			minpt = s;
 		}
 		else
@@ -42,15 +42,21 @@ class PolyLineApprox : public PiecewiseApprox<LineSegment>
 {
 protected:
 	double m_dMinSlope;
+	bool m_bUsePrefixSums;
 
 public:
 	PolyLineApprox(double dMinError, double dMinSlope, int nMaxSegments, double dMaxYDiff)
 		: PiecewiseApprox<LineSegment>(dMinError, nMaxSegments, dMaxYDiff)
 	{
 		m_dMinSlope =  dMinSlope;
+		m_bUsePrefixSums = true;
 	}
 
+	//! Fits the segments with the prefix sums (the default) or from the points. Only useful to measure the difference.
+	void UsePrefixSums(bool bOn) { m_bUsePrefixSums = bOn; }
+
 	virtual double LeastSquares(const POINT* vertices, int n, LineSegment& s);
+	virtual double FitSegment(int s, int e, LineSegment& seg);
 	virtual int GetSegmentDirection(const LineSegment& s) const;
 	virtual void PlotKnots(int seg_num) const;
 
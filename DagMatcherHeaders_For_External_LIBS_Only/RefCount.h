@@ -0,0 +1,77 @@
+/* ************* Begin file RefCount.h ***************************************/
+/*
+** 2015 October 10
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file RefCount.h
+*	\brief Reference counter shared by the copy-on-write SmartArray and SmartPtr.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*
+*	Define DML_SINGLE_THREADED_REFCOUNT to use plain integers when the shared
+*	objects never cross threads.
+*/
+
+#ifndef _REF_COUNT_H_
+#define _REF_COUNT_H_
+
+#ifndef DML_SINGLE_THREADED_REFCOUNT
+#include <boost/smart_ptr/detail/atomic_count.hpp>
+#endif
+
+namespace dml {
+
+/*!
+	\brief Number of references to a shared block of data.
+
+	Increments and decrements are atomic, so the objects referring to the
+	same data can be copied and destroyed from different threads. The data
+	itself is not locked: it must not be modified while it is shared, which
+	is what the copy-on-write of SmartArray and SmartPtr guarantees.
+
+	Release() doesn't touch the atomic counter when the caller holds the only
+	reference, so data confined to one thread pays almost nothing for it.
+*/
+class RefCount
+{
+#ifdef DML_SINGLE_THREADED_REFCOUNT
+	long m_nCount;
+#else
+	boost::detail::atomic_count m_nCount;
+#endif
+
+	RefCount(const RefCount&);            // not copyable
+	RefCount& operator=(const RefCount&);
+
+public:
+	RefCount() : m_nCount(1) { }
+
+	void AddRef() { ++m_nCount; }
+
+	//! Drops one reference. Returns true if it was the last one, ie, the data must be destroyed
+	bool Release()
+	{
+		// Only the caller can see the data, so no other thread can add a reference
+		if (Get() == 1)
+			return true;
+
+		return --m_nCount == 0;
+	}
+
+	//! True if somebody else refers to the data, ie, it must be copied before it is modified
+	bool IsShared() const { return Get() > 1; }
+
+	long Get() const { return (long) m_nCount; }
+};
+
+} //namespace dml
+
+#endif //_REF_COUNT_H_
@@ -41,28 +41,45 @@ typedef SimilarityMeasurerT<ShockGraph> SGSimilarityMeasurer;
 
 class SGRadialSimilarityMeasurer: public SGSimilarityMeasurer
 {
+public:
+	//! The two ModelFit::Fit() of each pair of nodes are worth memoizing
+	virtual bool MemoizesNodeSimilarities() const { return true; }
+
+	//! Nodes of different types are at MAXDIST, unless the nodes aren't compared at all
+	virtual bool ComparesOnlySameTypes() const { return Context().GetParams().nCompareNodes != 0; }
+
+private:
 	virtual double ComputeNodeDistance(leda::node v1, leda::node v2,
 		const ParamIndices& parInds, double* pSimilarity = NULL) const;
 
+	//! The part of ComputeNodeDistance() that reads the data of the nodes. i1 and i2 are -1 unless frozen.
+	double ComputeDescriptorDistance(leda::node v1, leda::node v2, int i1, int i2,
+		const ModelFitDescriptor& desc1, const ModelFitDescriptor& desc2) const;
+
+	virtual double ComputeNodePairSimilarity(leda::node v1, leda::node v2) const
+	{
+		// Note: ParamIndices(0) creates a zero-size array of parameters
+		return 1 - ComputeNodeDistance(v1, v2, ParamIndices(0));
+	}
+
 	virtual double ComputeNodeSimilarity(leda::node v1, leda::node v2,
 		const ParamIndices& parInds) const
 	{
-		return 1 - ComputeNodeDistance(v1, v2, ParamIndices(0));
+		return MemoizedNodeSimilarity(v1, v2);
 	}
 
 	virtual double ComputeNodeSimilarity(leda::node v1, leda::node v2,
 		NodeMatchInfoPtr ptrMatchInfo) const
 	{
-	    // Note: ParamIndices(0) creates a zero-size array of parameters
 	    if (ptrMatchInfo.IsNull())
 	    {
-	        return 1 - ComputeNodeDistance(v1, v2, ParamIndices(0));
+	        return MemoizedNodeSimilarity(v1, v2);
 	    }
         else
         {
             if (!ptrMatchInfo->HasNodeSimilarity(0))
             {
-                double nodeSim = 1 - ComputeNodeDistance(v1, v2, ParamIndices(0));
+                double nodeSim = MemoizedNodeSimilarity(v1, v2);
 
                 ptrMatchInfo->SetNodeSimilarity(0, nodeSim);
             }
@@ -0,0 +1,73 @@
+/* ************* Begin file SimdKernels.h ***************************************/
+/*
+** 2015 October 14
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file SimdKernels.h
+*	\brief Vectorized loops over the SoA point arrays of the shock graph nodes.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*
+*	The kernels use SSE2 or AVX, whichever the CPU has, and plain loops
+*	otherwise. Define DML_NO_SIMD to build only the plain loops, or
+*	DML_NO_AVX for compilers without the AVX intrinsics.
+*/
+
+#ifndef _SIMD_KERNELS_H_
+#define _SIMD_KERNELS_H_
+
+namespace dml {
+namespace simd {
+
+//! Instruction sets of the kernels, from the least to the most capable
+enum ISA { SCALAR, SSE2, AVX };
+
+//! The instruction set used by the kernels. The best one supported by the CPU, unless SetISA() says otherwise.
+ISA GetISA();
+
+/*!
+	Makes the kernels use the given instruction set, or the best one
+	supported below it. Only meant to compare them, before starting any
+	thread that runs the kernels.
+
+	@return the instruction set actually used
+*/
+ISA SetISA(ISA isa);
+
+const char* GetISAName(ISA isa);
+
+/*!
+	Sums of the absolute residuals of the points (x[i], y[i]) wrt the line
+	y = m * x + b, ie, sums[0] = 0 and sums[i + 1] = sums[i] + |y[i] - (m * x[i] + b)|,
+	for i = 0...n-1. The sums array must have n + 1 elements.
+
+	The vectorized versions add the residuals in a different order, so their
+	sums may differ from the plain ones at the level of rounding errors.
+*/
+void AbsResidualPrefixSums(const double* x, const double* y, int n,
+	double m, double b, double* sums);
+
+//! Cumulative lengths of the polyline through the n points: lens[0] = 0 and lens[i] = lens[i - 1] + |p[i] - p[i - 1]|
+void PolylineLengths(const double* x, const double* y, int n, double* lens);
+
+//! d[i] = 1 - MIN(a[i], b[i]) / MAX(a[i], b[i]), for i = 0...n-1
+void RatioDistances(const double* a, const double* b, int n, double* d);
+
+//! The scalar version of RatioDistances(), for a single pair
+inline double RatioDistance(double a, double b)
+{
+	return (a < b) ? 1 - a / b : 1 - b / a;
+}
+
+} //namespace simd
+} //namespace dml
+
+#endif //_SIMD_KERNELS_H_
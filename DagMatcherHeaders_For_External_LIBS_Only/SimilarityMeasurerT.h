@@ -62,6 +62,8 @@ template <class G> class SimilarityMeasurerT : public SimilarityMeasurer
 		m_pG2 = dynamic_cast<const G*>(pDag2);
 
 		ASSERT(m_pG1 && m_pG2);
+
+		InitMemo(pDag1, pDag2);
 	 }
 };
 } //namespace dml
@@ -40,6 +40,7 @@
 #define _SMART_PTR_H_
 
 #include "BasicUtils.h"
+#include "RefCount.h"
 
 template<class T> class SmartPtr;
 
@@ -62,6 +63,10 @@ template<class T> std::istream& operator>>(std::istream& is, SmartPtr<T>& x);
 	whether we have a pointer to an object T or to a class derived from T. Thus,
 	the only solution is to force T to have a virtual function that will
 	create and copy the correct type of object.
+
+	The reference count is atomic (see dml::RefCount), so pointers to the same
+	object can be copied and destroyed from different threads, and the
+	copy-on-write gives each writer its own object.
 */
 
 template<class T> class SmartPtr
@@ -69,12 +74,21 @@ template<class T> class SmartPtr
 protected:
 	struct DATAREF {
 		T* pData;
-		int nLinks;
-		DATAREF() { nLinks = 1; }
+		dml::RefCount links;
 	};
 
 	DATAREF* ptr;
 
+	//! Drops a reference to 'p' and destroys it if it was the last one
+	static void Release(DATAREF* p)
+	{
+		if (p->links.Release())
+		{
+			delete p->pData;
+			delete p;
+		}
+	}
+
 public:
 
 	SmartPtr()
@@ -96,7 +110,7 @@ public:
 
 		// There is someone else ponting at this object, so add one ref
 		// s.t. we don't destroy the actual data in the destructor.
-		ptr->nLinks++;
+		ptr->links.AddRef();
 	}
 
 	SmartPtr(const T& obj)
@@ -108,19 +122,13 @@ public:
 
 	SmartPtr(const SmartPtr<T>& x)
 	{
-		x.ptr->nLinks++;
+		x.ptr->links.AddRef();
 		ptr = x.ptr;
 	}
 
 	~SmartPtr()
 	{
-		if (--ptr->nLinks == 0)
-		{
-			if (ptr->pData)
-				delete ptr->pData;
-
-			delete ptr;
-		}
+		Release(ptr);
 	}
 
 	//! Clones the referred object and returns a ptr with ref count equal to 1
@@ -153,18 +161,21 @@ public:
 		in order to protect its original state.
 
 		The arrw operator is the only function that deals with
-		the COW behaviour.
+		the COW behaviour. The shared object is released only
+		after it is copied, since its other owners may release
+		it at the same time.
 	*/
 	T* operator->()
 	{
-		if (ptr->nLinks > 1)
+		if (ptr->links.IsShared())
 		{
-			ptr->nLinks--;
-			T* p = ptr->pData->CreateObject();
-			*p = *ptr->pData;
+			DATAREF* op = ptr;
+			T* p = op->pData->CreateObject();
+			*p = *op->pData;
 
 			ptr = new DATAREF;
 			ptr->pData = p;
+			Release(op);
 
 			WARNING(true, "possible not desired copy of data");
 		}
@@ -174,13 +185,9 @@ public:
 
 	SmartPtr<T>& operator=(const SmartPtr<T>& rhs)
 	{
-		rhs.ptr->nLinks++;	// protect against 'x = x'
+		rhs.ptr->links.AddRef();	// protect against 'x = x'
 
-		if (--ptr->nLinks == 0)
-		{
-			delete ptr->pData;
-			delete ptr;
-		}
+		Release(ptr);
 
 		ptr = rhs.ptr;
 		return *this;
@@ -188,10 +195,12 @@ public:
 
 	SmartPtr<T>& operator=(T* rhs)
 	{
-		if (ptr->nLinks > 1)
+		if (ptr->links.IsShared())
 		{
-			ptr->nLinks--;
+			DATAREF* op = ptr;
+
 			ptr = new DATAREF;
+			Release(op);
 		}
 		else
 		{
@@ -202,7 +211,7 @@ public:
 		return *this;
 	}
 
-	int Links() const { return ptr->nLinks; }
+	int Links() const { return (int) ptr->links.Get(); }
 
 	operator const T*() const { return ptr->pData; }
 	operator const T&() const { return *ptr->pData; }
@@ -220,6 +229,12 @@ public:
 #endif //WIN32
 };
 
+#ifdef DML_NO_LEDA
+//! Orders pointers by address. Without it, the conversion operators make '<' ambiguous.
+template<class T>
+bool operator<(const SmartPtr<T>& a, const SmartPtr<T>& b) { return (const T*)a < (const T*)b; }
+#endif //DML_NO_LEDA
+
 template<class T>
 std::ostream& operator<<(std::ostream& os, const SmartPtr<T>& x) { return os << *(x.ptr->pData); }
 
@@ -34,7 +34,9 @@
 #ifndef __SOLUTION_SET_H__
 #define __SOLUTION_SET_H__
 
-#include <LEDA/core/queue.h>
+#include <vector>
+#include <algorithm>
+#include <LEDA/core/p_queue.h>
 #include <LEDA/core/sortseq.h>
 
 #include "BipartiteNodeGraph.h"
@@ -47,9 +49,13 @@ typedef SharedPtr<SolutionSet> SolutionSetPtr;
 
 //typedef leda::sortseq<double, SolutionSetPtr> SolutionQueue;
 
-typedef leda::queue<SolutionSetPtr> SolutionQueue;
+/*!
+	Solution sets waiting to be expanded. The priority of a set is minus its
+	total similarity estimate, so that find_min() gives the most promising one.
+*/
+typedef leda::p_queue<double, SolutionSetPtr> SolutionQueue;
 
-typedef leda::seq_item SolutionQueueItem;
+typedef leda::pq_item SolutionQueueItem;
 
 /*!
 	@brief It is a set that stores one-to-one assignemt correspondeces
@@ -61,6 +67,7 @@ class SolutionSet
 public:
 	typedef BipartiteNodeGraph::AssignmentInfo NodeAssignment;
 	typedef BipartiteNodeGraph::AssignmentInfoList NodeAssignments;
+	typedef std::vector< std::pair<int, int> > CommittedPairs;
 
 protected:
 	const SolutionSetPtr m_ptrParent;     //!< previous state of the solution set
@@ -115,10 +122,15 @@ public:
 			&m_nodeAssigments, sortType);
 	}
 
-	//! Sort all nonzero node correspondences between nodes in the two graphs
+	/*!
+		Sort all nonzero node correspondences between nodes in the two graphs.
+		The similarity estimate is a bound that doesn't require solving the assignment.
+	*/
 	void AssignNonZeroCorrespondences(BipartiteNodeGraph::SORT_TYPE sortType)
 	{
 		m_bipGraph.GetNonZeroAssignments(&m_nodeAssigments, sortType);
+
+		m_nodeSimilarityEstimate = m_bipGraph.AssignmentUpperBound();
 	}
 
 	const NodeAssignments& GetNodeAssignments() const
@@ -199,6 +211,28 @@ public:
 		}
 	}
 
+	/*!
+		Fills the sorted list of the indices of the node pairs in the set,
+		which identifies the set regardless of the order of its matches
+	*/
+	void GetCommittedPairs(CommittedPairs* pPairs) const
+	{
+		const SolutionSet* pSet = this;
+
+		pPairs->clear();
+
+		while (!pSet->IsEmpty())
+		{
+			const NodePairInfo& npi = pSet->m_ptrNodeMatchInfo->GetNodePair();
+
+			pPairs->push_back(std::make_pair(index(npi.Node(0)), index(npi.Node(1))));
+
+			pSet = pSet->m_ptrParent;
+		}
+
+		std::sort(pPairs->begin(), pPairs->end());
+	}
+
 	void GetNodeMatchList(leda::list<NodeMatchInfoPtr>* pList) const
 	{
 		const SolutionSet* pSet = this;
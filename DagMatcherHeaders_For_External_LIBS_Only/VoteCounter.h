@@ -204,10 +204,6 @@ class PartitionBins
 	  SmartArray<BoundedBin> bins;
 	  double dCumulativeVote;
 
-	  // Ideally, the number of nodes in the model would be know.
-	  // This should be save in the NN info. Temporarely we use a fixed-size map.
-	  static SmartArray<leda_node> modelNodeMap;
-
 public:
 	  void AddVote(int idxElem, VOTE v)
 	  {
@@ -173,6 +173,13 @@ bool DBPool::threadDisconnect() throw(StandardExcept){
 		}
 }
 
+unsigned long DBPool::getConnectionCount() throw(StandardExcept){
+	_Lock_Pool_
+		unsigned long rslt = connectionMAP.size();
+	_Unlock_Pool_
+	return rslt;
+}
+
 bool DBPool::reconnect() throw(StandardExcept){
 	_Lock_Pool_
 		if (_inst == NULL){
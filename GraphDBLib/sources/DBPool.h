@@ -56,6 +56,12 @@ namespace graphDBLib {
 
 	bool threadDisconnect() throw(StandardExcept);
 
+	/*!
+	*	\fn unsigned long getConnectionCount() throw(StandardExcept);
+	*	\brief Number of thread specific DB Connections currently opened in the pool.
+	*/
+	unsigned long getConnectionCount() throw(StandardExcept);
+
 	/*!
 	*	\fn static bool query(const string& query) throw(StandardExcept);
 	*	\brief Static Method executing a query given in argument.
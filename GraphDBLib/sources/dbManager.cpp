@@ -93,6 +93,14 @@ bool DatabaseManager::Interface::closeThreadConnection() throw(StandardExcept){
 		throw StandardExcept((string)__FUNCTION__, "Database not opened");
 }
 
+unsigned long DatabaseManager::Interface::getOpenConnectionCount() throw(StandardExcept){
+	if( dbPool != NULL ){
+		return dbPool->getConnectionCount();
+	}
+	else
+		throw StandardExcept((string)__FUNCTION__, "Database not opened");
+}
+
 bool DatabaseManager::Interface::isDbOpen() {
 	if(dbPool == NULL)
 		return false;
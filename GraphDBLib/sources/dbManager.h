@@ -84,6 +84,8 @@ namespace graphDBLib {
 
 					static bool closeThreadConnection() throw(StandardExcept);
 
+					static unsigned long getOpenConnectionCount() throw(StandardExcept);
+
 					static pair<string,string> getServerInfos() throw(StandardExcept);
 
 					/*!
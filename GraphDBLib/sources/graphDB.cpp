@@ -77,6 +77,12 @@ bool GraphDB::closeThreadConnection() throw(StandardExcept) {
 	}
 }
 
+unsigned long GraphDB::getOpenConnectionCount() throw(StandardExcept) {
+	if (!DatabaseManager::Interface::isDbOpen())
+		return 0;
+	return DatabaseManager::Interface::getOpenConnectionCount();
+}
+
 void GraphDB::openDatabase(const string& _dbUser, const string& _dbPass, const string& _dbName, const string& _dbHost, const unsigned int& _dbPort, const string& _dbInit)   throw(StandardExcept) {
 	try{
 		if (DatabaseManager::Interface::isDbOpen()){
@@ -82,6 +82,12 @@ namespace graphDBLib {
 
 			static bool closeThreadConnection() throw(StandardExcept);
 
+			/*!
+			*	\fn static unsigned long getOpenConnectionCount() throw(StandardExcept);
+			*	\brief Number of per-thread connections currently held by the connection pool (0 if the DB is closed).
+			*/
+			static unsigned long getOpenConnectionCount() throw(StandardExcept);
+
 			static pair<string,string> getServerInfos() throw(StandardExcept);
 
 			/*!
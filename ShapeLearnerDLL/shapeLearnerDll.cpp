@@ -4,6 +4,9 @@
 #include "StandardException.h"
 #include "ShapeLearner.h"
 #include "jobManager.h"
+#include "metricsManager.h"
+#include "ingestionDriver.h"
+#include "signatureCache.h"
 #include "DAGMatcherLib.h"
 #include "CLogger.h"
 
@@ -56,6 +59,70 @@ __declspec(dllexport) unsigned int getActiveThread()
    return -1 ;
 }
 
+__declspec(dllexport) bool openSignatureCache(char* _indexPath)
+{
+   try {
+      SignatureCache::open(_indexPath);
+      return true;
+   }
+   catch (const std::exception& e)
+   {
+      Logger::Log(e.what (), constants::LogError);
+   }
+   return false;
+}
+
+__declspec(dllexport) unsigned long ingestDirectory(char* _rootDir, char* _imgClass, unsigned int _baseJobID, unsigned int _maxInFlight, char* _checkpointPath)
+{
+   try {
+      DirectorySource source(_rootDir);
+      IngestionDriver driver(source, _imgClass, _baseJobID, _maxInFlight, _checkpointPath);
+      return driver.run();
+   }
+   catch (const std::exception& e)
+   {
+      Logger::Log(e.what (), constants::LogError);
+   }
+   return 0;
+}
+
+__declspec(dllexport) unsigned long ingestManifest(char* _manifestPath, char* _imgClass, unsigned int _baseJobID, unsigned int _maxInFlight, char* _checkpointPath)
+{
+   try {
+      ManifestSource source(_manifestPath);
+      IngestionDriver driver(source, _imgClass, _baseJobID, _maxInFlight, _checkpointPath);
+      return driver.run();
+   }
+   catch (const std::exception& e)
+   {
+      Logger::Log(e.what (), constants::LogError);
+   }
+   return 0;
+}
+
+__declspec(dllexport) bool startMetricsServer(unsigned int _port)
+{
+   try {
+      return MetricsManager::startServer((unsigned short)_port);
+   }
+   catch (const std::exception& e)
+   {
+      Logger::Log(e.what (), constants::LogError);
+   }
+   return false;
+}
+
+__declspec(dllexport) void stopMetricsServer()
+{
+   try {
+      MetricsManager::stopServer();
+   }
+   catch (const std::exception& e)
+   {
+      Logger::Log(e.what (), constants::LogError);
+   }
+}
+
 __declspec(dllexport) void waitBeforeClosing()
 {
    try {
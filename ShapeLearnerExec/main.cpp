@@ -23,8 +23,17 @@ int main()
 	}
 	JobManager::initJobManager();
 	cout << "Image signing Go !" << endl;
-	signBinaryImage("img.ppm", "production", 2);
-	ShapeLearner::waitForComputation ();
+
+	vector<JobHandle> jobs;
+	jobs.push_back(ShapeLearner::submitShockGraph(img2Parse("img.ppm", "production", 2)));
+
+	while (!jobs.empty()){
+		size_t done = ShapeLearner::waitAny(jobs);
+		JobResult rslt = jobs[done].get();
+		cout << "Job " << rslt.jobID << " (" << rslt.filepath << ") " << (rslt.success ? "signed as graph " : "failed ") << rslt.graphID
+			<< " in " << rslt.totalTime << "s (queue: " << rslt.queueTime << "s, generation: " << rslt.generationTime << "s, saving: " << rslt.savingTime << "s)" << endl;
+		jobs.erase(jobs.begin() + done);
+	}
 	return 0;
 }
 
@@ -33,6 +33,9 @@
 	#include "shockGraphsGenerator.h"
 	#include "shockGraphsReader.h"
 	#include "jobManager.h"
+	#include "metricsManager.h"
+	#include "ingestionDriver.h"
+	#include "signatureCache.h"
 #endif //_MSC_VER
 
 #endif //_ALL_HEADERS_SHAPE_LEARNER_
\ No newline at end of file
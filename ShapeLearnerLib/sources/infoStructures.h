@@ -46,6 +46,15 @@ struct ShapeRepresentationParams
 	const char* outDir;
 };
 
+/*!
+*	Shock graph parameter values to sweep over. Every combination of the listed values is computed.
+*	An empty list keeps the default value of that parameter (see shockGraphsGenerator::parametersInit).
+*/
+struct ShockGraphSweep
+{
+	std::vector<double> minSlopes, minErrors, maxAccelChgs;
+};
+
 struct TrainingParams
 {
 	int queryID;
@@ -0,0 +1,275 @@
+/* ************* Begin file ingestionDriver.cpp ***************************************/
+/*
+** 2015 September 21
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file ingestionDriver.cpp
+*	\brief ingestionDriver source file.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+#include "allHeaders.h"
+
+using namespace std;
+
+ImageEntry::ImageEntry(): jobID(0) {}
+
+/* *******************************************************************
+*                          Directory Source                          *
+ ********************************************************************/
+
+DirectorySource::DirListing::DirListing(): nextEntry(0) {}
+
+DirectorySource::DirectorySource(const string& _rootDir) throw(StandardExcept){
+   dirStack.push(DirListing());
+   if (!listDir(_rootDir, dirStack.top()))
+      throw StandardExcept((string)__FUNCTION__, "Unable to open the directory: " + _rootDir);
+}
+
+bool DirectorySource::isImageFile(const char* szFileName){
+   const char* szFileExt = DirWalker::FindFileExtension(szFileName);
+
+   return !_stricmp(szFileExt, "ppm") || !_stricmp(szFileExt, "pgm") ||
+      !_stricmp(szFileExt, "bmp") || !_stricmp(szFileExt, "tif") ||
+      !_stricmp(szFileExt, "jpg") || !_stricmp(szFileExt, "png");
+}
+
+bool DirectorySource::listDir(const string& dirPath, DirListing& listing){
+   DirWalker walker;
+   char szFileName[MAX_PATH_SIZE];
+
+   if (!walker.OpenDir(dirPath.c_str()))
+      return false;
+
+   while (walker.GetNextFileOrDir(szFileName, MAX_PATH_SIZE)){
+      if (strcmp(szFileName, ".") && strcmp(szFileName, ".."))
+         listing.entries.push_back(szFileName);
+   }
+   // The file system returns the entries in no particular order.
+   sort(listing.entries.begin(), listing.entries.end());
+   listing.nextEntry = 0;
+   return true;
+}
+
+bool DirectorySource::next(ImageEntry& entry){
+   while (!dirStack.empty()){
+      DirListing& dir = dirStack.top();
+      if (dir.nextEntry == dir.entries.size()){
+         dirStack.pop(); // Directory exhausted, back to its parent.
+         continue;
+      }
+
+      const string filePath = dir.entries[dir.nextEntry++];
+
+      if (DirWalker::IsDirectory(filePath.c_str())){
+         dirStack.push(DirListing());
+         if (!listDir(filePath, dirStack.top())){
+            dirStack.pop();
+            Logger::Log((string)__FUNCTION__ + " // Unable to open the directory: " + filePath, constants::LogError);
+         }
+      }
+      else if (isImageFile(filePath.c_str())){
+         entry.filepath = filePath;
+         entry.objClass.clear();
+         entry.jobID = 0;
+         return true;
+      }
+   }
+   return false;
+}
+
+/* *******************************************************************
+*                           Manifest Source                          *
+ ********************************************************************/
+
+ManifestSource::ManifestSource(const string& _manifestPath) throw(StandardExcept) : manifest(_manifestPath.c_str()), lineNumber(0){
+   if (!manifest.is_open())
+      throw StandardExcept((string)__FUNCTION__, "Unable to open the manifest: " + _manifestPath);
+}
+
+bool ManifestSource::next(ImageEntry& entry){
+   string line;
+
+   while (getline(manifest, line)){
+      lineNumber++;
+      if (!line.empty() && line[line.size() - 1] == '\r')
+         line.erase(line.size() - 1);
+      if (line.empty() || line[0] == '#')
+         continue;
+
+      std::istringstream fields(line);
+      string jobID;
+
+      getline(fields, entry.filepath, ';');
+      entry.objClass.clear();
+      getline(fields, entry.objClass, ';');
+      getline(fields, jobID, ';');
+
+      // A bad_lexical_cast must not escape run(). lexical_cast also wraps negative numbers around.
+      bool bValidID = jobID.empty() || jobID[0] != '-';
+      entry.jobID = 0;
+      try{
+         if (bValidID && !jobID.empty())
+            entry.jobID = boost::lexical_cast<unsigned int>(jobID);
+      }
+      catch(const boost::bad_lexical_cast&){
+         bValidID = false;
+      }
+      if (!bValidID){
+         Logger::Log((string)__FUNCTION__ + " // Invalid job ID \"" + jobID + "\" at line " + to_string((_ULonglong)lineNumber) + " of the manifest, line skipped: " + line, constants::LogError);
+         continue;
+      }
+      return true;
+   }
+   return false;
+}
+
+/* *******************************************************************
+*                          Ingestion Driver                          *
+ ********************************************************************/
+
+IngestionDriver::IngestionDriver(ImageSource& _source, const string& _objClass, const unsigned int _baseJobID,
+                                 const unsigned int _maxInFlight, const string& _checkpointPath, const unsigned int _checkpointEvery) :
+   source(_source),
+   objClass(_objClass),
+   baseJobID(_baseJobID),
+   maxInFlight(_maxInFlight > 0 ? _maxInFlight : 1),
+   checkpointPath(_checkpointPath),
+   checkpointEvery(_checkpointEvery > 0 ? _checkpointEvery : 1),
+   succeeded(0),
+   failed(0),
+   watermark(0)
+{}
+
+unsigned long IngestionDriver::getSucceeded() const{
+   return succeeded;
+}
+
+unsigned long IngestionDriver::getFailed() const{
+   return failed;
+}
+
+unsigned long IngestionDriver::run() throw(StandardExcept){
+   const unsigned long long skip = readCheckpoint();
+   watermark = skip;
+   finishedAhead.clear();
+
+   if (skip > 0)
+      Logger::Log("Resuming ingestion after " + to_string((_ULonglong)skip) + " images (" + checkpointPath + ").", constants::LogCore);
+
+   vector<JobHandle> inFlight;
+   vector<unsigned long long> positions; // Source position of each handle in inFlight.
+   inFlight.reserve(maxInFlight);
+   positions.reserve(maxInFlight);
+
+   unsigned long long position = 0;
+   unsigned long submitted = 0, harvested = 0;
+   bool bExhausted = false;
+   ImageEntry entry;
+
+   for (;;){
+      // Refill the window.
+      while (!bExhausted && inFlight.size() < maxInFlight){
+         if (!source.next(entry)){
+            bExhausted = true;
+            break;
+         }
+         if (position < skip){
+            position++;
+            continue;
+         }
+
+         img2Parse img(entry.filepath,
+                       entry.objClass.empty() ? objClass : entry.objClass,
+                       entry.jobID != 0 ? entry.jobID : baseJobID + (unsigned int)position);
+         inFlight.push_back(ShapeLearner::submitShockGraph(img));
+         positions.push_back(position);
+         position++;
+         submitted++;
+      }
+
+      if (inFlight.empty())
+         break;
+
+      // Harvest one finished job and free its slot.
+      size_t done = ShapeLearner::waitAny(inFlight);
+      JobResult rslt = inFlight[done].get();
+      if (rslt.success)
+         succeeded++;
+      else{
+         failed++;
+         Logger::Log((string)__FUNCTION__ + " // Job failed for: " + rslt.filepath, constants::LogError);
+      }
+      markFinished(positions[done]);
+
+      inFlight[done] = inFlight.back();
+      inFlight.pop_back();
+      positions[done] = positions.back();
+      positions.pop_back();
+
+      if (++harvested % checkpointEvery == 0)
+         writeCheckpoint();
+   }
+
+   writeCheckpoint();
+   Logger::Log("Ingestion done: " + to_string((_ULonglong)submitted) + " images submitted, " + to_string((_ULonglong)failed) + " failed.", constants::LogCore);
+   return submitted;
+}
+
+void IngestionDriver::markFinished(unsigned long long position){
+   if (position != watermark){
+      finishedAhead.insert(position);
+      return;
+   }
+
+   watermark++;
+   set<unsigned long long>::iterator it = finishedAhead.begin();
+   while (it != finishedAhead.end() && *it == watermark){
+      watermark++;
+      finishedAhead.erase(it++);
+   }
+}
+
+unsigned long long IngestionDriver::readCheckpoint() const{
+   if (checkpointPath.empty())
+      return 0;
+
+   ifstream in(checkpointPath.c_str());
+   unsigned long long rslt = 0;
+   if (in.is_open() && !(in >> rslt))
+      throw StandardExcept((string)__FUNCTION__, "Corrupted checkpoint file: " + checkpointPath);
+   return rslt;
+}
+
+void IngestionDriver::writeCheckpoint() const{
+   if (checkpointPath.empty())
+      return;
+
+   // Written aside then renamed so a crash never leaves a truncated checkpoint.
+   string tmpPath = checkpointPath + ".tmp";
+   {
+      ofstream out(tmpPath.c_str(), ios::trunc);
+      out << watermark << endl;
+      if (!out.good()){
+         Logger::Log((string)__FUNCTION__ + " // Unable to write the checkpoint: " + tmpPath, constants::LogError);
+         return;
+      }
+   }
+
+   try{
+      boost::filesystem::rename(tmpPath, checkpointPath);
+   }
+   catch(const std::exception& e){
+      Logger::Log((string)__FUNCTION__ + " // " + (string)e.what(), constants::LogError);
+   }
+}
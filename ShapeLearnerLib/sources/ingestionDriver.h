@@ -0,0 +1,158 @@
+/* ************* Begin file ingestionDriver.h ***************************************/
+/*
+** 2015 September 21
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file ingestionDriver.h
+*	\brief ingestionDriver Header. Streams images from a directory tree or a manifest file into ShapeLearner with a bounded number of jobs in flight.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _INGESTION_DRIVER_
+#define _INGESTION_DRIVER_
+
+#ifdef _MSC_VER
+	#pragma message("Compiling ShapeLearnerLib::ingestionDriver.h  - this should happen just once per project.\n")
+#endif
+
+#include "stdafx.h"
+#include "allHeaders.h"
+
+using namespace std;
+
+class ShapeLearner; // Forward Declaration of the class contained in ShapeLearner.h
+class StandardExcept; //Forward Declaration of the class contained in StandardException.h
+
+/*!
+*	\struct ImageEntry
+*	\brief One image read from an ImageSource. Empty objClass or a jobID of 0 mean "use the driver's default".
+*/
+struct ImageEntry{
+	string filepath;
+	string objClass;
+	unsigned int jobID;
+	ImageEntry();
+};
+
+/*!
+*	\class ImageSource
+*	\brief Lazy sequence of images. Implementations must always enumerate the images in the same order, the checkpoint relies on it.
+*/
+class ImageSource : boost::noncopyable {
+public:
+	virtual ~ImageSource() {}
+
+	/*!
+	*	\fn virtual bool next(ImageEntry& entry) = 0;
+	*	\brief Reads the next image. Returns false once the source is exhausted.
+	*/
+	virtual bool next(ImageEntry& entry) = 0;
+};
+
+/*!
+*	\class DirectorySource
+*	\brief Depth-first walk of a directory tree (DirWalker based), returning the image files only (extensions compared case-insensitively).
+*	Each directory is listed and sorted when entered, so the order doesn't depend on the file system. Only the listings
+*	of the directories being walked are kept.
+*/
+class DirectorySource : public ImageSource {
+public:
+	DirectorySource(const string& _rootDir) throw(StandardExcept);
+	virtual bool next(ImageEntry& entry);
+
+	static bool isImageFile(const char* szFileName);
+
+private:
+	struct DirListing{
+		vector<string> entries; // Sorted paths, without "." and "..".
+		size_t nextEntry;
+		DirListing();
+	};
+
+	stack<DirListing> dirStack;
+
+	static bool listDir(const string& dirPath, DirListing& listing);
+};
+
+/*!
+*	\class ManifestSource
+*	\brief Reads a text manifest line by line : "filepath[;objClass[;jobID]]". Empty lines and lines starting with '#' are skipped.
+*	Lines whose jobID isn't an unsigned integer are logged and skipped.
+*/
+class ManifestSource : public ImageSource {
+public:
+	ManifestSource(const string& _manifestPath) throw(StandardExcept);
+	virtual bool next(ImageEntry& entry);
+
+private:
+	ifstream manifest;
+	unsigned long lineNumber; // Of the last line read, for the error messages.
+};
+
+/*!
+*	\class IngestionDriver
+*	\brief Feeds an ImageSource to ShapeLearner while keeping at most maxInFlight jobs submitted and not harvested.
+*
+*	Progress is saved in a checkpoint file as the number of leading entries of the source that are finished.
+*	On restart, these entries are skipped. Entries finished out of order after that watermark are re-submitted,
+*	so at most maxInFlight images are processed twice after a crash.
+*/
+class IngestionDriver : boost::noncopyable {
+public:
+
+	/*!
+	*	\param _source : The images to process.
+	*	\param _objClass : Object class used when the source doesn't provide one.
+	*	\param _baseJobID : Job ID used when the source doesn't provide one. Entries get _baseJobID + their position in the source.
+	*	\param _maxInFlight : Maximum number of jobs submitted and not finished.
+	*	\param _checkpointPath : File storing the progress. Empty => no checkpoint.
+	*	\param _checkpointEvery : The checkpoint is rewritten every N finished jobs (and at the end).
+	*/
+	IngestionDriver(ImageSource& _source, const string& _objClass, const unsigned int _baseJobID,
+						const unsigned int _maxInFlight = 2 * constants::nbMaxThread, const string& _checkpointPath = "",
+						const unsigned int _checkpointEvery = 100);
+
+	/*!
+	*	\fn unsigned long run() throw(StandardExcept);
+	*	\brief Processes the whole source, resuming from the checkpoint if any. Returns the number of jobs run by this call.
+	*/
+	unsigned long run() throw(StandardExcept);
+
+	unsigned long getSucceeded() const;
+	unsigned long getFailed() const;
+
+private:
+	ImageSource& source;
+	const string objClass;
+	const unsigned int baseJobID;
+	const unsigned int maxInFlight;
+	const string checkpointPath;
+	const unsigned int checkpointEvery;
+
+	unsigned long succeeded, failed;
+
+	/*!
+	*	Number of leading source entries known to be finished (the checkpoint value).
+	*/
+	unsigned long long watermark;
+
+	/*!
+	*	Source positions finished above the watermark, waiting for the gap to be filled.
+	*/
+	set<unsigned long long> finishedAhead;
+
+	unsigned long long readCheckpoint() const;
+	void writeCheckpoint() const;
+	void markFinished(unsigned long long position);
+};
+
+#endif // _INGESTION_DRIVER_
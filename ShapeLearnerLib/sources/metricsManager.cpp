@@ -0,0 +1,337 @@
+/* ************* Begin file metricsManager.cpp ***************************************/
+/*
+** 2015 September 14
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file metricsManager.cpp
+*	\brief metricsManager source file.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+#include "allHeaders.h"
+
+using namespace std;
+using boost::asio::ip::tcp;
+
+MetricStage::MetricStage(MetricStage_e _stage): stage(_stage){}
+std::string MetricStage::getStage(){
+   switch (stage)
+    {
+      case StageQueue:		return "queue";
+      case StageGeneration:	return "generation";
+      case StageSaving:		return "saving";
+      case StageTotal:		return "total";
+      default:				return "";
+    }
+}
+
+/* *******************************************************************
+*                            Recording                               *
+ ********************************************************************/
+
+MetricsManager::StageTimer::StageTimer(MetricStage_e _stage, double* _elapsed):
+   stage(_stage),
+   elapsed(_elapsed),
+   start(boost::posix_time::microsec_clock::universal_time())
+{}
+
+MetricsManager::StageTimer::~StageTimer(){
+   double seconds = (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds() / 1e6;
+   if (elapsed != NULL)
+      *elapsed = seconds;
+   MetricsManager::recordLatency(stage, seconds);
+}
+
+MetricsManager::LatencySummary::LatencySummary(): next(0), count(0), sum(0) {
+   samples.reserve(LatencyWindow);
+}
+
+MetricsManager::CacheCounter::CacheCounter(): hits(0), misses(0) {}
+
+void MetricsManager::jobQueued(){
+   boost::mutex::scoped_lock lock(mutexMetrics);
+   jobsQueued++;
+}
+
+void MetricsManager::jobFinished(bool success){
+   boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+   boost::mutex::scoped_lock lock(mutexMetrics);
+
+   if (success)
+      jobsSucceeded++;
+   else
+      jobsFailed++;
+
+   recentCompletions.push_back(now);
+   while (!recentCompletions.empty() && (now - recentCompletions.front()).total_seconds() > ThroughputWindow)
+      recentCompletions.pop_front();
+}
+
+void MetricsManager::recordLatency(MetricStage_e stage, double seconds){
+   if (stage < 0 || stage >= NbMetricStages)
+      return;
+
+   boost::mutex::scoped_lock lock(mutexMetrics);
+   LatencySummary& summary = latencies[stage];
+
+   // Fixed size ring buffer : the quantiles describe the last LatencyWindow jobs.
+   if (summary.samples.size() < LatencyWindow)
+      summary.samples.push_back(seconds);
+   else
+      summary.samples[summary.next] = seconds;
+   summary.next = (summary.next + 1) % LatencyWindow;
+
+   summary.count++;
+   summary.sum += seconds;
+}
+
+void MetricsManager::cacheAccess(const std::string& cacheName, bool hit){
+   boost::mutex::scoped_lock lock(mutexMetrics);
+   CacheCounter& counter = caches[cacheName];
+   if (hit)
+      counter.hits++;
+   else
+      counter.misses++;
+}
+
+/* *******************************************************************
+*                        Prometheus Rendering                        *
+ ********************************************************************/
+
+double MetricsManager::quantile(vector<double>& sorted, double q){
+   if (sorted.empty())
+      return 0;
+   size_t idx = (size_t)(q * (sorted.size() - 1) + 0.5);
+   return sorted[idx];
+}
+
+std::string MetricsManager::render(){
+   std::ostringstream out;
+   out.precision(9);
+
+   // Gathered outside of mutexMetrics : both come from their own subsystems.
+   size_t pending = ShapeLearner::getPendingJobs();
+   size_t active = ShapeLearner::getActiveThread();
+   unsigned long dbConnections = 0;
+   try{
+      dbConnections = graphDBLib::GraphDB::getOpenConnectionCount();
+   }
+   catch(const std::exception& e){
+      Logger::Log((string)__FUNCTION__ + " // " + (string)e.what(), constants::LogError);
+   }
+
+   out << "# HELP shapelearner_queue_depth Jobs scheduled in the pool and not started yet.\n";
+   out << "# TYPE shapelearner_queue_depth gauge\n";
+   out << "shapelearner_queue_depth " << pending << "\n";
+
+   out << "# HELP shapelearner_active_threads Pool threads currently processing a job.\n";
+   out << "# TYPE shapelearner_active_threads gauge\n";
+   out << "shapelearner_active_threads " << active << "\n";
+
+   out << "# HELP shapelearner_pool_threads Size of the worker pool.\n";
+   out << "# TYPE shapelearner_pool_threads gauge\n";
+   out << "shapelearner_pool_threads " << constants::nbMaxThread << "\n";
+
+   out << "# HELP shapelearner_db_connections Per-thread connections opened in the DB pool.\n";
+   out << "# TYPE shapelearner_db_connections gauge\n";
+   out << "shapelearner_db_connections " << dbConnections << "\n";
+
+   out << "# HELP shapelearner_db_pool_utilization Ratio of opened DB connections over the pool size.\n";
+   out << "# TYPE shapelearner_db_pool_utilization gauge\n";
+   out << "shapelearner_db_pool_utilization " << (double)dbConnections / constants::nbMaxThread << "\n";
+
+   boost::mutex::scoped_lock lock(mutexMetrics);
+
+   out << "# HELP shapelearner_jobs_queued_total Jobs submitted to the pool.\n";
+   out << "# TYPE shapelearner_jobs_queued_total counter\n";
+   out << "shapelearner_jobs_queued_total " << jobsQueued << "\n";
+
+   out << "# HELP shapelearner_jobs_finished_total Jobs finished, by outcome.\n";
+   out << "# TYPE shapelearner_jobs_finished_total counter\n";
+   out << "shapelearner_jobs_finished_total{status=\"success\"} " << jobsSucceeded << "\n";
+   out << "shapelearner_jobs_finished_total{status=\"error\"} " << jobsFailed << "\n";
+
+   boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+   while (!recentCompletions.empty() && (now - recentCompletions.front()).total_seconds() > ThroughputWindow)
+      recentCompletions.pop_front();
+
+   out << "# HELP shapelearner_jobs_per_second Jobs finished per second over the last " << ThroughputWindow << " seconds.\n";
+   out << "# TYPE shapelearner_jobs_per_second gauge\n";
+   out << "shapelearner_jobs_per_second " << (double)recentCompletions.size() / ThroughputWindow << "\n";
+
+   out << "# HELP shapelearner_stage_latency_seconds Per-stage latency, quantiles over the last " << LatencyWindow << " samples.\n";
+   out << "# TYPE shapelearner_stage_latency_seconds summary\n";
+   const double quantiles[] = {0.5, 0.9, 0.99};
+   for (int stage = 0; stage < NbMetricStages; stage++){
+      string name = MetricStage((MetricStage_e)stage).getStage();
+      vector<double> sorted(latencies[stage].samples);
+      std::sort(sorted.begin(), sorted.end());
+
+      for (int i = 0; i < 3; i++)
+         out << "shapelearner_stage_latency_seconds{stage=\"" << name << "\",quantile=\"" << quantiles[i] << "\"} " << quantile(sorted, quantiles[i]) << "\n";
+      out << "shapelearner_stage_latency_seconds_sum{stage=\"" << name << "\"} " << latencies[stage].sum << "\n";
+      out << "shapelearner_stage_latency_seconds_count{stage=\"" << name << "\"} " << latencies[stage].count << "\n";
+   }
+
+   out << "# HELP shapelearner_cache_requests_total Cache lookups, by cache and result.\n";
+   out << "# TYPE shapelearner_cache_requests_total counter\n";
+   for (map<std::string, CacheCounter>::const_iterator it = caches.begin(); it != caches.end(); it++){
+      out << "shapelearner_cache_requests_total{cache=\"" << it->first << "\",result=\"hit\"} " << it->second.hits << "\n";
+      out << "shapelearner_cache_requests_total{cache=\"" << it->first << "\",result=\"miss\"} " << it->second.misses << "\n";
+   }
+
+   out << "# HELP shapelearner_cache_hit_ratio Ratio of cache lookups that were hits.\n";
+   out << "# TYPE shapelearner_cache_hit_ratio gauge\n";
+   for (map<std::string, CacheCounter>::const_iterator it = caches.begin(); it != caches.end(); it++){
+      unsigned long long total = it->second.hits + it->second.misses;
+      out << "shapelearner_cache_hit_ratio{cache=\"" << it->first << "\"} " << (total == 0 ? 0 : (double)it->second.hits / total) << "\n";
+   }
+
+   return out.str();
+}
+
+/* *******************************************************************
+*                          HTTP Endpoint                             *
+ ********************************************************************/
+
+bool MetricsManager::startServer(unsigned short port){
+   boost::mutex::scoped_lock lock(mutexMetrics);
+   if (serverThread != NULL)
+      return false;
+
+   try{
+      tcp::acceptor* acceptor = new tcp::acceptor(ioService, tcp::endpoint(tcp::v4(), port));
+      serverPort = port;
+      serverRunning = true;
+      serverThread = new boost::thread(boost::bind(&MetricsManager::serverLoop, acceptor));
+   }
+   catch(const std::exception& e){
+      Logger::Log((string)__FUNCTION__ + " // Unable to open the metrics endpoint on port " + to_string((_ULonglong)port) + ": " + (string)e.what(), constants::LogError);
+      return false;
+   }
+
+   Logger::Log("Metrics endpoint listening on port " + to_string((_ULonglong)port), constants::LogCore);
+   return true;
+}
+
+void MetricsManager::stopServer(){
+   boost::thread* thread;
+   {
+      boost::mutex::scoped_lock lock(mutexMetrics);
+      if (serverThread == NULL)
+         return;
+      thread = serverThread;
+      serverThread = NULL;
+      serverRunning = false;
+   }
+
+   // Wake the blocking accept() up with a dummy connection so the loop sees the flag.
+   try{
+      tcp::socket wakeUp(ioService);
+      wakeUp.connect(tcp::endpoint(boost::asio::ip::address_v4::loopback(), serverPort));
+   }
+   catch(const std::exception&){}
+
+   thread->join();
+   delete thread;
+
+   // run() returned at least once, a later startServer() must find the io_service ready.
+   ioService.reset();
+}
+
+void MetricsManager::serverLoop(tcp::acceptor* acceptor){
+   while (serverRunning){
+      try{
+         tcp::socket socket(ioService);
+         acceptor->accept(socket);
+         if (!serverRunning)
+            break;
+         handleConnection(socket);
+      }
+      catch(const std::exception& e){
+         Logger::Log((string)__FUNCTION__ + " // " + (string)e.what(), constants::LogError);
+      }
+   }
+   delete acceptor;
+}
+
+void MetricsManager::onRequestRead(const boost::system::error_code& error, boost::system::error_code* pReadError, boost::asio::deadline_timer* pDeadline){
+   *pReadError = error;
+   pDeadline->cancel();
+}
+
+void MetricsManager::onReadDeadline(const boost::system::error_code& error, tcp::socket* pSocket){
+   if (error != boost::asio::error::operation_aborted){
+      boost::system::error_code ignored;
+      pSocket->close(ignored); // Aborts the pending read.
+   }
+}
+
+void MetricsManager::handleConnection(tcp::socket& socket){
+   // The read is asynchronous so that a client which never ends its request can't hold the single server thread.
+   boost::asio::streambuf request;
+   boost::system::error_code readError = boost::asio::error::would_block;
+   boost::asio::deadline_timer deadline(ioService, boost::posix_time::seconds(RequestTimeout));
+
+   ioService.reset();
+   boost::asio::async_read_until(socket, request, "\r\n\r\n",
+      boost::bind(&MetricsManager::onRequestRead, boost::asio::placeholders::error, &readError, &deadline));
+   deadline.async_wait(boost::bind(&MetricsManager::onReadDeadline, boost::asio::placeholders::error, &socket));
+   ioService.run();
+
+   if (readError){
+      Logger::Log((string)__FUNCTION__ + " // Request dropped: " + readError.message(), constants::LogError);
+      return;
+   }
+
+   std::istream requestStream(&request);
+   string method, path;
+   requestStream >> method >> path;
+
+   string status, contentType, body;
+   if (method == "GET" && (path == "/metrics" || path.compare(0, 9, "/metrics?") == 0)){
+      status = "200 OK";
+      contentType = "text/plain; version=0.0.4";
+      body = render();
+   }
+   else{
+      status = "404 Not Found";
+      contentType = "text/plain";
+      body = "Only GET /metrics is served.\n";
+   }
+
+   std::ostringstream response;
+   response << "HTTP/1.0 " << status << "\r\n";
+   response << "Content-Type: " << contentType << "\r\n";
+   response << "Content-Length: " << body.size() << "\r\n";
+   response << "Connection: close\r\n\r\n";
+   response << body;
+
+   boost::asio::write(socket, boost::asio::buffer(response.str()));
+   boost::system::error_code ignored;
+   socket.shutdown(tcp::socket::shutdown_both, ignored);
+}
+
+boost::mutex MetricsManager::mutexMetrics;
+
+unsigned long long MetricsManager::jobsQueued = 0;
+unsigned long long MetricsManager::jobsSucceeded = 0;
+unsigned long long MetricsManager::jobsFailed = 0;
+std::deque<boost::posix_time::ptime> MetricsManager::recentCompletions;
+MetricsManager::LatencySummary MetricsManager::latencies[NbMetricStages];
+map<std::string, MetricsManager::CacheCounter> MetricsManager::caches;
+
+boost::asio::io_service MetricsManager::ioService;
+boost::thread* MetricsManager::serverThread = NULL;
+volatile bool MetricsManager::serverRunning = false;
+unsigned short MetricsManager::serverPort = 0;
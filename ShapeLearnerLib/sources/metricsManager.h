@@ -0,0 +1,152 @@
+/* ************* Begin file metricsManager.h ***************************************/
+/*
+** 2015 September 14
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file metricsManager.h
+*	\brief metricsManager Header. Runtime counters of the signing service and the optional embedded HTTP endpoint exporting them in Prometheus text format.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _METRICS_MANAGER_
+#define _METRICS_MANAGER_
+
+#ifdef _MSC_VER
+	#pragma message("Compiling ShapeLearnerLib::metricsManager.h  - this should happen just once per project.\n")
+#endif
+
+#include "stdafx.h"
+#include "allHeaders.h"
+
+using namespace std;
+
+class ShapeLearner; // Forward Declaration of the class contained in ShapeLearner.h
+class StandardExcept; //Forward Declaration of the class contained in StandardException.h
+
+/*!
+*	Processing stages whose latency is tracked. Keep NbMetricStages last.
+*/
+enum MetricStage_e {StageQueue, StageGeneration, StageSaving, StageTotal, NbMetricStages};
+
+struct MetricStage{
+	MetricStage_e stage;
+	std::string getStage();
+	MetricStage(MetricStage_e _stage);
+};
+
+/*!
+*	\class MetricsManager
+*	\brief Static class gathering the service counters (jobs, latencies, caches) and serving them over HTTP.
+*	Every recording method is thread safe and cheap enough to be called from the pool's workers.
+*	The HTTP endpoint is disabled until startServer() is called : "curl http://127.0.0.1:<port>/metrics".
+*/
+class MetricsManager : boost::noncopyable {
+public:
+
+	/*!
+	*	\class MetricsManager::StageTimer
+	*	\brief RAII helper recording the time spent in a scope as the latency of the given stage.
+	*/
+	class StageTimer : boost::noncopyable {
+	public:
+		StageTimer(MetricStage_e _stage, double* _elapsed = NULL);
+		~StageTimer();
+	private:
+		const MetricStage_e stage;
+		double* const elapsed; //!< Optional copy of the measured time for the caller.
+		const boost::posix_time::ptime start;
+	};
+
+	static void jobQueued();
+	static void jobFinished(bool success);
+
+	/*!
+	*	\fn static void recordLatency(MetricStage_e stage, double seconds);
+	*	\brief Adds one latency sample (in seconds) to the given stage.
+	*/
+	static void recordLatency(MetricStage_e stage, double seconds);
+
+	/*!
+	*	\fn static void cacheAccess(const std::string& cacheName, bool hit);
+	*	\brief Counts a lookup in a named cache. The hit rate is exported per cache name.
+	*/
+	static void cacheAccess(const std::string& cacheName, bool hit);
+
+	/*!
+	*	\fn static std::string render();
+	*	\brief Returns every metric in the Prometheus text exposition format (version 0.0.4).
+	*/
+	static std::string render();
+
+	/*!
+	*	\fn static bool startServer(unsigned short port = 9464);
+	*	\brief Starts the embedded HTTP endpoint on a background thread. Returns false if already started or if the port can't be bound.
+	*/
+	static bool startServer(unsigned short port = 9464);
+	static void stopServer();
+
+private:
+
+	/*!
+	*	Number of latency samples kept per stage to estimate the quantiles.
+	*/
+	static const unsigned int LatencyWindow = 1024;
+
+	/*!
+	*	Time window (in seconds) over which the jobs/sec throughput is averaged.
+	*/
+	static const unsigned int ThroughputWindow = 60;
+
+	/*!
+	*	Time (in seconds) a client has to send its HTTP request before the connection is dropped.
+	*/
+	static const unsigned int RequestTimeout = 5;
+
+	struct LatencySummary{
+		vector<double> samples;
+		unsigned int next;
+		unsigned long long count;
+		double sum;
+		LatencySummary();
+	};
+
+	struct CacheCounter{
+		unsigned long long hits;
+		unsigned long long misses;
+		CacheCounter();
+	};
+
+	/*!
+	*	Mutex in order to prevent multiple access to critical sections.
+	*/
+	static boost::mutex mutexMetrics;
+
+	static unsigned long long jobsQueued;
+	static unsigned long long jobsSucceeded;
+	static unsigned long long jobsFailed;
+	static std::deque<boost::posix_time::ptime> recentCompletions;
+	static LatencySummary latencies[NbMetricStages];
+	static map<std::string, CacheCounter> caches;
+
+	static boost::asio::io_service ioService;
+	static boost::thread* serverThread;
+	static volatile bool serverRunning;
+	static unsigned short serverPort;
+
+	static void serverLoop(boost::asio::ip::tcp::acceptor* acceptor);
+	static void handleConnection(boost::asio::ip::tcp::socket& socket);
+	static void onRequestRead(const boost::system::error_code& error, boost::system::error_code* pReadError, boost::asio::deadline_timer* pDeadline);
+	static void onReadDeadline(const boost::system::error_code& error, boost::asio::ip::tcp::socket* pSocket);
+	static double quantile(vector<double>& sorted, double q);
+};
+
+#endif // _METRICS_MANAGER_
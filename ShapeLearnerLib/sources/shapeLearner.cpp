@@ -37,10 +37,8 @@ void ShapeLearner::createShockGraph (const vector<const img2Parse> &imgVect) thr
    std::srand(std::time(0));
 
    // Create fifo thread pool container with two threads.
-   for (vector<const img2Parse>::const_iterator it = imgVect.begin(); it != imgVect.end(); it++){
-      Pool.schedule(boost::bind(&ShapeLearner::createShockGraphWorker, *it));
-      JobManager::Log(it->jobID,Waiting,0,WaitingGen,it->filepath);
-   }
+   for (vector<const img2Parse>::const_iterator it = imgVect.begin(); it != imgVect.end(); it++)
+      scheduleJob(*it, false);
    //  Wait until all tasks are finished
    Pool.wait();
 }
@@ -49,18 +47,20 @@ unsigned int ShapeLearner::getActiveThread () throw(StandardExcept){
    return Pool.active();
 }
 
+unsigned int ShapeLearner::getPendingJobs () throw(StandardExcept){
+   return Pool.pending();
+}
+
 void ShapeLearner::createShockGraph (const img2Parse &img) throw(StandardExcept){
    //Random Init
    std::srand(std::time(0));
-   JobManager::Log(img.jobID,Waiting,0,WaitingGen, img.filepath);
-   Pool.schedule(boost::bind(&ShapeLearner::createShockGraphWorker, img));
+   scheduleJob(img, false);
 }
 
 void ShapeLearner::readShockGraph (const img2Parse &img)  throw(StandardExcept){
    //Random Init
    std::srand(std::time(0));
-   JobManager::Log(img.jobID,Waiting,0,WaitingGen, img.filepath);
-   Pool.schedule(boost::bind(&ShapeLearner::createShockGraphWorker, img));
+   scheduleJob(img, false);
    //ReadFromXMLFile
 }
 
@@ -69,11 +69,95 @@ void ShapeLearner::waitForComputation () throw(StandardExcept){
    Pool.wait();
 }
 
-bool ShapeLearner::createShockGraphWorker (const img2Parse& imgInfo) throw(StandardExcept){
-   shockGraphsGenerator worker(imgInfo.filepath, imgInfo.objClass, imgInfo.jobID);
-   worker.taskExecute();
+/* *******************************************************************
+*                         Batch Submission                           *
+ ********************************************************************/
+
+vector<JobHandle> ShapeLearner::submitShockGraphs (const vector<const img2Parse> &imgVect) throw(StandardExcept){
+   std::srand(std::time(0));
+
+   vector<JobHandle> handles;
+   handles.reserve(imgVect.size());
+   for (vector<const img2Parse>::const_iterator it = imgVect.begin(); it != imgVect.end(); it++)
+      handles.push_back(scheduleJob(*it, true));
+   return handles;
+}
+
+JobHandle ShapeLearner::submitShockGraph (const img2Parse &img) throw(StandardExcept){
+   std::srand(std::time(0));
+   return scheduleJob(img, true);
+}
+
+vector<JobHandle> ShapeLearner::submitParameterSweep (const vector<const img2Parse> &imgVect, const ShockGraphSweep &sweep) throw(StandardExcept){
+   std::srand(std::time(0));
+
+   // Shared read-only by every job of the batch.
+   boost::shared_ptr<const ShockGraphSweep> sharedSweep(new ShockGraphSweep(sweep));
+
+   vector<JobHandle> handles;
+   handles.reserve(imgVect.size());
+   for (vector<const img2Parse>::const_iterator it = imgVect.begin(); it != imgVect.end(); it++)
+      handles.push_back(scheduleJob(*it, true, sharedSweep));
+   return handles;
+}
+
+size_t ShapeLearner::waitAny (vector<JobHandle> &handles) throw(StandardExcept){
+   if (handles.empty())
+      throw StandardExcept((string)__FUNCTION__, "No job handle to wait for.");
+   return boost::wait_for_any(handles.begin(), handles.end()) - handles.begin();
+}
+
+void ShapeLearner::waitAll (vector<JobHandle> &handles) throw(StandardExcept){
+   boost::wait_for_all(handles.begin(), handles.end());
+}
+
+JobHandle ShapeLearner::scheduleJob (const img2Parse& imgInfo, bool bKeepResult, boost::shared_ptr<const ShockGraphSweep> sweep) throw(StandardExcept){
+   boost::shared_ptr<boost::promise<JobResult> > result;
+   JobHandle handle;
+   if (bKeepResult){
+      result.reset(new boost::promise<JobResult>());
+      handle = JobHandle(result->get_future());
+   }
+
+   // Logged before scheduling: a worker starting right away must not have its Ongoing state overwritten by Waiting.
+   JobManager::Log(imgInfo.jobID,Waiting,0,WaitingGen,imgInfo.filepath);
+   MetricsManager::jobQueued();
+   Pool.schedule(boost::bind(&ShapeLearner::createShockGraphWorker, imgInfo, boost::posix_time::microsec_clock::universal_time(), result, sweep));
+   return handle;
+}
+
+void ShapeLearner::createShockGraphWorker (const img2Parse& imgInfo, const boost::posix_time::ptime queuedAt, boost::shared_ptr<boost::promise<JobResult> > result, boost::shared_ptr<const ShockGraphSweep> sweep) throw(StandardExcept){
+   JobResult rslt;
+   rslt.jobID = imgInfo.jobID;
+   rslt.filepath = imgInfo.filepath;
+
+   boost::posix_time::ptime startedAt = boost::posix_time::microsec_clock::universal_time();
+   rslt.queueTime = (startedAt - queuedAt).total_microseconds() / 1e6;
+   MetricsManager::recordLatency(StageQueue, rslt.queueTime);
+
+   try{
+      shockGraphsGenerator worker(imgInfo.filepath, imgInfo.objClass, imgInfo.jobID);
+      if (sweep){
+         rslt.success = worker.sweepExecute(*sweep);
+         rslt.sweepGraphIDs = worker.getSweepGraphKeys();
+      }
+      else
+         rslt.success = worker.taskExecute();
+      rslt.graphID = worker.getGraphKey();
+      rslt.generationTime = worker.getGenerationTime();
+      rslt.savingTime = worker.getSavingTime();
+   }
+   catch(const std::exception& e){
+      Logger::Log((string)__FUNCTION__ + " // " + (string)e.what(), constants::LogError);
+   }
    graphDBLib::GraphDB::closeThreadConnection();
-   return true;
+
+   rslt.totalTime = (boost::posix_time::microsec_clock::universal_time() - queuedAt).total_microseconds() / 1e6;
+   MetricsManager::recordLatency(StageTotal, rslt.totalTime);
+   MetricsManager::jobFinished(rslt.success);
+
+   if (result)
+      result->set_value(rslt);
 }
 
    img2Parse::
@@ -86,3 +170,14 @@ img2Parse( const string _filepath,
 {
 }
 
+JobResult::JobResult()
+   : jobID(0),
+     success(false),
+     graphID(0),
+     queueTime(0),
+     generationTime(0),
+     savingTime(0),
+     totalTime(0)
+{
+}
+
@@ -39,6 +39,25 @@ struct img2Parse{
    img2Parse(const string _filepath, const string _objClass, const unsigned int _jobID);
 };
 
+/*!
+*	\struct JobResult
+*	\brief Outcome of one submitted job, delivered through its JobHandle once the worker is done. Timings are in seconds.
+*/
+struct JobResult{
+   unsigned int jobID;
+   string filepath;
+   bool success;
+   unsigned long graphID; //!< Key of the saved graph in the DB, 0 if nothing was saved.
+   double queueTime;
+   double generationTime;
+   double savingTime;
+   double totalTime;
+   vector<unsigned long> sweepGraphIDs; //!< Parameter sweep jobs only : keys of the saved graphs, in sweep order.
+   JobResult();
+};
+
+typedef boost::shared_future<JobResult> JobHandle;
+
 /*!
 *	\class ShapeLearner
 *	\brief Static class, the central point of the whole architecture. It redistributes actions to the different actors.
@@ -49,18 +68,43 @@ class ShapeLearner
 {
    public:
       static unsigned int getActiveThread () throw(StandardExcept);
+      static unsigned int getPendingJobs () throw(StandardExcept);
       static void createShockGraph (const vector<const img2Parse> &imgVect) throw(StandardExcept);
       static void createShockGraph (const img2Parse &img) throw(StandardExcept);
       static void readShockGraph (const img2Parse &img)  throw(StandardExcept);
       static void waitForComputation () throw(StandardExcept);
 
+      /*!
+      *	\brief Schedules every image of the batch and returns immediately with one handle per image (same order).
+      *	New batches can be submitted while the handles of the previous ones are harvested.
+      */
+      static vector<JobHandle> submitShockGraphs (const vector<const img2Parse> &imgVect) throw(StandardExcept);
+      static JobHandle submitShockGraph (const img2Parse &img) throw(StandardExcept);
+
+      /*!
+      *	\brief Schedules one parameter sweep per image : the skeleton is computed once and one shock graph is saved per combination of the sweep values.
+      *	The handle of each image reports every saved graph in JobResult::sweepGraphIDs.
+      */
+      static vector<JobHandle> submitParameterSweep (const vector<const img2Parse> &imgVect, const ShockGraphSweep &sweep) throw(StandardExcept);
+
+      /*!
+      *	\brief Blocks until at least one of the given handles is ready and returns its index in the vector.
+      */
+      static size_t waitAny (vector<JobHandle> &handles) throw(StandardExcept);
+
+      /*!
+      *	\brief Blocks until every given handle is ready. Other jobs in the pool are not waited for.
+      */
+      static void waitAll (vector<JobHandle> &handles) throw(StandardExcept);
+
    private:
 
       static boost::threadpool::pool	Pool;
 
       /* ************** Multi Threading Workers ***************/
 
-      static bool createShockGraphWorker (const img2Parse& imgInfo) throw(StandardExcept);
+      static JobHandle scheduleJob (const img2Parse& imgInfo, bool bKeepResult, boost::shared_ptr<const ShockGraphSweep> sweep = boost::shared_ptr<const ShockGraphSweep>()) throw(StandardExcept);
+      static void createShockGraphWorker (const img2Parse& imgInfo, const boost::posix_time::ptime queuedAt, boost::shared_ptr<boost::promise<JobResult> > result, boost::shared_ptr<const ShockGraphSweep> sweep) throw(StandardExcept);
 
       /* **************  No instanciation *********************/
 
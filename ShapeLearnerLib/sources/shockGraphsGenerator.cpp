@@ -50,11 +50,27 @@ string genFileName(const unsigned int len = 10)
     return rslt+".ppm";
 }
 
-shockGraphsGenerator::shockGraphsGenerator(const string& _filepath, const string& _objClass, const unsigned int& _jobID) : filepath(_filepath), objClass(_objClass), jobID(_jobID) {
+shockGraphsGenerator::shockGraphsGenerator(const string& _filepath, const string& _objClass, const unsigned int& _jobID) : filepath(_filepath), objClass(_objClass), jobID(_jobID), graphKey(0), generationTime(0), savingTime(0) {
 	parametersInit();
 	Logger::Log("Start file : " + filepath, constants::LogCore);
 }
 
+unsigned long shockGraphsGenerator::getGraphKey() const{
+	return graphKey;
+}
+
+double shockGraphsGenerator::getGenerationTime() const{
+	return generationTime;
+}
+
+double shockGraphsGenerator::getSavingTime() const{
+	return savingTime;
+}
+
+const vector<unsigned long>& shockGraphsGenerator::getSweepGraphKeys() const{
+	return sweepGraphKeys;
+}
+
 void shockGraphsGenerator::parametersInit(){
 	// =========== Parameters for Experiment =================== //
 
@@ -237,24 +253,138 @@ bool shockGraphsGenerator::taskExecute()
 {
 	Logger::Log("Adding object ("+filepath+")to database...", constants::LogCore);
 
-	processFile(m_matchInfo.asyncCompu != 0);
+	bool rslt = processFile(m_matchInfo.asyncCompu != 0);
 
 	Logger::Log("Object ("+filepath+") has been added to database...", constants::LogCore);
 
-	return true;
+	return rslt;
+}
+
+vector<dml::ShockGraphParams> shockGraphsGenerator::expandSweep(const ShockGraphSweep& sweep) const
+{
+	const dml::ShockGraphParams& base = m_shapeInfo.sgparams;
+
+	vector<double> minSlopes(sweep.minSlopes), minErrors(sweep.minErrors), maxAccelChgs(sweep.maxAccelChgs);
+	if (minSlopes.empty()) minSlopes.push_back(base.dMinSlope);
+	if (minErrors.empty()) minErrors.push_back(base.dMinError);
+	if (maxAccelChgs.empty()) maxAccelChgs.push_back(base.dMaxAccelChg);
+
+	vector<dml::ShockGraphParams> variants;
+	variants.reserve(minSlopes.size() * minErrors.size() * maxAccelChgs.size());
+
+	for (vector<double>::const_iterator s = minSlopes.begin(); s != minSlopes.end(); s++)
+		for (vector<double>::const_iterator e = minErrors.begin(); e != minErrors.end(); e++)
+			for (vector<double>::const_iterator a = maxAccelChgs.begin(); a != maxAccelChgs.end(); a++)
+			{
+				dml::ShockGraphParams params = base;
+				params.dMinSlope = *s;
+				params.dMinError = *e;
+				params.dMaxAccelChg = *a;
+				variants.push_back(params);
+			}
+
+	return variants;
+}
+
+void shockGraphsGenerator::deriveVariants(dml::SkeletalGraph* pSkeleton, const dml::ShapeDims& dims, const std::string& strLbl,
+                                          const vector<dml::ShockGraphParams>& variants, vector<boost::shared_ptr<dml::ShockGraph> >& graphs,
+                                          vector<char>& results, unsigned int first, unsigned int stride)
+{
+	for (unsigned int i = first; i < variants.size(); i += stride)
+	{
+		graphs[i].reset(new ShockGraph);
+		try{
+			results[i] = graphs[i]->Create(pSkeleton, dims, strLbl.c_str(), variants[i]);
+		}
+		catch(const std::exception& e){
+			Logger::Log((string)__FUNCTION__ + " // Sweep variant " + to_string((_ULonglong)i) + ": " + (string)e.what(), constants::LogError);
+			results[i] = false;
+		}
+		// The skeleton is owned by the first graph only, and isn't needed to save the derived ones.
+		graphs[i]->ReleaseSkeleton();
+	}
+}
+
+bool shockGraphsGenerator::sweepExecute(const ShockGraphSweep& sweep)
+{
+	sweepGraphKeys.clear();
+
+	const char* szFileExt = DirWalker::FindFileExtension(filepath.c_str());
+	if (!strcmp(szFileExt, "gg"))
+	{
+		Logger::Log((string)__FUNCTION__ + " // Only image files can be swept: " + filepath, constants::LogError);
+		JobManager::Log(jobID,Error,0,ErrorGen, filepath);
+		return false;
+	}
+
+	vector<dml::ShockGraphParams> variants = expandSweep(sweep);
+	vector<boost::shared_ptr<dml::ShockGraph> > graphs(variants.size());
+	vector<char> results(variants.size(), false);
+
+	Logger::Log("Sweeping " + to_string((_ULonglong)variants.size()) + " shock graph parameter sets on (" + filepath + ")...", constants::LogCore);
+	JobManager::Log(jobID,Ongoing,0,StartGen, filepath);
+	{
+		MetricsManager::StageTimer timer(StageGeneration, &generationTime);
+
+		// The first variant computes the skeleton, the others only read it.
+		ImageInfo imgInfo(filepath.c_str());
+		graphs[0].reset(new ShockGraph);
+		results[0] = graphs[0]->Create(imgInfo, variants[0], m_shapeInfo.skelparams);
+
+		if (results[0] && variants.size() > 1)
+		{
+			dml::SkeletalGraph* pSkeleton = const_cast<dml::SkeletalGraph*>(graphs[0]->GetSkeleton());
+			const std::string strLbl(graphs[0]->GetDAGLbl().c_str());
+
+			unsigned int nThreads = std::max(1u, std::min(boost::thread::hardware_concurrency(), (unsigned int)variants.size() - 1));
+			boost::thread_group threads;
+			for (unsigned int t = 0; t < nThreads; t++)
+				threads.create_thread(boost::bind(&shockGraphsGenerator::deriveVariants, pSkeleton, boost::cref(graphs[0]->GetDims()), strLbl,
+					boost::cref(variants), boost::ref(graphs), boost::ref(results), 1 + t, nThreads));
+			threads.join_all();
+		}
+	}
+
+	// Saved sequentially : the DB connection is per thread.
+	JobManager::Log(jobID,Ongoing,0,StartSaving, filepath);
+	bool bAllSaved = results[0] != 0;
+	for (unsigned int i = 0; i < graphs.size(); i++)
+	{
+		if (!results[i])
+		{
+			bAllSaved = false;
+			continue;
+		}
+
+		if (i > 0)
+			graphs[i]->SetDAGLbl((std::string(graphs[0]->GetDAGLbl().c_str()) + "_sweep" + to_string((_ULonglong)i)).c_str());
+
+		if (saveInDB(*graphs[i], false))
+			sweepGraphKeys.push_back(graphKey);
+		else
+			bAllSaved = false;
+	}
+
+	// One final state for the whole sweep, keyed on its first graph.
+	const unsigned long firstKey = sweepGraphKeys.empty() ? 0 : sweepGraphKeys[0];
+	if (bAllSaved)
+		JobManager::Log(jobID,Finished,firstKey,EndSaving, filepath);
+	else
+		JobManager::Log(jobID,Error,firstKey,results[0] ? ErrorSaving : ErrorGen, filepath);
+
+	Logger::Log("Sweep of (" + filepath + ") done: " + to_string((_ULonglong)sweepGraphKeys.size()) + "/" + to_string((_ULonglong)variants.size()) + " graphs saved.", constants::LogCore);
+	return bAllSaved;
 }
 
-void shockGraphsGenerator::processFile(bool bAsyncProcessing)
+bool shockGraphsGenerator::processFile(bool bAsyncProcessing)
 {
-	DAGPtr pDag;//ne semble jamais libr ?
+	DAGPtr pDag; // Owns the graph. It is released, with its arena, on return
 	bool bIsRead;
 	const char* szFileExt;
 
 	szFileExt = DirWalker::FindFileExtension(filepath.c_str());
 
-	if (!strcmp(szFileExt, "ppm") || !strcmp(szFileExt, "pgm") ||
-		!strcmp(szFileExt, "bmp") || !strcmp(szFileExt, "tif") ||
-		!strcmp(szFileExt, "jpg") || !strcmp(szFileExt, "png"))
+	if (DirectorySource::isImageFile(filepath.c_str()))
 	{
 		ImageInfo imgInfo(filepath.c_str());
 
@@ -268,11 +398,30 @@ void shockGraphsGenerator::processFile(bool bAsyncProcessing)
 		// Choose the appropriate shape representation
 		if (m_shapeInfo.shapeRepType == SGShapeRep) // == 1
 		{
+			// Identical content already signed with the same parameters : reuse its graph.
+			SignatureCache::HashKey contentKey;
+			unsigned long knownGraphKey;
+			bool bCacheable = SignatureCache::isOpen() && SignatureCache::computeKey(filepath, objClass, m_shapeInfo, contentKey);
+
+			if (bCacheable && SignatureCache::lookup(contentKey, knownGraphKey))
+			{
+				graphKey = knownGraphKey;
+				Logger::Log("Identical image already signed as graph " + to_string((_ULonglong)graphKey) + ", skipping (" + filepath + ").", constants::LogCore);
+				JobManager::Log(jobID,Finished,graphKey,EndSaving, filepath);
+				return true;
+			}
+
 			ShockGraph* pSG = new ShockGraph;
 			pDag = pSG;
 			JobManager::Log(jobID,Ongoing,0,StartGen, filepath);
-			bIsRead = pSG->Create(imgInfo, m_shapeInfo.sgparams, m_shapeInfo.skelparams);
-			saveInDB(*pSG);
+			{
+				MetricsManager::StageTimer timer(StageGeneration, &generationTime);
+				bIsRead = pSG->Create(imgInfo, m_shapeInfo.sgparams, m_shapeInfo.skelparams);
+			}
+			bIsRead = saveInDB(*pSG) && bIsRead;
+
+			if (bIsRead && bCacheable)
+				SignatureCache::insert(contentKey, graphKey);
 		}
 		else if (m_shapeInfo.shapeRepType == BGShapeRep) // == 2
 		{
@@ -309,20 +458,22 @@ void shockGraphsGenerator::processFile(bool bAsyncProcessing)
 	else
 		Logger::Log("ERROR: Can't read dag.", constants::LogCore);
 
-
-   // pDag ne semble jamais libr ?
+	return bIsRead;
 }
 
-void shockGraphsGenerator::saveInDB(const dml::ShockGraph& graph){
+bool shockGraphsGenerator::saveInDB(const dml::ShockGraph& graph, bool bLogJobState){
+	MetricsManager::StageTimer timer(StageSaving, &savingTime);
 	try{
-		JobManager::Log(jobID,Ongoing,0,StartSaving, filepath);
+		if (bLogJobState)
+			JobManager::Log(jobID,Ongoing,0,StartSaving, filepath);
 		/* ===================== GRAPH SAVING ====================== */
 
 		boost::weak_ptr<graphDBLib::Graph> graphPtr = graphDBLib::GraphDB::CommonInterface::getGraph( \
 			graphDBLib::GraphDB::CommonInterface::getGraphClass((string)graph.ClassName()), \
 			graphDBLib::GraphDB::CommonInterface::getObjectClass(objClass), \
 			(string) graph.GetDAGLbl());
-		JobManager::Log(jobID,Ongoing,graphPtr.lock()->getKey(),StartSaving, filepath); // Update the job with the PartID.
+		if (bLogJobState)
+			JobManager::Log(jobID,Ongoing,graphPtr.lock()->getKey(),StartSaving, filepath); // Update the job with the PartID.
 
 		graphPtr.lock()->setCumulativeMass(graph.GetCumulativeMass(), true);
 		graphPtr.lock()->setDAGCost(graph.GetDAGCost(), true);
@@ -410,12 +561,16 @@ void shockGraphsGenerator::saveInDB(const dml::ShockGraph& graph){
 
 			EdgePtr.lock()->resynchronize();
 		}
-		JobManager::Log(jobID,Finished,graphPtr.lock()->getKey(),EndSaving, filepath);
+		graphKey = graphPtr.lock()->getKey();
+		if (bLogJobState)
+			JobManager::Log(jobID,Finished,graphKey,EndSaving, filepath);
 
 		//graphDBLib::GraphDB::CommonInterface::delObj(graphPtr, false);
+		return true;
 	}
 	catch(std::exception e){
 		Logger::Log((string)__FUNCTION__ + " // Error while saving: " + (string)e.what(), constants::LogError);
+		return false;
 	}
 }
 
@@ -58,11 +58,26 @@ public:
    shockGraphsGenerator(const string& _filepath, const string& _objClass, const unsigned int& _jobID);
    bool taskExecute();
 
+   /*!
+   *	\brief Parameter sweep : computes the skeleton of the image once, then derives (in parallel) and saves one shock graph per parameter set of the sweep.
+   *	\param sweep : Values to combine. The first combination is computed along with the skeleton.
+   */
+   bool sweepExecute(const ShockGraphSweep& sweep);
+   const vector<unsigned long>& getSweepGraphKeys() const;
+
+   unsigned long getGraphKey() const;
+   double getGenerationTime() const;
+   double getSavingTime() const;
+
 private:
    const string filepath;
    const string objClass;
    const unsigned int jobID;
 
+   unsigned long graphKey; //!< DB key of the saved graph, 0 until saveInDB succeeds.
+   vector<unsigned long> sweepGraphKeys; //!< DB keys of the graphs saved by sweepExecute, in sweep order.
+   double generationTime, savingTime;
+
    ShapeMatchingParams m_matchInfo;
    ShapeRepresentationParams m_shapeInfo;
 
@@ -80,6 +95,15 @@ private:
 
    void parametersInit ();
 
+   vector<dml::ShockGraphParams> expandSweep(const ShockGraphSweep& sweep) const;
+
+   /*!
+   *	\brief Derives the shock graphs [first, nVariants) by steps of 'stride' from a shared, read-only skeleton. Thread body of sweepExecute.
+   */
+   static void deriveVariants(dml::SkeletalGraph* pSkeleton, const dml::ShapeDims& dims, const std::string& strLbl,
+                              const vector<dml::ShockGraphParams>& variants, vector<boost::shared_ptr<dml::ShockGraph> >& graphs,
+                              vector<char>& results, unsigned int first, unsigned int stride);
+
    /*!
    *	\brief Computes a shock graph from the given ppm file.
    *	\param szFileName : PPM file name
@@ -89,10 +113,14 @@ private:
    *	Since the SG computation used to fail, the async processing was necessary to
    *	avoid a batch processing of files getting stuck in a particular file.
    */
-   void processFile(bool bAsyncProcessing);
+   bool processFile(bool bAsyncProcessing);
    bool AddBumpsAndNotches(dml::ImageInfo* pImgInfo);
 
-   void saveInDB(const dml::ShockGraph& graph);
+   /*!
+   *	\brief Saves a shock graph in the DB and sets graphKey.
+   *	\param bLogJobState : Whether the job state is logged. sweepExecute saves several graphs for one job and logs its state once.
+   */
+   bool saveInDB(const dml::ShockGraph& graph, bool bLogJobState = true);
    void saveInDB(const dml::BoneGraph& graph);
    void saveInDB(const dml::GestureGraph& graph);
 
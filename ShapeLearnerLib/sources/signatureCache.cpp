@@ -0,0 +1,168 @@
+/* ************* Begin file signatureCache.cpp ***************************************/
+/*
+** 2015 September 28
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file signatureCache.cpp
+*	\brief signatureCache source file.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#include "stdafx.h"
+#include "allHeaders.h"
+
+using namespace std;
+
+/* *******************************************************************
+*                            Index File                              *
+ ********************************************************************/
+
+void SignatureCache::open(const string& indexPath) throw(StandardExcept){
+   boost::mutex::scoped_lock lock(mutexCache);
+   if (bOpen)
+      throw StandardExcept((string)__FUNCTION__, "Signature cache already opened");
+
+   index.clear();
+   {
+      ifstream in(indexPath.c_str());
+      HashKey key;
+      unsigned long graphKey;
+      while (in >> hex >> key >> dec >> graphKey)
+         index[key] = graphKey;
+   }
+
+   indexFile.open(indexPath.c_str(), ios::app);
+   if (!indexFile.is_open())
+      throw StandardExcept((string)__FUNCTION__, "Unable to open the signature index: " + indexPath);
+
+   bOpen = true;
+   Logger::Log("Signature cache opened with " + to_string((_ULonglong)index.size()) + " entries (" + indexPath + ").", constants::LogCore);
+}
+
+void SignatureCache::close(){
+   boost::mutex::scoped_lock lock(mutexCache);
+   if (!bOpen)
+      return;
+   indexFile.close();
+   index.clear();
+   bOpen = false;
+}
+
+bool SignatureCache::isOpen(){
+   boost::mutex::scoped_lock lock(mutexCache);
+   return bOpen;
+}
+
+/* *******************************************************************
+*                              Hashing                               *
+ ********************************************************************/
+
+// 64 bits FNV-1a : fast, no dependency, and good enough to tell images apart.
+SignatureCache::HashKey SignatureCache::hashBytes(const void* data, size_t size, HashKey seed){
+   const unsigned char* bytes = static_cast<const unsigned char*>(data);
+   HashKey h = seed;
+   for (size_t i = 0; i < size; i++){
+      h ^= bytes[i];
+      h *= 1099511628211ULL;
+   }
+   return h;
+}
+
+bool SignatureCache::computeKey(const string& filepath, const string& objClass, const ShapeRepresentationParams& params, HashKey& key){
+   cimg_library::CImg<unsigned char> image;
+   try{
+      image.load(filepath.c_str());
+   }
+   catch(...){ // CImgException doesn't derive from std::exception
+      return false;
+   }
+   if (image.dimx() == 0 || image.dimy() == 0)
+      return false;
+
+   const int width = image.dimx(), height = image.dimy();
+   HashKey h = 14695981039346656037ULL;
+   h = hashBytes(&width, sizeof(width), h);
+   h = hashBytes(&height, sizeof(height), h);
+
+   // Pack the binary image 8 pixels per byte, row by row.
+   vector<unsigned char> row((width + 7) / 8);
+   for (int y = 0; y < height; y++){
+      std::fill(row.begin(), row.end(), 0);
+      for (int x = 0; x < width; x++)
+         if (image(x, y) != 0)
+            row[x >> 3] |= (unsigned char)(1 << (x & 7));
+      h = hashBytes(&row[0], row.size(), h);
+   }
+
+   // Both parameter structs are memset in their constructors : padding bytes are zero.
+   // Only shock graphs go through the cache, so the bone graph parameters are left out.
+   h = hashBytes(&params.shapeRepType, sizeof(params.shapeRepType), h);
+   h = hashBytes(&params.sgparams, sizeof(params.sgparams), h);
+   h = hashBytes(&params.skelparams, sizeof(params.skelparams), h);
+   h = hashBytes(objClass.data(), objClass.size(), h);
+
+   key = h;
+   return true;
+}
+
+/* *******************************************************************
+*                              Lookups                               *
+ ********************************************************************/
+
+bool SignatureCache::lookup(HashKey key, unsigned long& graphKey){
+   bool bHit;
+   {
+      boost::mutex::scoped_lock lock(mutexCache);
+      if (!bOpen)
+         return false;
+
+      std::unordered_map<HashKey, unsigned long>::const_iterator it = index.find(key);
+      bHit = (it != index.end());
+      if (bHit){
+         graphKey = it->second;
+         hits++;
+      }
+      else
+         misses++;
+   }
+   MetricsManager::cacheAccess("signature", bHit);
+   return bHit;
+}
+
+void SignatureCache::insert(HashKey key, unsigned long graphKey){
+   boost::mutex::scoped_lock lock(mutexCache);
+   if (!bOpen || graphKey == 0)
+      return;
+
+   if (index.insert(std::make_pair(key, graphKey)).second){
+      indexFile << hex << key << dec << " " << graphKey << "\n";
+      indexFile.flush();
+   }
+}
+
+unsigned long long SignatureCache::getHits(){
+   boost::mutex::scoped_lock lock(mutexCache);
+   return hits;
+}
+
+unsigned long long SignatureCache::getMisses(){
+   boost::mutex::scoped_lock lock(mutexCache);
+   return misses;
+}
+
+boost::mutex SignatureCache::mutexCache;
+
+bool SignatureCache::bOpen = false;
+std::unordered_map<SignatureCache::HashKey, unsigned long> SignatureCache::index;
+ofstream SignatureCache::indexFile;
+unsigned long long SignatureCache::hits = 0;
+unsigned long long SignatureCache::misses = 0;
@@ -0,0 +1,85 @@
+/* ************* Begin file signatureCache.h ***************************************/
+/*
+** 2015 September 28
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file signatureCache.h
+*	\brief signatureCache Header. Content-hash index of the images already signed, used to skip the computation of duplicated images.
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _SIGNATURE_CACHE_
+#define _SIGNATURE_CACHE_
+
+#ifdef _MSC_VER
+	#pragma message("Compiling ShapeLearnerLib::signatureCache.h  - this should happen just once per project.\n")
+#endif
+
+#include "stdafx.h"
+#include "allHeaders.h"
+
+using namespace std;
+
+class StandardExcept; //Forward Declaration of the class contained in StandardException.h
+
+/*!
+*	\class SignatureCache
+*	\brief Static class mapping a content hash (binary image + shape representation parameters + object class) to the DB key of its graph.
+*
+*	The cache is disabled until open() is called. The index is an append-only text file ("hash graphKey" per line)
+*	loaded in memory when opened, so it survives restarts and can be shared by successive runs.
+*	Graphs deleted from the DB must be purged from the index file by hand.
+*/
+class SignatureCache : boost::noncopyable {
+public:
+	typedef unsigned long long HashKey;
+
+	/*!
+	*	\fn static void open(const string& indexPath) throw(StandardExcept);
+	*	\brief Loads the index file (created if missing) and enables the cache.
+	*/
+	static void open(const string& indexPath) throw(StandardExcept);
+	static void close();
+	static bool isOpen();
+
+	/*!
+	*	\fn static bool computeKey(const string& filepath, const string& objClass, const ShapeRepresentationParams& params, HashKey& key);
+	*	\brief Hashes the decoded binary image (pixels != 0, as the skeletonization reads it) with the parameters it is signed with.
+	*	Returns false if the image can't be decoded, in which case the cache must be bypassed.
+	*/
+	static bool computeKey(const string& filepath, const string& objClass, const ShapeRepresentationParams& params, HashKey& key);
+
+	/*!
+	*	\fn static bool lookup(HashKey key, unsigned long& graphKey);
+	*	\brief Returns true and the graph's DB key if this content has already been signed. Counts the hit/miss.
+	*/
+	static bool lookup(HashKey key, unsigned long& graphKey);
+	static void insert(HashKey key, unsigned long graphKey);
+
+	static unsigned long long getHits();
+	static unsigned long long getMisses();
+
+private:
+	/*!
+	*	Mutex in order to prevent multiple access to critical sections.
+	*/
+	static boost::mutex mutexCache;
+
+	static bool bOpen;
+	static std::unordered_map<HashKey, unsigned long> index;
+	static ofstream indexFile;
+	static unsigned long long hits, misses;
+
+	static HashKey hashBytes(const void* data, size_t size, HashKey seed);
+};
+
+#endif // _SIGNATURE_CACHE_
@@ -66,6 +66,8 @@
 #include <io.h>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <set>
 #include <list>
 #include <vector>
 #include <stdexcept>
@@ -76,6 +78,8 @@
 #include <memory>
 #include <random>
 #include <stack>
+#include <deque>
+#include <algorithm>
 #include <functional>
 #include <boost/shared_ptr.hpp>
 #include <boost/lexical_cast.hpp>
@@ -84,6 +88,8 @@
 #include <boost/smart_ptr.hpp>
 #include <boost/threadpool.hpp>
 #include <boost/thread.hpp>
+#include <boost/asio.hpp> // Before WinHttpClient.h : winsock2 must come before windows.h
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
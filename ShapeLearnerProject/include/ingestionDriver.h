@@ -0,0 +1,103 @@
+/* ************* Begin file ingestionDriver.h ***************************************/
+/*
+** 2015 September 21
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file ingestionDriver.h
+*	\brief ingestionDriver Header
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _INGESTION_DRIVER_
+#define _INGESTION_DRIVER_
+
+#ifdef _MSC_VER
+	#pragma message("Compiling ShapeLearnerLib::ingestionDriver.h  - this should happen just once per project.\n")
+#endif
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <stack>
+#include <set>
+#include <boost/utility.hpp>
+#include <boost/shared_ptr.hpp>
+
+using namespace std;
+
+class StandardExcept; //Forward Declaration of the class contained in StandardException.h
+class DirWalker; //Forward Declaration of the class contained in DirWalker.h
+
+struct ImageEntry{
+	string filepath;
+	string objClass;
+	unsigned int jobID;
+	ImageEntry();
+};
+
+class ImageSource : boost::noncopyable {
+public:
+	virtual ~ImageSource() {}
+	virtual bool next(ImageEntry& entry) = 0;
+};
+
+class DirectorySource : public ImageSource {
+public:
+	DirectorySource(const string& _rootDir) throw(StandardExcept);
+	virtual bool next(ImageEntry& entry);
+	static bool isImageFile(const char* szFileName);
+private:
+	struct DirListing{
+		vector<string> entries;
+		size_t nextEntry;
+		DirListing();
+	};
+	stack<DirListing> dirStack;
+	static bool listDir(const string& dirPath, DirListing& listing);
+};
+
+class ManifestSource : public ImageSource {
+public:
+	ManifestSource(const string& _manifestPath) throw(StandardExcept);
+	virtual bool next(ImageEntry& entry);
+private:
+	ifstream manifest;
+	unsigned long lineNumber;
+};
+
+class IngestionDriver : boost::noncopyable {
+public:
+	IngestionDriver(ImageSource& _source, const string& _objClass, const unsigned int _baseJobID,
+						const unsigned int _maxInFlight = 180, const string& _checkpointPath = "",
+						const unsigned int _checkpointEvery = 100);
+
+	unsigned long run() throw(StandardExcept);
+	unsigned long getSucceeded() const;
+	unsigned long getFailed() const;
+
+private:
+	ImageSource& source;
+	const string objClass;
+	const unsigned int baseJobID;
+	const unsigned int maxInFlight;
+	const string checkpointPath;
+	const unsigned int checkpointEvery;
+	unsigned long succeeded, failed;
+	unsigned long long watermark;
+	set<unsigned long long> finishedAhead;
+
+	unsigned long long readCheckpoint() const;
+	void writeCheckpoint() const;
+	void markFinished(unsigned long long position);
+};
+
+#endif // _INGESTION_DRIVER_
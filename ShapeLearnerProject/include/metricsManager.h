@@ -0,0 +1,40 @@
+/* ************* Begin file metricsManager.h ***************************************/
+/*
+** 2015 September 14
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file metricsManager.h
+*	\brief metricsManager Header
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _METRICS_MANAGER_
+#define _METRICS_MANAGER_
+
+#ifdef _MSC_VER
+	#pragma message("Compiling ShapeLearnerLib::metricsManager.h  - this should happen just once per project.\n")
+#endif
+
+#include <iostream>
+#include <string>
+#include <boost/utility.hpp>
+
+using namespace std;
+
+class MetricsManager : boost::noncopyable {
+public:
+	static std::string render();
+	static bool startServer(unsigned short port = 9464);
+	static void stopServer();
+};
+
+#endif // _METRICS_MANAGER_
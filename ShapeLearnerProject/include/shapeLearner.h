@@ -27,6 +27,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <boost/thread/future.hpp>
 
 using namespace std;
 
@@ -37,6 +38,26 @@ struct img2Parse{
    img2Parse(const string _filepath, const string _objClass, const unsigned int _jobID);
 };
 
+struct ShockGraphSweep
+{
+	std::vector<double> minSlopes, minErrors, maxAccelChgs;
+};
+
+struct JobResult{
+   unsigned int jobID;
+   string filepath;
+   bool success;
+   unsigned long graphID;
+   double queueTime;
+   double generationTime;
+   double savingTime;
+   double totalTime;
+   vector<unsigned long> sweepGraphIDs;
+   JobResult();
+};
+
+typedef boost::shared_future<JobResult> JobHandle;
+
 class StandardExcept; //Forward Declaration of the class contained in StandardException.h
 
 /*!
@@ -49,9 +70,20 @@ class ShapeLearner
 {
    public:
       static unsigned int getActiveThread () throw(StandardExcept);
+      static unsigned int getPendingJobs () throw(StandardExcept);
       static void createShockGraph (const vector<const img2Parse> &imgVect) throw(StandardExcept);
       static void createShockGraph (const img2Parse &imgVect) throw(StandardExcept);
       static void waitForComputation () throw(StandardExcept);
+      static vector<JobHandle> submitShockGraphs (const vector<const img2Parse> &imgVect) throw(StandardExcept);
+      static JobHandle submitShockGraph (const img2Parse &img) throw(StandardExcept);
+
+      /*!
+      *	\brief Schedules one parameter sweep per image : the skeleton is computed once and one shock graph is saved per combination of the sweep values.
+      *	The handle of each image reports every saved graph in JobResult::sweepGraphIDs.
+      */
+      static vector<JobHandle> submitParameterSweep (const vector<const img2Parse> &imgVect, const ShockGraphSweep &sweep) throw(StandardExcept);
+      static size_t waitAny (vector<JobHandle> &handles) throw(StandardExcept);
+      static void waitAll (vector<JobHandle> &handles) throw(StandardExcept);
 };
 
 #endif //_SHAPE_LEARNER_H_
@@ -36,6 +36,16 @@ __declspec(dllexport) void signBinaryImage(char* _imgPath, char* _imgClass, unsi
 
 __declspec(dllexport) unsigned int getActiveThread() ;
 
+__declspec(dllexport) bool openSignatureCache(char* _indexPath) ;
+
+__declspec(dllexport) unsigned long ingestDirectory(char* _rootDir, char* _imgClass, unsigned int _baseJobID, unsigned int _maxInFlight, char* _checkpointPath = "") ;
+
+__declspec(dllexport) unsigned long ingestManifest(char* _manifestPath, char* _imgClass, unsigned int _baseJobID, unsigned int _maxInFlight, char* _checkpointPath = "") ;
+
+__declspec(dllexport) bool startMetricsServer(unsigned int _port = 9464) ;
+
+__declspec(dllexport) void stopMetricsServer() ;
+
 __declspec(dllexport) void waitBeforeClosing() ;
 
 #ifdef __cplusplus
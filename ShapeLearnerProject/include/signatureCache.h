@@ -0,0 +1,44 @@
+/* ************* Begin file signatureCache.h ***************************************/
+/*
+** 2015 September 28
+**
+** In place of a legal notice, here is a blessing:
+**
+**    May you do good and not evil.
+**    May you find forgiveness for yourself and forgive others.
+**    May you share freely, never taking more than you give.
+**
+*************************************************************************/
+
+/**
+*	\file signatureCache.h
+*	\brief signatureCache Header
+*	\version 1.0
+*	\author Jonathan DEKHTIAR - contact@jonathandekhtiar.eu - @born2data - http://www.jonathandekhtiar.eu
+*/
+
+#ifndef _SIGNATURE_CACHE_
+#define _SIGNATURE_CACHE_
+
+#ifdef _MSC_VER
+	#pragma message("Compiling ShapeLearnerLib::signatureCache.h  - this should happen just once per project.\n")
+#endif
+
+#include <iostream>
+#include <string>
+#include <boost/utility.hpp>
+
+using namespace std;
+
+class StandardExcept; //Forward Declaration of the class contained in StandardException.h
+
+class SignatureCache : boost::noncopyable {
+public:
+	static void open(const string& indexPath) throw(StandardExcept);
+	static void close();
+	static bool isOpen();
+	static unsigned long long getHits();
+	static unsigned long long getMisses();
+};
+
+#endif // _SIGNATURE_CACHE_